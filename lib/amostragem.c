@@ -0,0 +1,80 @@
+#include "amostragem.h"
+
+void amostragem_init(amostragem_t *a, alarm_pool_t *pool, amostragem_disparo_fn disparar, void *dados,
+                     uint32_t periodo_min_ms, uint32_t periodo_max_ms) {
+    a->pool = pool;
+    a->alarme = 0;
+    a->disparar = disparar;
+    a->dados = dados;
+    a->periodo_min_us = periodo_min_ms * 1000;
+    a->periodo_max_us = periodo_max_ms * 1000;
+    a->periodo_us = a->periodo_min_us; // Começa rápido até conhecer a cena
+    a->limiar_atividade_cm = 3.0f;
+    a->repouso_ms = 3000;
+    a->referencia_cm = 0.0f;
+    a->ultima_atividade_ms = to_ms_since_boot(get_absolute_time());
+    a->disparos = 0;
+    a->ocupado_us = 0;
+    a->inicio_janela_us = time_us_64();
+}
+
+// Alarme de hardware: dispara o sensor e define o próximo período
+static int64_t amostragem_alarme_cb(__unused alarm_id_t id, void *dados) {
+    amostragem_t *a = (amostragem_t *)dados;
+
+    if (a->disparar(a->dados)) {
+        a->disparos++;
+    }
+
+    // Sem atividade há algum tempo: dobra o período a cada disparo até a taxa de repouso
+    uint32_t agora_ms = to_ms_since_boot(get_absolute_time());
+    if (agora_ms - a->ultima_atividade_ms > a->repouso_ms && a->periodo_us < a->periodo_max_us) {
+        uint32_t periodo = a->periodo_us * 2;
+        a->periodo_us = periodo > a->periodo_max_us ? a->periodo_max_us : periodo;
+    }
+
+    // Negativo: reagenda a partir do instante programado, sem acumular atraso
+    return -(int64_t)a->periodo_us;
+}
+
+bool amostragem_iniciar(amostragem_t *a) {
+    a->alarme = alarm_pool_add_alarm_in_us(a->pool, a->periodo_us, amostragem_alarme_cb, a, true);
+    return a->alarme > 0;
+}
+
+// Informa uma nova distância filtrada; movimento leva à taxa máxima imediatamente
+void amostragem_observar(amostragem_t *a, float distancia_cm, uint32_t instante_ms) {
+    float variacao = distancia_cm - a->referencia_cm;
+    if (variacao < 0) variacao = -variacao;
+    if (variacao < a->limiar_atividade_cm) return;
+
+    a->referencia_cm = distancia_cm;
+    a->ultima_atividade_ms = instante_ms;
+
+    if (a->periodo_us > a->periodo_min_us) {
+        a->periodo_us = a->periodo_min_us;
+        // Antecipa o próximo disparo; se o alarme já estiver executando, ele usa o novo período
+        if (alarm_pool_cancel_alarm(a->pool, a->alarme)) {
+            a->alarme = alarm_pool_add_alarm_in_us(a->pool, a->periodo_us, amostragem_alarme_cb, a, true);
+        }
+    }
+}
+
+// Soma o tempo em que o sensor ficou ocupado com uma medição
+void amostragem_registrar_medicao(amostragem_t *a, uint32_t duracao_us) {
+    a->ocupado_us += duracao_us;
+}
+
+// Taxa de disparo e fração de tempo com o sensor medindo desde o último relatório
+void amostragem_relatorio(amostragem_t *a, float *taxa_hz, float *duty) {
+    uint64_t agora = time_us_64();
+    uint64_t janela = agora - a->inicio_janela_us;
+    if (janela == 0) janela = 1;
+
+    *taxa_hz = a->disparos * 1e6f / janela;
+    *duty = (float)a->ocupado_us / janela;
+
+    a->disparos = 0;
+    a->ocupado_us = 0;
+    a->inicio_janela_us = agora;
+}
@@ -0,0 +1,38 @@
+#ifndef AMOSTRAGEM_H
+#define AMOSTRAGEM_H
+
+#include "pico/stdlib.h"
+
+// Função chamada pelo alarme de hardware a cada disparo
+typedef bool (*amostragem_disparo_fn)(void *dados);
+
+// Escalonador de amostragem adaptativo: rápido com movimento, lento com a cena parada
+typedef struct {
+    alarm_pool_t *pool;
+    alarm_id_t alarme;
+    amostragem_disparo_fn disparar;
+    void *dados;
+
+    uint32_t periodo_min_us;       // Taxa máxima segura do sensor
+    uint32_t periodo_max_us;       // Taxa de repouso
+    volatile uint32_t periodo_us;  // Período atual
+
+    float limiar_atividade_cm;     // Variação de distância que conta como atividade
+    uint32_t repouso_ms;           // Tempo sem atividade até começar a desacelerar
+    float referencia_cm;
+    volatile uint32_t ultima_atividade_ms;
+
+    // Acumuladores da janela de relatório
+    volatile uint32_t disparos;
+    uint64_t ocupado_us;           // Tempo com o sensor medindo (eco ou timeout)
+    uint64_t inicio_janela_us;
+} amostragem_t;
+
+void amostragem_init(amostragem_t *a, alarm_pool_t *pool, amostragem_disparo_fn disparar, void *dados,
+                     uint32_t periodo_min_ms, uint32_t periodo_max_ms);
+bool amostragem_iniciar(amostragem_t *a);
+void amostragem_observar(amostragem_t *a, float distancia_cm, uint32_t instante_ms);
+void amostragem_registrar_medicao(amostragem_t *a, uint32_t duracao_us);
+void amostragem_relatorio(amostragem_t *a, float *taxa_hz, float *duty);
+
+#endif
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include "boot.h"
+#include "hardware/sync.h"
+
+// As dependências só podem apontar para etapas anteriores na tabela: a ordem da tabela é uma
+// ordem topológica, e nenhuma espera fica presa num ciclo
+bool boot_init(boot_t *b, boot_etapa_t *etapas, uint8_t num) {
+    if (num > BOOT_ETAPAS_MAX) return false;
+    for (uint8_t i = 0; i < num; i++) {
+        if (etapas[i].dependencias >> i) return false;
+        etapas[i].iniciada = etapas[i].concluida = false;
+        etapas[i].inicio_ms = etapas[i].fim_ms = 0;
+    }
+    b->etapas = etapas;
+    b->num = num;
+    return true;
+}
+
+// Espera as dependências (o núcleo dorme até o __sev() de boot_fim) e marca o início
+void boot_etapa(boot_t *b, uint8_t etapa) {
+    uint32_t dependencias = b->etapas[etapa].dependencias;
+    for (uint8_t i = 0; dependencias; i++, dependencias >>= 1) {
+        while ((dependencias & 1) && !b->etapas[i].concluida) {
+            __wfe();
+        }
+    }
+    boot_inicio(b, etapa);
+}
+
+// Marca o início sem esperar, para etapas conduzidas por callbacks; só a primeira vez conta
+void boot_inicio(boot_t *b, uint8_t etapa) {
+    boot_etapa_t *e = &b->etapas[etapa];
+    if (e->iniciada) return;
+    e->inicio_ms = to_ms_since_boot(get_absolute_time());
+    e->nucleo = get_core_num();
+    e->iniciada = true;
+}
+
+void boot_fim(boot_t *b, uint8_t etapa) {
+    boot_etapa_t *e = &b->etapas[etapa];
+    if (e->concluida) return;
+    if (!e->iniciada) boot_inicio(b, etapa);
+    e->fim_ms = to_ms_since_boot(get_absolute_time());
+    __dmb(); // fim_ms visível antes de concluida para o outro núcleo
+    e->concluida = true;
+    __sev();
+}
+
+// "etapa:núcleo,início_ms,fim_ms;" para cada etapa concluída, na ordem da tabela
+int boot_formatar(const boot_t *b, char *buf, size_t tamanho) {
+    size_t n = 0;
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < b->num; i++) {
+        const boot_etapa_t *e = &b->etapas[i];
+        if (!e->concluida) continue;
+        int escrito = snprintf(&buf[n], tamanho - n, "%s:%u,%u,%u;", e->nome, e->nucleo,
+                               (unsigned)e->inicio_ms, (unsigned)e->fim_ms);
+        if (escrito < 0 || (size_t)escrito >= tamanho - n) {
+            buf[n] = '\0';
+            break;
+        }
+        n += escrito;
+    }
+    return (int)n;
+}
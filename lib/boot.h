@@ -0,0 +1,39 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "pico/stdlib.h"
+
+#define BOOT_ETAPAS_MAX 32
+#define BOOT_DEP(etapa) (1u << (etapa))
+
+// Etapa da inicialização: quem executa, de quais etapas depende e quando começou e terminou.
+// Cada etapa é marcada por um único núcleo; as dependências podem estar no outro.
+typedef struct {
+    const char *nome;
+    uint32_t dependencias;      // Máscara BOOT_DEP() de etapas que terminam antes desta começar
+    uint8_t nucleo;
+    volatile bool iniciada, concluida;
+    volatile uint32_t inicio_ms, fim_ms;
+} boot_etapa_t;
+
+typedef struct {
+    boot_etapa_t *etapas;
+    uint8_t num;
+} boot_t;
+
+bool boot_init(boot_t *b, boot_etapa_t *etapas, uint8_t num);
+void boot_etapa(boot_t *b, uint8_t etapa);
+void boot_inicio(boot_t *b, uint8_t etapa);
+void boot_fim(boot_t *b, uint8_t etapa);
+int boot_formatar(const boot_t *b, char *buf, size_t tamanho);
+
+static inline bool boot_concluida(const boot_t *b, uint8_t etapa) {
+    return b->etapas[etapa].concluida;
+}
+
+// Duração de uma etapa concluída, em ms
+static inline uint32_t boot_duracao_ms(const boot_t *b, uint8_t etapa) {
+    return b->etapas[etapa].fim_ms - b->etapas[etapa].inicio_ms;
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "buzzer.h"
 #include "pico/stdlib.h"
+#include "hardware/sync.h"
 
 
 // VARIÁVEIS GLOBAIS
@@ -97,40 +98,202 @@ void buzzer_pwm_off(uint gpio) {
 }
 
 // SONS
+// Todas as funções retornam imediatamente: as notas são tocadas pelo sequenciador
+
+#define NUM_NOTAS(v) (sizeof(v) / sizeof((v)[0]))
+
+static const buzzer_nota_t NOTAS_INICIALIZACAO[] = {
+    { 600, 50, 100 }, { 0, 0, 100 }, { 900, 50, 100 }, { 0, 0, 100 }, { 1200, 50, 100 }, { 0, 0, 100 },
+};
+static const buzzer_nota_t NOTAS_ABERTURA[] = {
+    { 800, 50, 90 }, { 0, 0, 30 }, { 1000, 50, 90 }, { 0, 0, 30 },
+};
+static const buzzer_nota_t NOTAS_FECHAMENTO[] = {
+    { 500, 50, 150 },
+};
+static const buzzer_nota_t NOTAS_ALARME_PRESENCA[] = {
+    { 1200, 30, 20 }, { 0, 0, 20 }, { 800, 30, 20 }, { 0, 0, 20 },
+};
+
+const buzzer_som_t SOM_INICIALIZACAO = { NOTAS_INICIALIZACAO, NUM_NOTAS(NOTAS_INICIALIZACAO), false };
+const buzzer_som_t SOM_ABERTURA = { NOTAS_ABERTURA, NUM_NOTAS(NOTAS_ABERTURA), false };
+const buzzer_som_t SOM_FECHAMENTO = { NOTAS_FECHAMENTO, NUM_NOTAS(NOTAS_FECHAMENTO), false };
+const buzzer_som_t SOM_ALARME_PRESENCA = { NOTAS_ALARME_PRESENCA, NUM_NOTAS(NOTAS_ALARME_PRESENCA), true };
 
 void somInicializacao(uint gpio) {
-    float frequencias[] = {600.0f, 900.0f, 1200.0f};
-    for (int i = 0; i < 3; i++) {
-        buzzer_pwm_on(frequencias[i], 0.5f, gpio);
-        sleep_ms(100);
-        buzzer_pwm_off(gpio);
-        sleep_ms(100);
-    }
+    buzzer_tocar(gpio, &SOM_INICIALIZACAO, BUZZER_PRIORIDADE_AVISO);
 }
 
 void somAberturaPortao(uint gpio) {
-    float frequencias[] = {800.0f, 1000.0f};
-    for (int i = 0; i < 2; i++) {
-        buzzer_pwm_on(frequencias[i], 0.5f, gpio);
-        sleep_ms(90);
-        buzzer_pwm_off(gpio);
-        sleep_ms(30);
-    }
+    buzzer_tocar(gpio, &SOM_ABERTURA, BUZZER_PRIORIDADE_AVISO);
 }
 
 void somFechamentoPortao(uint gpio) {
-    buzzer_pwm_on(500.0f, 0.5f, gpio);
-    sleep_ms(150);
-    buzzer_pwm_off(gpio);
+    buzzer_tocar(gpio, &SOM_FECHAMENTO, BUZZER_PRIORIDADE_AVISO);
 }
 
+// Toca até pararAlarmePresenca; chamar de novo com o alarme tocando não faz nada
 void alarmePresencaPWM(uint gpio) {
-    float frequencias[] = {1200.0f, 800.0f};
-    for (int i = 0; i < 6; i++) {
-        buzzer_pwm_on(frequencias[i % 2], 0.3f, gpio); // 30% duty
-        sleep_ms(20);
-        buzzer_pwm_off(gpio);
-        sleep_ms(20);
+    buzzer_tocar(gpio, &SOM_ALARME_PRESENCA, BUZZER_PRIORIDADE_ALARME);
+}
+
+void pararAlarmePresenca(uint gpio) {
+    buzzer_cancelar(gpio, &SOM_ALARME_PRESENCA);
+}
+
+// ============================================================================
+//                         SEQUENCIADOR DE SONS
+// ============================================================================
+
+// Som na fila de um buzzer
+typedef struct {
+    const buzzer_som_t *som;
+    buzzer_prioridade_t prioridade;
+} buzzer_pedido_t;
+
+// Estado de cada buzzer; alterado pelo alarme e pelas chamadas com as interrupções desligadas
+typedef struct {
+    uint gpio;
+    bool usado;
+    buzzer_pedido_t atual;             // atual.som == NULL: em silêncio
+    uint8_t passo;
+    alarm_id_t alarme;
+    buzzer_pedido_t fila[BUZZER_FILA_TAM]; // Ordenada por prioridade, FIFO entre iguais
+    uint8_t na_fila;
+} buzzer_canal_t;
+
+static alarm_pool_t *pool_sons;
+static buzzer_canal_t canais[BUZZER_CANAIS];
+
+// Deve ser chamada no núcleo que toca os sons: os alarmes interrompem esse núcleo
+void init_sequenciador_buzzer(alarm_pool_t *pool) {
+    pool_sons = pool;
+}
+
+static buzzer_canal_t *buzzer_canal(uint gpio) {
+    for (int i = 0; i < BUZZER_CANAIS; i++) {
+        if (canais[i].usado && canais[i].gpio == gpio) return &canais[i];
+    }
+    for (int i = 0; i < BUZZER_CANAIS; i++) {
+        if (!canais[i].usado) {
+            canais[i].usado = true;
+            canais[i].gpio = gpio;
+            return &canais[i];
+        }
     }
+    return NULL;
 }
 
+// Insere mantendo a ordem de prioridade; na_frente coloca antes dos de mesma prioridade
+static bool buzzer_enfileirar(buzzer_canal_t *c, buzzer_pedido_t pedido, bool na_frente) {
+    if (c->na_fila >= BUZZER_FILA_TAM) return false;
+    uint8_t i = c->na_fila;
+    while (i > 0 && (c->fila[i - 1].prioridade < pedido.prioridade ||
+                     (na_frente && c->fila[i - 1].prioridade == pedido.prioridade))) {
+        c->fila[i] = c->fila[i - 1];
+        i--;
+    }
+    c->fila[i] = pedido;
+    c->na_fila++;
+    return true;
+}
+
+// Tira o primeiro da fila para tocar; false se a fila estiver vazia
+static bool buzzer_proximo(buzzer_canal_t *c) {
+    if (!c->na_fila) {
+        c->atual.som = NULL;
+        return false;
+    }
+    c->atual = c->fila[0];
+    c->na_fila--;
+    for (uint8_t i = 0; i < c->na_fila; i++) c->fila[i] = c->fila[i + 1];
+    c->passo = 0;
+    return true;
+}
+
+// Toca a etapa atual e devolve o tempo até a próxima (0 = terminou)
+static uint32_t buzzer_etapa(buzzer_canal_t *c) {
+    while (c->atual.som) {
+        if (c->passo >= c->atual.som->num) {
+            if (c->atual.som->repetir) {
+                c->passo = 0;
+            } else if (!buzzer_proximo(c)) {
+                break;
+            }
+        }
+        const buzzer_nota_t *nota = &c->atual.som->notas[c->passo++];
+        if (nota->freq_hz) {
+            buzzer_pwm_on(nota->freq_hz, nota->duty_pct / 100.0f, c->gpio);
+        } else {
+            buzzer_pwm_off(c->gpio); // Pausa
+        }
+        return nota->duracao_ms * 1000u;
+    }
+    buzzer_pwm_off(c->gpio);
+    return 0;
+}
+
+// Alarme de hardware: avança uma etapa e reagenda pelo tempo da nota
+static int64_t buzzer_alarme_cb(__unused alarm_id_t id, void *dados) {
+    buzzer_canal_t *c = (buzzer_canal_t *)dados;
+    uint32_t espera_us = buzzer_etapa(c);
+    if (!espera_us) c->alarme = 0;
+    return -(int64_t)espera_us; // Negativo: conta a partir do instante programado, sem acumular atraso
+}
+
+// Começa a tocar o som atual do canal a partir da primeira etapa
+static void buzzer_iniciar(buzzer_canal_t *c) {
+    if (c->alarme) alarm_pool_cancel_alarm(pool_sons, c->alarme);
+    c->passo = 0;
+    uint32_t espera_us = buzzer_etapa(c);
+    c->alarme = espera_us ? alarm_pool_add_alarm_in_us(pool_sons, espera_us, buzzer_alarme_cb, c, true) : 0;
+}
+
+// Toca, enfileira ou ignora (se o mesmo som já estiver tocando); retorna imediatamente
+bool buzzer_tocar(uint gpio, const buzzer_som_t *som, buzzer_prioridade_t prioridade) {
+    buzzer_canal_t *c = buzzer_canal(gpio);
+    if (!c || !pool_sons) return false;
+
+    buzzer_pedido_t pedido = { som, prioridade };
+    bool ok = true;
+    uint32_t status = save_and_disable_interrupts();
+    if (c->atual.som == som) {
+        // Já está tocando
+    } else if (!c->atual.som) {
+        c->atual = pedido;
+        buzzer_iniciar(c);
+    } else if (prioridade > c->atual.prioridade) {
+        // Interrompe: o som atual volta ao início da fila e recomeça depois
+        buzzer_enfileirar(c, c->atual, true);
+        c->atual = pedido;
+        buzzer_iniciar(c);
+    } else {
+        ok = buzzer_enfileirar(c, pedido, false);
+    }
+    restore_interrupts(status);
+    return ok;
+}
+
+// Cancela um som tocando ou na fila; som NULL cancela tudo no buzzer
+void buzzer_cancelar(uint gpio, const buzzer_som_t *som) {
+    buzzer_canal_t *c = buzzer_canal(gpio);
+    if (!c) return;
+
+    uint32_t status = save_and_disable_interrupts();
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < c->na_fila; i++) {
+        if (som && c->fila[i].som != som) c->fila[n++] = c->fila[i];
+    }
+    c->na_fila = n;
+
+    if (c->atual.som && (!som || c->atual.som == som)) {
+        if (buzzer_proximo(c)) {
+            buzzer_iniciar(c);
+        } else {
+            if (c->alarme) alarm_pool_cancel_alarm(pool_sons, c->alarme);
+            c->alarme = 0;
+            buzzer_pwm_off(c->gpio);
+        }
+    }
+    restore_interrupts(status);
+}
@@ -1,3 +1,6 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
 #include "pico/stdlib.h"
 #include "hardware/pwm.h"
 
@@ -20,6 +23,42 @@ void somInicializacao(uint gpio);
 void somAberturaPortao(uint gpio);
 void somFechamentoPortao(uint gpio);
 void alarmePresencaPWM(uint gpio);
+void pararAlarmePresenca(uint gpio);
+
+// ============================================================================
+//                         SEQUENCIADOR DE SONS
+// ============================================================================
+
+#define BUZZER_CANAIS 2   // Buzzers tocando ao mesmo tempo
+#define BUZZER_FILA_TAM 4 // Sons esperando em cada buzzer
+
+// Etapa de um som: frequência 0 é uma pausa
+typedef struct {
+    uint16_t freq_hz;
+    uint8_t duty_pct;
+    uint16_t duracao_ms;
+} buzzer_nota_t;
+
+// Som completo; os repetidos tocam até serem cancelados
+typedef struct {
+    const buzzer_nota_t *notas;
+    uint8_t num;
+    bool repetir;
+} buzzer_som_t;
+
+// Prioridade maior interrompe o som atual, que volta para a fila
+typedef enum {
+    BUZZER_PRIORIDADE_AVISO,
+    BUZZER_PRIORIDADE_ALARME
+} buzzer_prioridade_t;
 
+extern const buzzer_som_t SOM_INICIALIZACAO;
+extern const buzzer_som_t SOM_ABERTURA;
+extern const buzzer_som_t SOM_FECHAMENTO;
+extern const buzzer_som_t SOM_ALARME_PRESENCA;
 
+void init_sequenciador_buzzer(alarm_pool_t *pool);
+bool buzzer_tocar(uint gpio, const buzzer_som_t *som, buzzer_prioridade_t prioridade);
+void buzzer_cancelar(uint gpio, const buzzer_som_t *som);
 
+#endif
@@ -0,0 +1,93 @@
+#include <string.h>
+#include "cache_boot.h"
+#include "pico/flash.h"
+
+_Static_assert(sizeof(cache_boot_t) == 32, "registro deve dividir a página de flash");
+
+static uint32_t fnv1a(uint32_t h, const void *dados, size_t n) {
+    const uint8_t *p = (const uint8_t *)dados;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t cache_boot_verificacao(const cache_boot_t *c) {
+    return fnv1a(2166136261u, c, offsetof(cache_boot_t, verificacao));
+}
+
+static bool cache_boot_valido(const cache_boot_t *c) {
+    return c->marca == CACHE_BOOT_MARCA && c->verificacao == cache_boot_verificacao(c);
+}
+
+// Uma SSID ou um broker diferente invalida o que foi gravado
+uint32_t cache_boot_chave(const char *ssid, const char *servidor) {
+    uint32_t h = fnv1a(2166136261u, ssid, strlen(ssid) + 1);
+    return fnv1a(h, servidor, strlen(servidor));
+}
+
+static const cache_boot_t *cache_boot_registros(uint32_t offset) {
+    return (const cache_boot_t *)(uintptr_t)(XIP_BASE + offset);
+}
+
+// Índice do último registro gravado, ou -1 com o setor vazio
+static int cache_boot_ultimo(uint32_t offset) {
+    const cache_boot_t *r = cache_boot_registros(offset);
+    int ultimo = -1;
+    for (uint i = 0; i < CACHE_BOOT_REGISTROS && r[i].marca != 0xFFFFFFFF; i++) {
+        ultimo = i;
+    }
+    return ultimo;
+}
+
+bool cache_boot_ler(uint32_t offset, uint32_t chave, cache_boot_t *c) {
+    int ultimo = cache_boot_ultimo(offset);
+    if (ultimo < 0) return false;
+
+    *c = cache_boot_registros(offset)[ultimo];
+    return cache_boot_valido(c) && c->chave == chave;
+}
+
+typedef struct {
+    uint32_t offset;
+    bool apagar;
+    const uint8_t *pagina;
+} cache_boot_gravacao_t;
+
+// Executa com o outro núcleo parado e as interrupções desligadas (flash_safe_execute)
+static void cache_boot_gravar_pagina(void *param) {
+    const cache_boot_gravacao_t *g = (const cache_boot_gravacao_t *)param;
+    if (g->apagar) {
+        flash_range_erase(g->offset & ~(FLASH_SECTOR_SIZE - 1), FLASH_SECTOR_SIZE);
+    }
+    flash_range_program(g->offset, g->pagina, FLASH_PAGE_SIZE);
+}
+
+// Acrescenta o registro se ele for diferente do último; preenche marca e verificação
+bool cache_boot_gravar(uint32_t offset, cache_boot_t *c) {
+    c->marca = CACHE_BOOT_MARCA;
+    memset(c->reservado, 0xFF, sizeof(c->reservado));
+    c->verificacao = cache_boot_verificacao(c);
+
+    int ultimo = cache_boot_ultimo(offset);
+    const cache_boot_t *anterior = ultimo >= 0 ? &cache_boot_registros(offset)[ultimo] : NULL;
+    if (anterior && memcmp(anterior, c, sizeof(*c)) == 0) return true;
+
+    // Bytes 0xFF não alteram a flash: a página leva só o registro novo na sua posição.
+    // Setor cheio ou com lixo (de um binário antigo, por exemplo) é apagado antes.
+    uint posicao = ultimo + 1;
+    bool apagar = posicao == CACHE_BOOT_REGISTROS || (anterior && !cache_boot_valido(anterior));
+    if (apagar) posicao = 0;
+    uint8_t pagina[FLASH_PAGE_SIZE];
+    memset(pagina, 0xFF, sizeof(pagina));
+    uint32_t byte = posicao * sizeof(cache_boot_t);
+    memcpy(&pagina[byte % FLASH_PAGE_SIZE], c, sizeof(*c));
+
+    cache_boot_gravacao_t g = {
+        .offset = offset + byte - byte % FLASH_PAGE_SIZE,
+        .apagar = apagar,
+        .pagina = pagina,
+    };
+    return flash_safe_execute(cache_boot_gravar_pagina, &g, 100) == PICO_OK;
+}
@@ -0,0 +1,27 @@
+#ifndef CACHE_BOOT_H
+#define CACHE_BOOT_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+#define CACHE_BOOT_MARCA 0x43425347 // "GSBC"
+#define CACHE_BOOT_REGISTROS (FLASH_SECTOR_SIZE / sizeof(cache_boot_t))
+
+// Última associação e endereço do broker que funcionaram, para o próximo boot pular a varredura
+// do Wi-Fi e o DNS. Os registros são acrescentados em sequência num setor da flash, que só é
+// apagado quando enche; vale o último com verificação correta.
+typedef struct {
+    uint32_t marca;          // 0xFFFFFFFF: posição livre
+    uint32_t chave;          // cache_boot_chave da rede e do broker que o gravaram
+    uint32_t broker_ip;      // IPv4, como em ip_addr_get_ip4_u32
+    uint8_t bssid[6];
+    uint8_t canal;
+    uint8_t reservado[9];
+    uint32_t verificacao;    // FNV-1a dos campos anteriores
+} cache_boot_t;
+
+uint32_t cache_boot_chave(const char *ssid, const char *servidor);
+bool cache_boot_ler(uint32_t offset, uint32_t chave, cache_boot_t *c);
+bool cache_boot_gravar(uint32_t offset, cache_boot_t *c);
+
+#endif
@@ -0,0 +1,37 @@
+#include "canal.h"
+#include "hardware/sync.h"
+
+void canal_init(canal_t *c) {
+    c->cabeca = 0;
+    c->cauda = 0;
+    c->descartados = 0;
+}
+
+// Produtor: grava o evento antes de publicar a nova cabeça e acorda o outro núcleo
+bool canal_enviar(canal_t *c, const evento_t *evento) {
+    uint32_t cabeca = c->cabeca;
+    if (cabeca - c->cauda >= CANAL_TAM) {
+        c->descartados++; // Consumidor atrasado: o evento é perdido, o produtor nunca espera
+        return false;
+    }
+    c->buffer[cabeca & (CANAL_TAM - 1)] = *evento;
+    __dmb();
+    c->cabeca = cabeca + 1;
+    __sev();
+    return true;
+}
+
+// Consumidor: lê o evento antes de liberar a posição para o produtor
+bool canal_receber(canal_t *c, evento_t *evento) {
+    uint32_t cauda = c->cauda;
+    if (cauda == c->cabeca) return false;
+    __dmb();
+    *evento = c->buffer[cauda & (CANAL_TAM - 1)];
+    __dmb();
+    c->cauda = cauda + 1;
+    return true;
+}
+
+uint32_t canal_ocupacao(const canal_t *c) {
+    return c->cabeca - c->cauda;
+}
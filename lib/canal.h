@@ -0,0 +1,44 @@
+#ifndef CANAL_H
+#define CANAL_H
+
+#include "pico/stdlib.h"
+
+// Capacidade de cada canal (potência de 2)
+#define CANAL_TAM 32
+
+// Tipos de evento trocados entre os núcleos
+typedef enum {
+    EVENTO_DISTANCIA,      // core1 -> core0: origem = sensor (CANAL_ORIGEM_FUSAO = mais próximo), valor[0] = cm
+    EVENTO_ESTADO,         // core1 -> core0: origem = novo estado da máquina de estados
+    EVENTO_PREVISAO,       // core1 -> core0: valor = {cm, cm/s, ms até o limiar}
+    EVENTO_AMOSTRAGEM,     // core1 -> core0: valor = {taxa em décimos de Hz, duty em milésimos}
+    EVENTO_CPU,            // core1 -> core0: valor = {utilização do core1 em milésimos, maior tempo de worker em us};
+                           // origem = worker mais lento
+    EVENTO_DISPLAY,        // core1 -> core0: valor = {bytes/s no I2C (sem sinal), quadros enviados, quadros iguais}
+    EVENTO_COMANDO_PORTAO  // core0 -> core1: origem = 1 abrir, 0 fechar
+} evento_tipo_t;
+
+#define CANAL_ORIGEM_FUSAO 0xFF
+
+// Evento de tamanho fixo (12 bytes)
+typedef struct {
+    uint8_t tipo;
+    uint8_t origem;
+    int16_t valor[3];
+    uint32_t instante_ms;
+} evento_t;
+
+// Fila sem trava de um produtor e um consumidor (cada lado em um núcleo)
+typedef struct {
+    evento_t buffer[CANAL_TAM];
+    volatile uint32_t cabeca; // Escrito só pelo produtor
+    volatile uint32_t cauda;  // Escrito só pelo consumidor
+    volatile uint32_t descartados;
+} canal_t;
+
+void canal_init(canal_t *c);
+bool canal_enviar(canal_t *c, const evento_t *evento);
+bool canal_receber(canal_t *c, evento_t *evento);
+uint32_t canal_ocupacao(const canal_t *c);
+
+#endif
@@ -0,0 +1,60 @@
+#include <string.h>
+#include "entrada.h"
+
+void entrada_init(entrada_t *e, uint8_t *buffer, uint16_t capacidade) {
+    e->buffer = buffer;
+    e->capacidade = capacidade;
+    e->id = ENTRADA_NENHUM;
+    e->descartar = true;
+    e->esperado = e->recebido = 0;
+    e->recebidas = e->remontadas = e->desconhecidas = e->grandes = e->truncadas = 0;
+}
+
+// Início de uma publicação: id do tratador (ENTRADA_NENHUM se não houver) e tamanho anunciado
+void entrada_comecar(entrada_t *e, uint8_t id, uint32_t tamanho_total) {
+    e->id = id;
+    e->esperado = tamanho_total;
+    e->recebido = 0;
+    e->descartar = false;
+    if (id == ENTRADA_NENHUM) {
+        e->descartar = true;
+        e->desconhecidas++;
+    } else if (tamanho_total > e->capacidade) {
+        e->descartar = true; // Só os fragmentos são recebidos e jogados fora; nada é alocado
+        e->grandes++;
+    }
+}
+
+// Entrega um fragmento. Retorna o payload completo no último fragmento de uma publicação
+// com tratador (e->id), ou NULL enquanto ela não terminar ou se foi descartada.
+const uint8_t *entrada_fragmento(entrada_t *e, const uint8_t *dados, uint16_t tamanho, bool ultimo,
+                                 uint16_t *tamanho_total) {
+    if (e->descartar) {
+        if (ultimo) e->id = ENTRADA_NENHUM;
+        return NULL;
+    }
+
+    // Publicação inteira num fragmento: aponta para o buffer do cliente
+    if (e->recebido == 0 && ultimo) {
+        e->descartar = true;
+        e->recebidas++;
+        *tamanho_total = tamanho;
+        return dados ? dados : (const uint8_t *)"";
+    }
+
+    if (e->recebido + tamanho > e->capacidade) {
+        e->descartar = true; // O cliente entregou mais do que anunciou
+        e->truncadas++;
+        if (ultimo) e->id = ENTRADA_NENHUM;
+        return NULL;
+    }
+    memcpy(&e->buffer[e->recebido], dados, tamanho);
+    e->recebido += tamanho;
+    if (!ultimo) return NULL;
+
+    e->descartar = true;
+    e->recebidas++;
+    e->remontadas++;
+    *tamanho_total = (uint16_t)e->recebido;
+    return e->buffer;
+}
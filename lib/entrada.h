@@ -0,0 +1,32 @@
+#ifndef ENTRADA_H
+#define ENTRADA_H
+
+#include "pico/stdlib.h"
+
+#define ENTRADA_NENHUM 0xFF     // Publicação sem tratador: os fragmentos são ignorados
+
+// Remontagem das publicações recebidas. O cliente MQTT entrega o payload em fragmentos do
+// tamanho do seu buffer de recepção; uma publicação que chega num único fragmento é tratada
+// direto no buffer do cliente, sem cópia. Só as maiores são copiadas, até a capacidade.
+typedef struct {
+    uint8_t *buffer;
+    uint16_t capacidade;
+    uint8_t id;                 // Tratador da publicação em curso
+    bool descartar;             // Publicação em curso sem tratador ou maior que a capacidade
+    uint32_t esperado;          // Tamanho total anunciado
+    uint32_t recebido;
+
+    // Contadores desde o boot
+    uint32_t recebidas;         // Publicações entregues a um tratador
+    uint32_t remontadas;        // Das entregues, as que vieram em mais de um fragmento
+    uint32_t desconhecidas;     // Tópico sem tratador
+    uint32_t grandes;           // Maiores que a capacidade
+    uint32_t truncadas;         // Fragmentos além do tamanho anunciado
+} entrada_t;
+
+void entrada_init(entrada_t *e, uint8_t *buffer, uint16_t capacidade);
+void entrada_comecar(entrada_t *e, uint8_t id, uint32_t tamanho_total);
+const uint8_t *entrada_fragmento(entrada_t *e, const uint8_t *dados, uint16_t tamanho, bool ultimo,
+                                 uint16_t *tamanho_total);
+
+#endif
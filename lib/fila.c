@@ -0,0 +1,148 @@
+#include <string.h>
+#include "fila.h"
+#include "pico/flash.h"
+
+_Static_assert(sizeof(fila_registro_t) == 32, "registro deve dividir a página de flash");
+
+// A área começa vazia a cada boot: a fila só cobre o período sem conexão
+void fila_init(fila_t *f, uint32_t flash_offset, uint16_t flash_setores) {
+    f->ram_inicio = f->ram_num = 0;
+    f->flash_offset = flash_offset;
+    f->flash_capacidade = flash_offset ? (uint32_t)flash_setores * FILA_REGISTROS_SETOR : 0;
+    f->flash_leitura = f->flash_escrita = 0;
+    f->em_voo = f->ignorar = 0;
+    f->descartados = 0;
+    f->drenagem_inicio_ms = f->drenagem_ms = 0;
+    f->drenando = false;
+}
+
+typedef struct {
+    uint32_t offset;
+    bool apagar;
+    const uint8_t *pagina;
+} fila_gravacao_t;
+
+// Executa com o outro núcleo parado e as interrupções desligadas (flash_safe_execute)
+static void fila_gravar(void *param) {
+    const fila_gravacao_t *g = (const fila_gravacao_t *)param;
+    if (g->apagar) {
+        flash_range_erase(g->offset & ~(FLASH_SECTOR_SIZE - 1), FLASH_SECTOR_SIZE);
+    }
+    flash_range_program(g->offset, g->pagina, FLASH_PAGE_SIZE);
+}
+
+// Desce a página mais antiga do anel em RAM para a flash. Retorna false se não foi possível.
+static bool fila_descer(fila_t *f) {
+    if (f->flash_capacidade == 0) return false;
+
+    uint32_t posicao = f->flash_escrita % f->flash_capacidade;
+    bool apagar = posicao % FILA_REGISTROS_SETOR == 0;
+    if (apagar && f->flash_escrita - f->flash_leitura > f->flash_capacidade - FILA_REGISTROS_SETOR) {
+        // O setor a apagar ainda tem registros não enviados: os mais antigos da fila
+        uint32_t novo_inicio = f->flash_escrita - f->flash_capacidade + FILA_REGISTROS_SETOR;
+        f->descartados += novo_inicio - f->flash_leitura;
+        f->flash_leitura = novo_inicio;
+        f->ignorar = f->em_voo; // Os enviados podem ter ido junto: o reenvio recomeça do início
+    }
+
+    fila_registro_t pagina[FILA_REGISTROS_PAGINA];
+    for (uint32_t i = 0; i < FILA_REGISTROS_PAGINA; i++) {
+        pagina[i] = f->ram[(f->ram_inicio + i) & (FILA_RAM_REGISTROS - 1)];
+    }
+    fila_gravacao_t g = {
+        .offset = f->flash_offset + posicao * sizeof(fila_registro_t),
+        .apagar = apagar,
+        .pagina = (const uint8_t *)pagina,
+    };
+    if (flash_safe_execute(fila_gravar, &g, 100) != PICO_OK) return false;
+
+    f->flash_escrita += FILA_REGISTROS_PAGINA;
+    f->ram_inicio = (f->ram_inicio + FILA_REGISTROS_PAGINA) & (FILA_RAM_REGISTROS - 1);
+    f->ram_num -= FILA_REGISTROS_PAGINA;
+    return true;
+}
+
+void fila_adicionar(fila_t *f, uint8_t topico, uint32_t instante_ms, const void *payload, uint8_t tamanho) {
+    if (f->ram_num == FILA_RAM_REGISTROS && !fila_descer(f)) {
+        // Sem flash: o registro mais antigo da RAM dá lugar ao novo
+        f->ram_inicio = (f->ram_inicio + 1) & (FILA_RAM_REGISTROS - 1);
+        f->ram_num--;
+        f->descartados++;
+        f->ignorar = f->em_voo;
+    }
+
+    fila_registro_t *r = &f->ram[(f->ram_inicio + f->ram_num) & (FILA_RAM_REGISTROS - 1)];
+    if (tamanho > FILA_PAYLOAD_MAX) tamanho = FILA_PAYLOAD_MAX;
+    r->instante_ms = instante_ms;
+    r->topico = topico;
+    r->tamanho = tamanho;
+    memcpy(r->payload, payload, tamanho);
+    f->ram_num++;
+}
+
+// Registro i a partir do mais antigo (os da flash são lidos direto pelo XIP), ou NULL
+static const fila_registro_t *fila_registro(const fila_t *f, uint32_t i) {
+    uint32_t na_flash = f->flash_escrita - f->flash_leitura;
+    if (i < na_flash) {
+        uint32_t posicao = (f->flash_leitura + i) % f->flash_capacidade;
+        return (const fila_registro_t *)(XIP_BASE + f->flash_offset + posicao * sizeof(fila_registro_t));
+    }
+    i -= na_flash;
+    return i < f->ram_num ? &f->ram[(f->ram_inicio + i) & (FILA_RAM_REGISTROS - 1)] : NULL;
+}
+
+// Registro mais antigo, ou NULL com a fila vazia
+const fila_registro_t *fila_primeiro(const fila_t *f) {
+    return fila_registro(f, 0);
+}
+
+// Retira o registro devolvido por fila_primeiro, depois de publicado
+void fila_remover(fila_t *f, uint32_t agora_ms) {
+    if (f->flash_leitura != f->flash_escrita) {
+        f->flash_leitura++;
+    } else if (f->ram_num) {
+        f->ram_inicio = (f->ram_inicio + 1) & (FILA_RAM_REGISTROS - 1);
+        f->ram_num--;
+    }
+    if (f->drenando && fila_profundidade(f) == 0) {
+        f->drenando = false;
+        f->drenagem_ms = agora_ms - f->drenagem_inicio_ms;
+    }
+}
+
+// Conexão restabelecida: mede quanto tempo a fila leva para esvaziar
+void fila_drenagem_comecar(fila_t *f, uint32_t agora_ms) {
+    if (fila_profundidade(f) == 0) return;
+    f->drenando = true;
+    f->drenagem_inicio_ms = agora_ms;
+}
+
+// Próximo registro a reenviar: o primeiro depois dos que esperam confirmação, ou NULL
+const fila_registro_t *fila_proximo(const fila_t *f) {
+    return fila_registro(f, f->em_voo - f->ignorar);
+}
+
+// O registro devolvido por fila_proximo foi entregue ao cliente
+void fila_enviado(fila_t *f) {
+    f->em_voo++;
+}
+
+// Conclusão do envio mais antigo sem confirmação. Confirmado, o registro sai da fila; com erro,
+// ele volta a ser o próximo e os envios seguintes, ainda em voo, são abandonados (se chegarem,
+// o broker recebe esses registros duas vezes).
+void fila_confirmado(fila_t *f, bool ok, uint32_t agora_ms) {
+    if (f->em_voo == 0) return;
+    f->em_voo--;
+    if (f->ignorar) {
+        f->ignorar--;
+    } else if (ok) {
+        fila_remover(f, agora_ms);
+    } else {
+        f->ignorar = f->em_voo;
+    }
+}
+
+// Nova conexão: o cliente descartou as requisições da anterior sem concluí-las
+void fila_reenviar(fila_t *f) {
+    f->em_voo = f->ignorar = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef FILA_H
+#define FILA_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+#define FILA_PAYLOAD_MAX 26
+#define FILA_RAM_REGISTROS 64                                   // Potência de 2
+#define FILA_REGISTROS_PAGINA (FLASH_PAGE_SIZE / sizeof(fila_registro_t))
+#define FILA_REGISTROS_SETOR (FLASH_SECTOR_SIZE / sizeof(fila_registro_t))
+
+// Uma publicação guardada enquanto não há conexão: 32 bytes, 8 por página de flash
+typedef struct {
+    uint32_t instante_ms;
+    uint8_t topico;
+    uint8_t tamanho;
+    uint8_t payload[FILA_PAYLOAD_MAX];
+} fila_registro_t;
+
+// Fila de telemetria para guardar e reenviar. Os registros novos entram num anel em RAM; com a
+// área de flash ativa, quando o anel enche as páginas mais antigas descem para a flash (também
+// um anel). A ordem de saída é a de chegada: flash primeiro, depois RAM. Cheia, a fila descarta
+// os registros mais antigos. No reenvio, um registro entregue ao cliente continua na fila até a
+// confirmação do broker; as confirmações chegam na ordem dos envios.
+typedef struct {
+    fila_registro_t ram[FILA_RAM_REGISTROS];
+    uint16_t ram_inicio, ram_num;
+
+    uint32_t flash_offset;      // Início da área (0 = sem flash)
+    uint32_t flash_capacidade;  // Em registros
+    uint32_t flash_leitura, flash_escrita; // Contadores de registros; posição = contador % capacidade
+
+    uint8_t em_voo;             // Envios sem confirmação; os do início da fila, menos os abandonados
+    uint8_t ignorar;            // As próximas confirmações são de envios abandonados
+
+    // Métricas
+    uint32_t descartados;
+    uint32_t drenagem_inicio_ms;
+    uint32_t drenagem_ms;       // Duração da última drenagem completa
+    bool drenando;
+} fila_t;
+
+void fila_init(fila_t *f, uint32_t flash_offset, uint16_t flash_setores);
+void fila_adicionar(fila_t *f, uint8_t topico, uint32_t instante_ms, const void *payload, uint8_t tamanho);
+const fila_registro_t *fila_primeiro(const fila_t *f);
+void fila_remover(fila_t *f, uint32_t agora_ms);
+void fila_drenagem_comecar(fila_t *f, uint32_t agora_ms);
+const fila_registro_t *fila_proximo(const fila_t *f);
+void fila_enviado(fila_t *f);
+void fila_confirmado(fila_t *f, bool ok, uint32_t agora_ms);
+void fila_reenviar(fila_t *f);
+
+static inline uint32_t fila_profundidade(const fila_t *f) {
+    return f->ram_num + (f->flash_escrita - f->flash_leitura);
+}
+
+#endif
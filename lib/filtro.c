@@ -0,0 +1,147 @@
+#include <string.h>
+#include <math.h>
+#include "filtro.h"
+
+// Fator que torna o MAD um estimador do desvio padrão para ruído gaussiano
+#define MAD_PARA_SIGMA 1.4826f
+
+void filtro_init(filtro_t *f, filtro_modo_t modo, uint8_t janela, uint32_t idade_max_ms) {
+    if (janela < 1) janela = 1;
+    if (janela > FILTRO_JANELA_MAX) janela = FILTRO_JANELA_MAX;
+
+    f->modo = modo;
+    f->janela = janela;
+    f->idade_max_ms = idade_max_ms;
+    f->hampel_k = 3.0f;
+    f->ema_alfa = 0.3f;
+    f->rejeitadas = 0;
+    filtro_limpar(f);
+}
+
+void filtro_limpar(filtro_t *f) {
+    f->inicio = 0;
+    f->n = 0;
+    f->ema = 0.0f;
+    f->ema_iniciada = false;
+    f->saida = 0.0f;
+}
+
+// Busca binária: primeira posição com valor maior que v
+static uint8_t posicao_insercao(const filtro_t *f, float v) {
+    uint8_t lo = 0, hi = f->n;
+    while (lo < hi) {
+        uint8_t meio = (lo + hi) / 2;
+        if (f->ordenados[meio] <= v) lo = meio + 1;
+        else hi = meio;
+    }
+    return lo;
+}
+
+// Busca binária: posição de um valor presente na janela ordenada
+static uint8_t posicao_valor(const filtro_t *f, float v) {
+    uint8_t lo = 0, hi = f->n - 1;
+    while (lo < hi) {
+        uint8_t meio = (lo + hi) / 2;
+        if (f->ordenados[meio] < v) lo = meio + 1;
+        else hi = meio;
+    }
+    return lo;
+}
+
+// Remove a amostra mais antiga da janela
+static void remover_mais_antiga(filtro_t *f) {
+    uint8_t pos = posicao_valor(f, f->valores[f->inicio]);
+    memmove(&f->ordenados[pos], &f->ordenados[pos + 1], (f->n - pos - 1) * sizeof(float));
+    f->inicio = (f->inicio + 1) % FILTRO_JANELA_MAX;
+    f->n--;
+}
+
+// Acrescenta uma amostra ao final da janela
+static void acrescentar(filtro_t *f, float v, uint32_t instante_ms) {
+    uint8_t fim = (f->inicio + f->n) % FILTRO_JANELA_MAX;
+    f->valores[fim] = v;
+    f->instantes_ms[fim] = instante_ms;
+
+    uint8_t pos = posicao_insercao(f, v);
+    memmove(&f->ordenados[pos + 1], &f->ordenados[pos], (f->n - pos) * sizeof(float));
+    f->ordenados[pos] = v;
+    f->n++;
+}
+
+// Mediana da janela atual (leitura direta na janela ordenada)
+float filtro_mediana(const filtro_t *f) {
+    if (f->n == 0) return 0.0f;
+    if (f->n & 1) return f->ordenados[f->n / 2];
+    return 0.5f * (f->ordenados[f->n / 2 - 1] + f->ordenados[f->n / 2]);
+}
+
+// Mediana dos desvios absolutos em torno da mediana.
+// Os desvios crescem ao caminhar para fora a partir do meio da janela ordenada,
+// então basta intercalar os dois lados até a posição do meio, sem ordenar de novo.
+float filtro_mad(const filtro_t *f) {
+    if (f->n < 2) return 0.0f;
+
+    float m = filtro_mediana(f);
+    int esq = (f->n - 1) / 2;
+    int dir = esq + 1;
+    int alvo = (f->n - 1) / 2;
+    float anterior = 0.0f, atual = 0.0f;
+
+    for (int k = 0; k <= alvo + 1 && k < f->n; k++) {
+        float de = (esq >= 0) ? m - f->ordenados[esq] : 1e30f;
+        float dd = (dir < f->n) ? f->ordenados[dir] - m : 1e30f;
+        anterior = atual;
+        if (de <= dd) {
+            atual = de;
+            esq--;
+        } else {
+            atual = dd;
+            dir++;
+        }
+        if (k == alvo && (f->n & 1)) return atual;
+    }
+    return 0.5f * (anterior + atual);
+}
+
+// Insere uma amostra bruta e devolve o valor filtrado
+float filtro_inserir(filtro_t *f, float valor, uint32_t instante_ms) {
+    // Descarta amostras velhas e abre espaço na janela
+    while (f->n > 0 && f->idade_max_ms &&
+           instante_ms - f->instantes_ms[f->inicio] > f->idade_max_ms) {
+        remover_mais_antiga(f);
+    }
+    if (f->n >= f->janela) {
+        remover_mais_antiga(f);
+    }
+
+    switch (f->modo) {
+        case FILTRO_MEDIANA:
+            acrescentar(f, valor, instante_ms);
+            f->saida = filtro_mediana(f);
+            break;
+
+        case FILTRO_HAMPEL:
+            // Compara com a janela anterior; o valor bruto entra mesmo assim,
+            // para que uma mudança real seja aceita quando virar maioria
+            f->saida = valor;
+            if (f->n >= 3) {
+                float m = filtro_mediana(f);
+                float limite = fmaxf(f->hampel_k * MAD_PARA_SIGMA * filtro_mad(f), FILTRO_HAMPEL_MIN_CM);
+                float desvio = valor > m ? valor - m : m - valor;
+                if (desvio > limite) {
+                    f->saida = m;
+                    f->rejeitadas++;
+                }
+            }
+            acrescentar(f, valor, instante_ms);
+            break;
+
+        case FILTRO_EMA:
+            acrescentar(f, valor, instante_ms);
+            f->ema = f->ema_iniciada ? f->ema + f->ema_alfa * (valor - f->ema) : valor;
+            f->ema_iniciada = true;
+            f->saida = f->ema;
+            break;
+    }
+    return f->saida;
+}
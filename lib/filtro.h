@@ -0,0 +1,47 @@
+#ifndef FILTRO_H
+#define FILTRO_H
+
+#include "pico/stdlib.h"
+
+// Tamanho máximo da janela deslizante
+#define FILTRO_JANELA_MAX 32
+
+// Limiar mínimo do Hampel: com a cena parada as leituras em cm inteiros se repetem e o MAD é 0
+#define FILTRO_HAMPEL_MIN_CM 1.0f
+
+// Modos de filtragem
+typedef enum {
+    FILTRO_MEDIANA, // Mediana móvel da janela
+    FILTRO_HAMPEL,  // Amostra bruta, trocada pela mediana quando for outlier
+    FILTRO_EMA      // Média móvel exponencial
+} filtro_modo_t;
+
+// Filtro incremental: cada amostra nova produz um valor filtrado
+typedef struct {
+    filtro_modo_t modo;
+    uint8_t janela;        // Número máximo de amostras na janela
+    uint32_t idade_max_ms; // Amostras mais antigas saem da janela (0 = sem limite)
+    float hampel_k;        // Limiar do Hampel em desvios (MAD escalado)
+    float ema_alfa;        // Peso da amostra nova na EMA
+
+    // Janela em ordem de chegada (buffer circular)
+    float valores[FILTRO_JANELA_MAX];
+    uint32_t instantes_ms[FILTRO_JANELA_MAX];
+    uint8_t inicio, n;
+
+    // Mesma janela ordenada por valor
+    float ordenados[FILTRO_JANELA_MAX];
+
+    float ema;
+    bool ema_iniciada;
+    float saida;
+    uint32_t rejeitadas; // Outliers descartados pelo Hampel
+} filtro_t;
+
+void filtro_init(filtro_t *f, filtro_modo_t modo, uint8_t janela, uint32_t idade_max_ms);
+float filtro_inserir(filtro_t *f, float valor, uint32_t instante_ms);
+float filtro_mediana(const filtro_t *f);
+float filtro_mad(const filtro_t *f);
+void filtro_limpar(filtro_t *f);
+
+#endif
@@ -0,0 +1,46 @@
+#include "grafico.h"
+
+void grafico_init(grafico_t *g, ssd1306_t *ssd, uint8_t pagina, uint16_t escala_cm) {
+    g->ssd = ssd;
+    g->pagina = pagina;
+    g->escala_cm = escala_cm;
+    g->colunas = 0;
+    ssd1306_preencher(ssd, 0, pagina * 8, ssd->width, 8, false, SSD1306_COPIAR);
+    ssd1306_rolagem(ssd, pagina, pagina, GRAFICO_INTERVALO); // Liga no próximo envio
+}
+
+// Barra de 1 a 8 pixels crescendo a partir da base da página (bit 7 é a linha de baixo)
+static uint8_t grafico_barra(const grafico_t *g, uint16_t distancia_cm) {
+    uint16_t d = distancia_cm > g->escala_cm ? g->escala_cm : distancia_cm;
+    uint8_t altura = 1 + (uint32_t)d * 7 / g->escala_cm;
+    return (uint8_t)(0xFF << (8 - altura));
+}
+
+// Registra a distância atual nas colunas que a rolagem trouxe desde a última amostra (todas
+// recebem o mesmo valor). Sem passo concluído nada é enviado: cada envio desliga e religa a
+// rolagem, e o painel recomeça o passo do zero. Retorna em quantos ms o próximo passo termina,
+// que é quando a próxima amostra deve ser feita.
+uint32_t grafico_amostra(grafico_t *g, uint16_t distancia_cm) {
+    ssd1306_t *ssd = g->ssd;
+    uint8_t barra = grafico_barra(g, distancia_cm);
+
+    if (!ssd->rolagem_no_painel) {
+        // Rolagem ainda não ligada: a coluna da direita é só atualizada, e o envio a liga
+        ssd->ram_buffer[((ssd->width - 1) << 3) + g->pagina + 1] = barra;
+        ssd1306_send_data(ssd);
+        return GRAFICO_ESPERA_MAX_MS;
+    }
+
+    uint8_t novas = ssd1306_rolagem_sincronizar(ssd);
+    if (novas > 0) {
+        for (uint8_t x = ssd->width - novas; x < ssd->width; ++x) {
+            ssd->ram_buffer[(x << 3) + g->pagina + 1] = barra;
+        }
+        if ((g->colunas += novas) >= GRAFICO_ANCORA) {
+            g->colunas = 0;
+            ssd1306_invalidar_paginas(ssd, g->pagina, g->pagina);
+        }
+        ssd1306_send_data(ssd); // Normalmente um byte: desliga a rolagem, escreve a coluna e religa
+    }
+    return ssd1306_rolagem_restante_us(ssd) / 1000 + 1;
+}
@@ -0,0 +1,29 @@
+#ifndef GRAFICO_H
+#define GRAFICO_H
+
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+
+// Intervalo da rolagem por hardware: 25 quadros por coluna (~285 ms a ~88 Hz)
+#define GRAFICO_INTERVALO SSD1306_ROLAGEM_25_QUADROS
+
+// A cada tantas colunas (~30 s) a página é reescrita inteira, corrigindo a diferença entre
+// os passos estimados pelo firmware e os que o painel realmente deu
+#define GRAFICO_ANCORA 100
+
+// Espera até a próxima amostra enquanto a rolagem não está ligada no painel
+#define GRAFICO_ESPERA_MAX_MS 150
+
+// Histórico de distância numa página do display: o controlador rola a página para a
+// esquerda sozinho e o firmware só escreve as colunas que entram pela direita
+typedef struct {
+    ssd1306_t *ssd;
+    uint8_t pagina;
+    uint16_t escala_cm;    // Distância que enche a barra
+    uint16_t colunas;      // Desde a última reescrita completa
+} grafico_t;
+
+void grafico_init(grafico_t *g, ssd1306_t *ssd, uint8_t pagina, uint16_t escala_cm);
+uint32_t grafico_amostra(grafico_t *g, uint16_t distancia_cm);
+
+#endif
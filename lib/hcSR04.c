@@ -1,4 +1,10 @@
 #include "hcSR04.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// ARQUIVO .pio
+#include "build/hcSR04.pio.h"
 
 // Tempo máximo de espera pelo retorno do pulso (em microssegundos)
 int timeout = 26100;
@@ -91,4 +97,136 @@ uint64_t getCmFiltered(uint trigPin, uint echoPin, int samples) {
     
     // Retornar a mediana
     return values[valid_readings / 2];
-}
\ No newline at end of file
+}
+
+// ============================================================================
+//                    MEDIÇÃO NÃO BLOQUEANTE VIA PIO
+// ============================================================================
+
+// Sensores registrados para o tratador de interrupção (até 4 por PIO)
+static hcsr04_t *sensores[2 * NUM_PIO_STATE_MACHINES];
+static uint num_sensores = 0;
+static int offset_programa[2] = {-1, -1};
+static bool irq_instalada[2] = {false, false};
+
+// Coloca uma amostra no buffer circular (executa na interrupção)
+static void hcsr04_registrar(hcsr04_t *sensor, uint32_t resto) {
+    hcsr04_amostra_t amostra = { .instante_us = sensor->disparo_us };
+
+    if (resto == 0xFFFFFFFF || resto > HCSR04_TIMEOUT_US) {
+        amostra.eco_us = 0;
+        amostra.valida = false;
+        sensor->timeouts++;
+    } else {
+        amostra.eco_us = HCSR04_TIMEOUT_US - resto;
+        amostra.valida = true;
+    }
+
+    uint8_t proxima = (sensor->cabeca + 1) & (HCSR04_BUFFER_TAM - 1);
+    if (proxima == sensor->cauda) {
+        sensor->descartadas++; // Buffer cheio - consumidor atrasado
+    } else {
+        sensor->buffer[sensor->cabeca] = amostra;
+        __dmb();
+        sensor->cabeca = proxima;
+    }
+    sensor->ocupado = false;
+
+    if (sensor->ao_concluir) {
+        sensor->ao_concluir(sensor->dados_concluir);
+    }
+}
+
+// Esvazia o RX FIFO de todas as máquinas de estados do sensor
+static void hcsr04_irq_handler(void) {
+    for (uint i = 0; i < num_sensores; i++) {
+        hcsr04_t *sensor = sensores[i];
+        while (!pio_sm_is_rx_fifo_empty(sensor->pio, sensor->sm)) {
+            hcsr04_registrar(sensor, pio_sm_get(sensor->pio, sensor->sm));
+        }
+    }
+}
+
+// Configura um sensor em qualquer PIO com máquina de estados e memória livres
+bool hcsr04_init(hcsr04_t *sensor, uint trigPin, uint echoPin) {
+    const PIO pios[2] = {pio0, pio1};
+
+    if (num_sensores >= count_of(sensores)) return false;
+
+    for (uint i = 0; i < 2; i++) {
+        PIO pio = pios[i];
+        if (offset_programa[i] < 0 && !pio_can_add_program(pio, &hcsr04_program)) continue;
+
+        int sm = pio_claim_unused_sm(pio, false);
+        if (sm < 0) continue;
+
+        if (offset_programa[i] < 0) {
+            offset_programa[i] = pio_add_program(pio, &hcsr04_program);
+        }
+
+        sensor->pio = pio;
+        sensor->sm = sm;
+        sensor->offset = offset_programa[i];
+        sensor->trig_pin = trigPin;
+        sensor->echo_pin = echoPin;
+        sensor->ocupado = false;
+        sensor->cabeca = sensor->cauda = 0;
+        sensor->descartadas = sensor->timeouts = 0;
+        sensor->ao_concluir = NULL;
+        sensor->dados_concluir = NULL;
+
+        gpio_init(echoPin);
+        gpio_set_dir(echoPin, GPIO_IN);
+        hcsr04_program_init(pio, sm, sensor->offset, trigPin, echoPin);
+
+        sensores[num_sensores++] = sensor;
+
+        // Interrupção quando o resultado chegar ao RX FIFO
+        uint irq = (i == 0) ? PIO0_IRQ_0 : PIO1_IRQ_0;
+        pio_set_irq0_source_enabled(pio, pis_sm0_rx_fifo_not_empty + sm, true);
+        if (!irq_instalada[i]) {
+            irq_add_shared_handler(irq, hcsr04_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+            irq_set_enabled(irq, true);
+            irq_instalada[i] = true;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Dispara uma medição sem esperar o eco; retorna false se ainda houver uma em andamento
+bool hcsr04_disparar(hcsr04_t *sensor) {
+    if (sensor->ocupado) {
+        if (time_us_64() - sensor->disparo_us < HCSR04_WATCHDOG_US) {
+            return false;
+        }
+        // Máquina de estados travada (eco preso em HIGH, por exemplo): reinicia
+        pio_sm_set_enabled(sensor->pio, sensor->sm, false);
+        pio_sm_clear_fifos(sensor->pio, sensor->sm);
+        pio_sm_restart(sensor->pio, sensor->sm);
+        pio_sm_exec(sensor->pio, sensor->sm, pio_encode_jmp(sensor->offset));
+        pio_sm_set_enabled(sensor->pio, sensor->sm, true);
+        sensor->timeouts++;
+    }
+
+    sensor->ocupado = true;
+    sensor->disparo_us = time_us_64();
+    pio_sm_put(sensor->pio, sensor->sm, HCSR04_TIMEOUT_US);
+    return true;
+}
+
+// Registra uma função chamada (na interrupção) ao fim de cada medição
+void hcsr04_ao_concluir(hcsr04_t *sensor, void (*callback)(void *dados), void *dados) {
+    sensor->dados_concluir = dados;
+    sensor->ao_concluir = callback;
+}
+
+// Retira a amostra mais antiga do buffer circular
+bool hcsr04_ler(hcsr04_t *sensor, hcsr04_amostra_t *amostra) {
+    if (sensor->cauda == sensor->cabeca) return false;
+
+    *amostra = sensor->buffer[sensor->cauda];
+    __dmb();
+    sensor->cauda = (sensor->cauda + 1) & (HCSR04_BUFFER_TAM - 1);
+    return true;
+}
@@ -1,8 +1,54 @@
+#ifndef HCSR04_H
+#define HCSR04_H
+
 #include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+// Tamanho do buffer circular de amostras por sensor (potência de 2)
+#define HCSR04_BUFFER_TAM 16
+
+// Limite de espera pelo eco em µs (~4,5 m ida e volta)
+#define HCSR04_TIMEOUT_US 26100
+
+// Tempo máximo que uma medição pode ficar pendente antes de reiniciar a máquina de estados
+#define HCSR04_WATCHDOG_US 60000
 
+// Amostra produzida pela interrupção do PIO
+typedef struct {
+    uint64_t instante_us; // Momento do disparo do trigger
+    uint32_t eco_us;      // Duração do eco em µs (0 se inválida)
+    bool valida;          // false em caso de timeout
+} hcsr04_amostra_t;
+
+// Motor de medição não bloqueante (uma máquina de estados do PIO por sensor)
+typedef struct {
+    PIO pio;
+    uint sm, offset;
+    uint trig_pin, echo_pin;
+    volatile bool ocupado;
+    volatile uint64_t disparo_us;
+    hcsr04_amostra_t buffer[HCSR04_BUFFER_TAM];
+    volatile uint8_t cabeca, cauda;
+    volatile uint32_t descartadas; // Amostras perdidas com o buffer cheio
+    volatile uint32_t timeouts;    // Medições sem eco válido
+    void (*ao_concluir)(void *dados); // Chamada na interrupção ao fim de cada medição
+    void *dados_concluir;
+} hcsr04_t;
 
 void setupUltrasonicPins(uint trigPin, uint echoPin);
 uint64_t getPulse(uint trigPin, uint echoPin);
 uint64_t getCm(uint trigPin, uint echoPin);
 uint64_t getInch(uint trigPin, uint echoPin);
 uint64_t getCmFiltered(uint trigPin, uint echoPin, int samples);
+
+bool hcsr04_init(hcsr04_t *sensor, uint trigPin, uint echoPin);
+bool hcsr04_disparar(hcsr04_t *sensor);
+bool hcsr04_ler(hcsr04_t *sensor, hcsr04_amostra_t *amostra);
+void hcsr04_ao_concluir(hcsr04_t *sensor, void (*callback)(void *dados), void *dados);
+
+// Fórmula: (tempo em μs) / 29 / 2 = distância em cm
+static inline uint32_t hcsr04_eco_para_cm(uint32_t eco_us) {
+    return eco_us / 29 / 2;
+}
+
+#endif
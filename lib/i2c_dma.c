@@ -0,0 +1,194 @@
+#include <stdlib.h>
+#include "i2c_dma.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// Transporte de cada periférico I2C, para o tratador de interrupção
+static i2c_dma_t *transportes[2];
+
+// Encerra a transferência atual (executa na interrupção)
+static void i2c_dma_finalizar(i2c_dma_t *t, i2c_dma_resultado_t resultado) {
+    i2c_get_hw(t->i2c)->intr_mask = 0;
+    t->resultado = resultado;
+    t->ocupado = false;
+    if (t->ao_concluir) t->ao_concluir(t->dados_concluir);
+}
+
+// Linha em dreno aberto: nível baixo é saída em 0, nível alto é entrada com pull-up
+static void i2c_dma_linha(uint pino, bool alto) {
+    if (alto) {
+        gpio_set_dir(pino, GPIO_IN);
+    } else {
+        gpio_put(pino, 0);
+        gpio_set_dir(pino, GPIO_OUT);
+    }
+    busy_wait_us(5);
+}
+
+// Libera um escravo que prende o SDA: pulsos de clock até ele soltar a linha, depois um STOP
+static void i2c_dma_recuperar_barramento(i2c_dma_t *t) {
+    i2c_deinit(t->i2c);
+    gpio_init(t->sda);
+    gpio_init(t->scl);
+    i2c_dma_linha(t->sda, true);
+    i2c_dma_linha(t->scl, true);
+
+    for (uint i = 0; i < I2C_DMA_PULSOS_RECUPERACAO && !gpio_get(t->sda); i++) {
+        i2c_dma_linha(t->scl, false);
+        i2c_dma_linha(t->scl, true);
+    }
+    i2c_dma_linha(t->scl, false);
+    i2c_dma_linha(t->sda, false);
+    i2c_dma_linha(t->scl, true);
+    i2c_dma_linha(t->sda, true);
+
+    i2c_init(t->i2c, t->baudrate);
+    i2c_get_hw(t->i2c)->intr_mask = 0;
+    gpio_set_function(t->sda, GPIO_FUNC_I2C);
+    gpio_set_function(t->scl, GPIO_FUNC_I2C);
+}
+
+// Prazo esgotado sem STOP: o barramento está preso
+static int64_t i2c_dma_prazo_cb(__unused alarm_id_t id, void *dados) {
+    i2c_dma_t *t = (i2c_dma_t *)dados;
+    t->alarme = 0;
+    if (!t->ocupado) return 0;
+
+    dma_channel_abort(t->canal);
+    t->tempos_esgotados++;
+    i2c_dma_recuperar_barramento(t);
+    i2c_dma_finalizar(t, I2C_DMA_TEMPO_ESGOTADO);
+    return 0;
+}
+
+// STOP enviado ou transferência abortada pelo periférico
+static void i2c_dma_irq_handler(void) {
+    for (uint i = 0; i < count_of(transportes); i++) {
+        i2c_dma_t *t = transportes[i];
+        if (!t || !t->ocupado) continue;
+
+        i2c_hw_t *hw = i2c_get_hw(t->i2c);
+        uint32_t estado = hw->raw_intr_stat;
+        if (estado & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+            // O periférico descarta o FIFO e envia STOP; o DMA não pode continuar escrevendo
+            dma_channel_abort(t->canal);
+            (void)hw->clr_tx_abrt;
+            (void)hw->clr_stop_det;
+            t->abortos++;
+        } else if (estado & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS) {
+            (void)hw->clr_stop_det;
+        } else {
+            continue;
+        }
+
+        if (t->alarme > 0) {
+            alarm_pool_cancel_alarm(t->pool, t->alarme);
+            t->alarme = 0;
+        }
+        i2c_dma_finalizar(t, (estado & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) ? I2C_DMA_ABORTADO : I2C_DMA_OK);
+    }
+}
+
+// O periférico já deve estar configurado (setup_I2C). As interrupções ficam no núcleo que chama.
+bool i2c_dma_init(i2c_dma_t *t, i2c_inst_t *i2c, uint sda, uint scl, uint baudrate,
+                  alarm_pool_t *pool, size_t capacidade) {
+    uint indice = i2c_hw_index(i2c);
+    if (transportes[indice]) return false;
+
+    int canal = dma_claim_unused_channel(false);
+    if (canal < 0) return false;
+
+    t->palavras = calloc(capacidade, sizeof(uint16_t));
+    if (!t->palavras) return false;
+
+    t->i2c = i2c;
+    t->sda = sda;
+    t->scl = scl;
+    t->baudrate = baudrate;
+    t->canal = canal;
+    t->pool = pool;
+    t->alarme = 0;
+    t->num = 0;
+    t->capacidade = capacidade;
+    t->reiniciar = false;
+    t->estouro = false;
+    t->ocupado = false;
+    t->resultado = I2C_DMA_OK;
+    t->abortos = t->tempos_esgotados = 0;
+    t->ao_concluir = NULL;
+    t->dados_concluir = NULL;
+
+    // Palavras de 16 bits no IC_DATA_CMD, no ritmo do FIFO de transmissão
+    dma_channel_config c = dma_channel_get_default_config(canal);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    dma_channel_configure(canal, &c, &hw->data_cmd, t->palavras, 0, false);
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+
+    // As interrupções do periférico só ficam ativas durante uma transferência por DMA,
+    // para não disputar o STOP_DET com as funções bloqueantes do SDK
+    hw->intr_mask = 0;
+    transportes[indice] = t;
+    uint irq = I2C0_IRQ + indice;
+    irq_add_shared_handler(irq, i2c_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(irq, true);
+    return true;
+}
+
+void i2c_dma_ao_concluir(i2c_dma_t *t, void (*fn)(void *dados), void *dados) {
+    t->dados_concluir = dados;
+    t->ao_concluir = fn;
+}
+
+// Inicia uma nova sequência; só pode ser chamada com o transporte livre
+void i2c_dma_comecar(i2c_dma_t *t) {
+    t->num = 0;
+    t->reiniciar = false;
+    t->estouro = false;
+}
+
+// O próximo byte abre uma nova transação (START repetido e endereço de novo)
+void i2c_dma_nova_transacao(i2c_dma_t *t) {
+    t->reiniciar = t->num > 0;
+}
+
+void i2c_dma_escrever(i2c_dma_t *t, const uint8_t *dados, size_t n) {
+    if (t->num + n > t->capacidade) {
+        t->estouro = true;
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint16_t palavra = dados[i];
+        if (t->reiniciar) {
+            palavra |= I2C_IC_DATA_CMD_RESTART_BITS;
+            t->reiniciar = false;
+        }
+        t->palavras[t->num++] = palavra;
+    }
+}
+
+// Entrega a sequência ao DMA e retorna sem esperar; o fim chega por ao_concluir
+bool i2c_dma_enviar(i2c_dma_t *t, uint8_t endereco) {
+    if (t->ocupado || t->num == 0 || t->estouro) return false;
+
+    i2c_hw_t *hw = i2c_get_hw(t->i2c);
+    t->palavras[t->num - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    // O endereço do escravo só pode ser trocado com o periférico desligado
+    hw->enable = 0;
+    hw->tar = endereco;
+    hw->enable = 1;
+    (void)hw->clr_stop_det;
+    (void)hw->clr_tx_abrt;
+
+    // 9 bits por byte no barramento, mais a folga
+    uint64_t prazo_us = (uint64_t)t->num * 9 * 1000000 / t->baudrate + I2C_DMA_FOLGA_US;
+    t->ocupado = true;
+    t->alarme = alarm_pool_add_alarm_in_us(t->pool, prazo_us, i2c_dma_prazo_cb, t, true);
+    hw->intr_mask = I2C_IC_RAW_INTR_STAT_STOP_DET_BITS | I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+    dma_channel_transfer_from_buffer_now(t->canal, t->palavras, t->num);
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef I2C_DMA_H
+#define I2C_DMA_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Folga sobre o tempo teórico de uma transferência antes de considerar o barramento travado
+#define I2C_DMA_FOLGA_US 2000
+
+// Pulsos de clock usados para liberar um escravo que prende o SDA
+#define I2C_DMA_PULSOS_RECUPERACAO 9
+
+// Resultado da última transferência
+typedef enum {
+    I2C_DMA_OK,
+    I2C_DMA_ABORTADO,       // NACK ou perda de arbitragem (TX_ABRT)
+    I2C_DMA_TEMPO_ESGOTADO  // Sem STOP no prazo: barramento recuperado e periférico reiniciado
+} i2c_dma_resultado_t;
+
+// Transporte I2C não bloqueante: a CPU monta uma sequência de transações e o DMA
+// alimenta o IC_DATA_CMD; o fim é sinalizado pela interrupção de STOP do periférico.
+typedef struct {
+    i2c_inst_t *i2c;
+    uint sda, scl, baudrate;
+    uint canal;                    // Canal de DMA
+    alarm_pool_t *pool;            // Pool do alarme de prazo
+    alarm_id_t alarme;
+    uint16_t *palavras;            // Palavras de IC_DATA_CMD (byte + bits de RESTART/STOP)
+    size_t num, capacidade;
+    bool reiniciar;                // Próximo byte começa uma nova transação (RESTART)
+    bool estouro;                  // A sequência não coube no buffer
+    volatile bool ocupado;
+    volatile i2c_dma_resultado_t resultado;
+    volatile uint32_t abortos, tempos_esgotados;
+    void (*ao_concluir)(void *dados); // Chamada na interrupção ao fim de cada transferência
+    void *dados_concluir;
+} i2c_dma_t;
+
+bool i2c_dma_init(i2c_dma_t *t, i2c_inst_t *i2c, uint sda, uint scl, uint baudrate,
+                  alarm_pool_t *pool, size_t capacidade);
+void i2c_dma_ao_concluir(i2c_dma_t *t, void (*fn)(void *dados), void *dados);
+void i2c_dma_comecar(i2c_dma_t *t);
+void i2c_dma_nova_transacao(i2c_dma_t *t);
+void i2c_dma_escrever(i2c_dma_t *t, const uint8_t *dados, size_t n);
+bool i2c_dma_enviar(i2c_dma_t *t, uint8_t endereco);
+
+static inline bool i2c_dma_livre(const i2c_dma_t *t) {
+    return !t->ocupado;
+}
+
+#endif
@@ -1,18 +1,137 @@
+#include <string.h>
 #include "hardware/clocks.h"
 #include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
 #include "led_5x5.h"
+#include "sprites.h"
 
 // ARQUIVO .pio
 #include "build/ws2812.pio.h"
 
+#define PIO_MATRIZ pio0
+
+// ESTADO DO DRIVER
+static uint sm_matriz;
+static uint dma_matriz;
+static alarm_pool_t *pool_matriz;
+
+// Dois quadros: o da frente é lido pelo DMA, o de trás é desenhado pela CPU
+static uint32_t quadros[2][NUM_PIXELS];
+static volatile uint8_t frente = 0;
+static volatile uint64_t inicio_envio_us = 0;
+static volatile alarm_id_t alarme_pendente = 0;
+
+// Animação em curso
+static const animacao_t *animacao_atual = NULL;
+static uint8_t quadro_animacao;
+static alarm_id_t alarme_animacao = 0;
+
+#define NUM_QUADROS(v) (sizeof(v) / sizeof((v)[0]))
+
+const animacao_t ANIM_X_PISCANDO = { QUADROS_X_PISCANDO, NUM_QUADROS(QUADROS_X_PISCANDO), 250, true };
+const animacao_t ANIM_CHECK_PULSANDO = { QUADROS_CHECK_PULSANDO, NUM_QUADROS(QUADROS_CHECK_PULSANDO), 200, true };
+const animacao_t ANIM_VARREDURA = { QUADROS_VARREDURA, NUM_QUADROS(QUADROS_VARREDURA), 80, false };
+
+
+// Envia o quadro de trás se for diferente do último enviado (interrupções desligadas)
+static void matriz_enviar() {
+    uint8_t tras = frente ^ 1;
+    if (memcmp(quadros[tras], quadros[frente], sizeof(quadros[0])) == 0) return; // Quadro repetido
+
+    frente = tras;
+    inicio_envio_us = time_us_64();
+    dma_channel_set_read_addr(dma_matriz, quadros[frente], true);
+    // O novo quadro de trás parte do que foi enviado, permitindo desenhar só parte dele
+    memcpy(quadros[frente ^ 1], quadros[frente], sizeof(quadros[0]));
+}
+
+// Fim do tempo de guarda: envia o quadro que ficou pendente
+static int64_t matriz_pendente_cb(__unused alarm_id_t id, __unused void *dados) {
+    alarme_pendente = 0;
+    matriz_enviar();
+    return 0;
+}
 
 // INICIALIZAÇÃO E CONFIGURAÇÃO DO PIO
-void setup_PIO() {
-    PIO pio = pio0;
+// O pool deve interromper o núcleo que desenha na matriz
+void setup_PIO(alarm_pool_t *pool) {
+    PIO pio = PIO_MATRIZ;
     uint offset = pio_add_program(pio, &ws2812_program);
-    uint sm = pio_claim_unused_sm(pio, true);
-    ws2812_program_init(pio, sm, offset, OUT_PIN);
-    matrix_rgb(0.0, 0.0, 0.0); // Inicializa a matriz com todos os LEDs apagados
+    sm_matriz = pio_claim_unused_sm(pio, true);
+    ws2812_program_init(pio, sm_matriz, offset, OUT_PIN);
+    pool_matriz = pool;
+
+    // DMA de 32 bits da memória para a FIFO de TX, no ritmo pedido pela máquina de estados
+    dma_matriz = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(dma_matriz);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm_matriz, true));
+    dma_channel_configure(dma_matriz, &c, &pio->txf[sm_matriz], quadros[frente], NUM_PIXELS, true); // Inicializa a matriz com todos os LEDs apagados
+    inicio_envio_us = time_us_64();
+}
+
+// Quadro de trás, onde as funções de desenho escrevem
+uint32_t *matriz_quadro() {
+    return quadros[frente ^ 1];
+}
+
+// Troca os quadros e inicia o DMA; durante um envio (e o reset do WS2812) o quadro fica pendente
+void matriz_apresentar() {
+    uint32_t status = save_and_disable_interrupts();
+    uint64_t decorrido = time_us_64() - inicio_envio_us;
+    if (decorrido >= MATRIZ_GUARDA_US) {
+        matriz_enviar();
+    } else if (!alarme_pendente) {
+        alarme_pendente = alarm_pool_add_alarm_in_us(pool_matriz, MATRIZ_GUARDA_US - decorrido, matriz_pendente_cb, NULL, true);
+    }
+    restore_interrupts(status);
+}
+
+// Copia um quadro pronto para o quadro de trás e o apresenta
+static void matriz_mostrar(const uint32_t *quadro) {
+    memcpy(matriz_quadro(), quadro, sizeof(quadros[0]));
+    matriz_apresentar();
+}
+
+// Alarme da animação: mostra o próximo quadro e reagenda pelo período
+static int64_t matriz_animacao_cb(__unused alarm_id_t id, __unused void *dados) {
+    const animacao_t *a = animacao_atual;
+    if (++quadro_animacao >= a->num) {
+        if (!a->repetir) {
+            animacao_atual = NULL; // O último quadro fica na matriz
+            alarme_animacao = 0;
+            return 0;
+        }
+        quadro_animacao = 0;
+    }
+    matriz_mostrar(a->quadros[quadro_animacao]);
+    return -(int64_t)a->periodo_ms * 1000;
+}
+
+// Inicia uma animação; pedir a que já está tocando não a reinicia
+void matriz_animar(const animacao_t *animacao) {
+    uint32_t status = save_and_disable_interrupts();
+    if (animacao != animacao_atual) {
+        if (alarme_animacao) alarm_pool_cancel_alarm(pool_matriz, alarme_animacao);
+        animacao_atual = animacao;
+        quadro_animacao = 0;
+        matriz_mostrar(animacao->quadros[0]);
+        alarme_animacao = animacao->num > 1 ?
+            alarm_pool_add_alarm_in_us(pool_matriz, animacao->periodo_ms * 1000u, matriz_animacao_cb, NULL, true) : 0;
+    }
+    restore_interrupts(status);
+}
+
+// Para a animação deixando o quadro atual na matriz
+void matriz_parar_animacao() {
+    uint32_t status = save_and_disable_interrupts();
+    if (alarme_animacao) alarm_pool_cancel_alarm(pool_matriz, alarme_animacao);
+    alarme_animacao = 0;
+    animacao_atual = NULL;
+    restore_interrupts(status);
 }
 
 // FUNÇÃO PARA ENVIAR O VALOR RGB PARA A MATRIZ
@@ -24,10 +143,18 @@ uint32_t matrix_rgb(double r, double g, double b) {
     return (G << 24) | (R << 16) | (B << 8);
 }
 
+// Preenche o quadro com uma cor e o apresenta
+static void preencherMatriz(uint32_t valor_led) {
+    matriz_parar_animacao();
+    uint32_t *quadro = matriz_quadro();
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        quadro[i] = valor_led;
+    }
+    matriz_apresentar();
+}
+
 // ACENDE TODOS OS LEDS COM UMA COR ESPECÍFICA
 void drawMatrix(uint cor) {
-    uint32_t valor_led;
-
     /*
     "0. Azul", 
     "1. Verde", 
@@ -38,40 +165,23 @@ void drawMatrix(uint cor) {
     switch (cor)
     {
     case 0:
-        for (int16_t i = 0; i < NUM_PIXELS; i++) {
-            valor_led = matrix_rgb(0.0, 0.0, 0.2);
-            pio_sm_put_blocking(pio0, 0, valor_led);
-        }
+        preencherMatriz(matrix_rgb(0.0, 0.0, 0.2));
         break;
     case 1:
-        for (int16_t i = 0; i < NUM_PIXELS; i++) {
-            valor_led = matrix_rgb(0.0, 0.2, 0.0);
-            pio_sm_put_blocking(pio0, 0, valor_led);
-        }
+        preencherMatriz(matrix_rgb(0.0, 0.2, 0.0));
         break;
     case 2:
-        for (int16_t i = 0; i < NUM_PIXELS; i++) {
-            valor_led = matrix_rgb(0.2, 0.0, 0.0);
-            pio_sm_put_blocking(pio0, 0, valor_led);
-        }
+        preencherMatriz(matrix_rgb(0.2, 0.0, 0.0));
         break;
     case 3:
-        for (int16_t i = 0; i < NUM_PIXELS; i++) {
-            valor_led = matrix_rgb(0.0, 0.0, 0.0);
-            pio_sm_put_blocking(pio0, 0, valor_led);
-        }
+        preencherMatriz(matrix_rgb(0.0, 0.0, 0.0));
         break;
     }
-    
-    
-
 }
 
 void apagarMatriz() {
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        uint32_t valor_led = matrix_rgb(0.0, 0.0, 0.0);
-        pio_sm_put_blocking(pio0, 0, valor_led);
-    }
+    matriz_parar_animacao();
+    matriz_mostrar(SPRITE_APAGADO);
 }
 
 // DESENHO NOS LEDS CENTRAIS
@@ -79,42 +189,22 @@ bool isCentroMatriz(int i) {
     return i == 6 || i == 7 || i == 8 || i == 11 || i == 12 || i == 13 || i == 16 || i == 17 || i == 18;
 }
 void desenharCorNaMatriz(float r, float g, float b) {
+    matriz_parar_animacao();
+    uint32_t *quadro = matriz_quadro();
+    uint32_t cor = matrix_rgb(r, g, b);
     for (int i = 0; i < NUM_PIXELS; i++) {
-        uint32_t valor_led;
-
-        valor_led = isCentroMatriz(i) ? matrix_rgb(r, g, b) : matrix_rgb(0.0, 0.0, 0.0);
-        
-        pio_sm_put_blocking(pio0, 0, valor_led);
+        quadro[i] = isCentroMatriz(i) ? cor : 0;
     }
+    matriz_apresentar();
 }
 
 
 void desenhoCheck() {
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        uint32_t valor_led;
-
-        if (i == 3 || i == 5 || i == 7 || i == 11 || i == 19) {
-            valor_led = matrix_rgb(0.0, 0.01, 0.0);
-        } else {
-            valor_led = matrix_rgb(0.0, 0.0, 0.0);
-        }
-
-        pio_sm_put_blocking(pio0, 0, valor_led);
-    }
+    matriz_parar_animacao();
+    matriz_mostrar(SPRITE_CHECK);
 }
 
 void desenhoX() {
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        uint32_t valor_led;
-
-        if (i == 6 || i == 8 || i == 12 || i == 16 || i == 18) {
-            valor_led = matrix_rgb(0.2, 0.0, 0.0);
-        } else {
-            valor_led = matrix_rgb(0.0, 0.0, 0.0);
-        }
-
-        pio_sm_put_blocking(pio0, 0, valor_led);
-    }
+    matriz_parar_animacao();
+    matriz_mostrar(SPRITE_X);
 }
-
-
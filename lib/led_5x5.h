@@ -1,3 +1,6 @@
+#ifndef LED_5X5_H
+#define LED_5X5_H
+
 #include "pico/stdlib.h"
 
 // NÚMERO DE LEDS
@@ -6,12 +9,33 @@
 // PINO DA MATRIZ DE LED
 #define OUT_PIN 7
 
+// Intervalo mínimo entre o início de dois quadros: 25 LEDs x 30 us + reset do WS2812
+#define MATRIZ_GUARDA_US 1100
+
+// Sequência de quadros GRB tocada por alarme
+typedef struct {
+    const uint32_t (*quadros)[NUM_PIXELS];
+    uint8_t num;
+    uint16_t periodo_ms; // Tempo de cada quadro
+    bool repetir;
+} animacao_t;
+
+extern const animacao_t ANIM_X_PISCANDO;
+extern const animacao_t ANIM_CHECK_PULSANDO;
+extern const animacao_t ANIM_VARREDURA;
+
 // FUNÇÕES
-void setup_PIO();
+void setup_PIO(alarm_pool_t *pool);
+uint32_t *matriz_quadro();
+void matriz_apresentar();
+void matriz_animar(const animacao_t *animacao);
+void matriz_parar_animacao();
 uint32_t matrix_rgb(double b, double r, double g);
 void drawMatrix(uint cor);
 void apagarMatriz();
 bool isCentroMatriz(int i);
 void desenharCorNaMatriz(float r, float g, float b);
 void desenhoCheck();
-void desenhoX();
\ No newline at end of file
+void desenhoX();
+
+#endif
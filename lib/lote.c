@@ -0,0 +1,57 @@
+#include "lote.h"
+
+void lote_init(lote_t *l, uint8_t capacidade, uint32_t prazo_ms) {
+    l->capacidade = capacidade ? capacidade : 1;
+    l->prazo_ms = prazo_ms;
+    lote_limpar(l);
+}
+
+void lote_limpar(lote_t *l) {
+    l->n = 0;
+    l->tamanho = LOTE_CABECALHO;
+}
+
+static void lote_varint(lote_t *l, uint32_t valor) {
+    while (valor >= 0x80) {
+        l->quadro[l->tamanho++] = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+    l->quadro[l->tamanho++] = (uint8_t)valor;
+}
+
+// Acrescenta uma amostra, já codificada. Retorna true quando o quadro deve ser enviado:
+// capacidade atingida ou sem espaço garantido para mais uma amostra.
+bool lote_adicionar(lote_t *l, uint32_t instante_ms, int16_t cm) {
+    if (l->n == 0) {
+        l->quadro[0] = LOTE_VERSAO;
+        l->quadro[2] = (uint8_t)instante_ms;
+        l->quadro[3] = (uint8_t)(instante_ms >> 8);
+        l->quadro[4] = (uint8_t)(instante_ms >> 16);
+        l->quadro[5] = (uint8_t)(instante_ms >> 24);
+        l->quadro[6] = (uint8_t)cm;
+        l->quadro[7] = (uint8_t)((uint16_t)cm >> 8);
+        l->primeiro_ms = instante_ms;
+    } else {
+        int32_t variacao = (int32_t)cm - l->ultima_cm;
+        lote_varint(l, instante_ms - l->ultimo_ms);
+        lote_varint(l, ((uint32_t)variacao << 1) ^ (uint32_t)(variacao >> 31)); // Zigzag: -1 -> 1, 1 -> 2
+    }
+    l->ultimo_ms = instante_ms;
+    l->ultima_cm = cm;
+    l->n++;
+    return l->n >= l->capacidade || l->n == LOTE_AMOSTRAS_MAX ||
+           l->tamanho + LOTE_AMOSTRA_MAX > LOTE_BYTES_MAX;
+}
+
+// Tempo até o prazo do quadro em formação (UINT32_MAX se estiver vazio)
+uint32_t lote_espera_ms(const lote_t *l, uint32_t agora_ms) {
+    if (l->n == 0) return UINT32_MAX;
+    uint32_t decorrido = agora_ms - l->primeiro_ms;
+    return decorrido >= l->prazo_ms ? 0 : l->prazo_ms - decorrido;
+}
+
+// Completa o cabeçalho e retorna o tamanho do quadro; lote_limpar começa o próximo
+uint16_t lote_fechar(lote_t *l) {
+    l->quadro[1] = l->n;
+    return l->tamanho;
+}
@@ -0,0 +1,40 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include "pico/stdlib.h"
+
+// Quadro binário com várias amostras de distância:
+//   [0]     versão (LOTE_VERSAO)
+//   [1]     número de amostras
+//   [2..5]  instante da primeira amostra (ms desde o boot, little endian)
+//   [6..7]  distância da primeira amostra (cm, int16 little endian)
+//   depois, para cada amostra seguinte: varint do intervalo desde a anterior (ms) e
+//   varint zigzag da variação da distância (cm)
+// Varint: 7 bits por byte, menos significativos primeiro, bit 7 indica que há mais bytes.
+#define LOTE_VERSAO 1
+#define LOTE_CABECALHO 8
+#define LOTE_AMOSTRA_MAX 8      // Pior caso de uma amostra: 5 bytes de intervalo e 3 de variação
+#define LOTE_BYTES_MAX 400      // Cabe em MQTT_OUTPUT_RINGBUF_SIZE junto com o cabeçalho
+#define LOTE_AMOSTRAS_MAX 255
+
+typedef struct {
+    uint8_t capacidade;         // Amostras por quadro
+    uint32_t prazo_ms;          // Tempo máximo da primeira amostra até o envio
+    uint8_t n;
+    uint32_t primeiro_ms, ultimo_ms;
+    int16_t ultima_cm;
+    uint16_t tamanho;
+    uint8_t quadro[LOTE_BYTES_MAX];
+} lote_t;
+
+void lote_init(lote_t *l, uint8_t capacidade, uint32_t prazo_ms);
+bool lote_adicionar(lote_t *l, uint32_t instante_ms, int16_t cm);
+uint32_t lote_espera_ms(const lote_t *l, uint32_t agora_ms);
+uint16_t lote_fechar(lote_t *l);
+void lote_limpar(lote_t *l);
+
+static inline bool lote_vazio(const lote_t *l) {
+    return l->n == 0;
+}
+
+#endif
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <string.h>
+#include "metricas.h"
+
+#if METRICAS_ATIVAS
+
+void metrica_init(metrica_t *m, const char *nome) {
+    m->nome = nome;
+    m->zerar = true;
+}
+
+// Registra uma duração; chamada só pelo núcleo dono da fase
+void metrica_registrar(metrica_t *m, uint32_t duracao_us) {
+    if (m->zerar) {
+        memset((void *)m->baldes, 0, sizeof(m->baldes));
+        m->contagem = 0;
+        m->min_us = UINT32_MAX;
+        m->max_us = 0;
+        m->zerar = false;
+    }
+
+    uint32_t balde = duracao_us ? 32 - __builtin_clz(duracao_us) : 0;
+    if (balde >= METRICAS_BALDES) balde = METRICAS_BALDES - 1;
+    m->baldes[balde]++;
+    m->contagem++;
+    if (duracao_us < m->min_us) m->min_us = duracao_us;
+    if (duracao_us > m->max_us) m->max_us = duracao_us;
+}
+
+// Limite superior do balde que contém o percentil pedido (em milésimos)
+static uint32_t metrica_percentil(const uint32_t *baldes, uint32_t contagem, uint32_t milesimos, uint32_t max_us) {
+    uint32_t alvo = (uint32_t)(((uint64_t)contagem * milesimos + 999) / 1000);
+    uint32_t acumulado = 0;
+    for (uint32_t i = 0; i < METRICAS_BALDES; i++) {
+        acumulado += baldes[i];
+        if (acumulado >= alvo) {
+            uint32_t limite = i ? (1u << i) - 1 : 0;
+            return limite < max_us ? limite : max_us;
+        }
+    }
+    return max_us;
+}
+
+// Copia a janela atual e pede ao dono que comece outra; false se não houve registro desde o último resumo
+bool metrica_resumo(metrica_t *m, metrica_resumo_t *r) {
+    if (m->zerar) return false;
+
+    uint32_t baldes[METRICAS_BALDES];
+    memcpy(baldes, (const void *)m->baldes, sizeof(baldes));
+    r->contagem = m->contagem;
+    r->min_us = m->min_us;
+    r->max_us = m->max_us;
+    m->zerar = true;
+
+    if (r->contagem == 0) return false;
+    r->p50_us = metrica_percentil(baldes, r->contagem, 500, r->max_us);
+    r->p99_us = metrica_percentil(baldes, r->contagem, 990, r->max_us);
+    return true;
+}
+
+// Formata as fases com registros como "nome:n,min,p50,p99,max;" (tempos em us)
+int metricas_formatar(metrica_t *metricas, uint8_t num, char *buf, size_t tam) {
+    size_t usado = 0;
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < num; i++) {
+        metrica_resumo_t r;
+        if (!metrica_resumo(&metricas[i], &r)) continue;
+
+        int n = snprintf(buf + usado, tam - usado, "%s:%u,%u,%u,%u,%u;", metricas[i].nome, (unsigned)r.contagem,
+                         (unsigned)r.min_us, (unsigned)r.p50_us, (unsigned)r.p99_us, (unsigned)r.max_us);
+        if (n < 0 || (size_t)n >= tam - usado) {
+            buf[usado] = '\0'; // Não cabe: publica as fases anteriores
+            break;
+        }
+        usado += n;
+    }
+    return (int)usado;
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include "pico/stdlib.h"
+
+// Defina METRICAS_ATIVAS como 0 (ex: target_compile_definitions) para remover toda a instrumentação
+#ifndef METRICAS_ATIVAS
+#define METRICAS_ATIVAS 1
+#endif
+
+// Baldes em potências de 2: o balde i conta durações em [2^(i-1), 2^i) us; o último acumula o resto
+#define METRICAS_BALDES 24
+
+// Histograma de durações de uma fase. Só o núcleo que executa a fase escreve nele.
+typedef struct {
+    const char *nome;
+    volatile uint32_t baldes[METRICAS_BALDES];
+    volatile uint32_t contagem;
+    volatile uint32_t min_us;
+    volatile uint32_t max_us;
+    volatile bool zerar; // Pedido do leitor: o dono zera antes do próximo registro
+} metrica_t;
+
+// Resumo de uma janela
+typedef struct {
+    uint32_t contagem;
+    uint32_t min_us;
+    uint32_t p50_us; // Limite superior do balde
+    uint32_t p99_us;
+    uint32_t max_us;
+} metrica_resumo_t;
+
+#if METRICAS_ATIVAS
+// Lê os 32 bits baixos do temporizador de 64 bits: um único acesso ao registrador
+#define METRICA_INICIO(var) uint32_t var = time_us_32()
+#define METRICA_REINICIAR(var) (var = time_us_32())
+#define METRICA_FIM(m, var) metrica_registrar((m), time_us_32() - (var))
+#define METRICA_REGISTRAR(m, duracao_us) metrica_registrar((m), (duracao_us))
+#else
+#define METRICA_INICIO(var)
+#define METRICA_REINICIAR(var)
+#define METRICA_FIM(m, var)
+#define METRICA_REGISTRAR(m, duracao_us)
+#endif
+
+void metrica_init(metrica_t *m, const char *nome);
+void metrica_registrar(metrica_t *m, uint32_t duracao_us);
+bool metrica_resumo(metrica_t *m, metrica_resumo_t *r);
+int metricas_formatar(metrica_t *metricas, uint8_t num, char *buf, size_t tam);
+
+#endif
@@ -0,0 +1,52 @@
+#include "nucleo.h"
+#include "hardware/sync.h"
+#include "hardware/structs/scb.h"
+
+// Deve ser chamada no núcleo que será medido
+void nucleo_uso_init(nucleo_uso_t *uso) {
+    uso->ocioso_us = 0;
+    uso->inicio_janela_us = time_us_64();
+    // Interrupções pendentes geram evento: o WFE acorda mesmo com elas mascaradas
+    scb_hw->scr |= M0PLUS_SCR_SEVONPEND_BITS;
+}
+
+// Dorme até a próxima interrupção ou __sev() do outro núcleo, contando o tempo ocioso.
+// As interrupções ficam mascaradas durante a medição para que o tempo gasto
+// nos tratadores não seja contado como ociosidade.
+void nucleo_ocioso(nucleo_uso_t *uso) {
+    uint32_t status = save_and_disable_interrupts();
+    uint64_t inicio = time_us_64();
+    __wfe();
+    uso->ocioso_us += time_us_64() - inicio;
+    restore_interrupts(status);
+}
+
+// Alarme usado só para acordar o núcleo: a interrupção pendente encerra o WFE
+static int64_t nucleo_acordar_cb(__unused alarm_id_t id, __unused void *dados) {
+    return 0;
+}
+
+// Dorme até o instante limite ou até o primeiro evento (interrupção ou __sev()).
+// O alarme deve ser de um pool que interrompe este núcleo.
+void nucleo_ocioso_ate(nucleo_uso_t *uso, alarm_pool_t *pool, absolute_time_t limite) {
+    if (is_at_the_end_of_time(limite)) {
+        nucleo_ocioso(uso);
+        return;
+    }
+    alarm_id_t alarme = alarm_pool_add_alarm_at(pool, limite, nucleo_acordar_cb, NULL, false);
+    if (alarme <= 0) return; // Já passou
+    nucleo_ocioso(uso);
+    alarm_pool_cancel_alarm(pool, alarme);
+}
+
+// Fração do tempo ocupado desde a última chamada (0 a 1)
+float nucleo_utilizacao(nucleo_uso_t *uso) {
+    uint64_t agora = time_us_64();
+    uint64_t janela = agora - uso->inicio_janela_us;
+    uint64_t ocioso = uso->ocioso_us;
+    if (janela == 0) return 0.0f;
+
+    uso->ocioso_us = 0;
+    uso->inicio_janela_us = agora;
+    return ocioso >= janela ? 0.0f : 1.0f - (float)ocioso / janela;
+}
@@ -0,0 +1,17 @@
+#ifndef NUCLEO_H
+#define NUCLEO_H
+
+#include "pico/stdlib.h"
+
+// Contadores de utilização de um núcleo
+typedef struct {
+    volatile uint64_t ocioso_us;  // Tempo dormindo em WFE na janela atual
+    uint64_t inicio_janela_us;
+} nucleo_uso_t;
+
+void nucleo_uso_init(nucleo_uso_t *uso);
+void nucleo_ocioso(nucleo_uso_t *uso);
+void nucleo_ocioso_ate(nucleo_uso_t *uso, alarm_pool_t *pool, absolute_time_t limite);
+float nucleo_utilizacao(nucleo_uso_t *uso);
+
+#endif
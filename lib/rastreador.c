@@ -0,0 +1,72 @@
+#include "rastreador.h"
+
+void rastreador_init(rastreador_t *r, float limiar_cm, uint32_t horizonte_ms) {
+    r->alfa = 0.5f;
+    r->beta = 0.1f;
+    r->limiar_cm = limiar_cm;
+    r->alcance_cm = limiar_cm + 120.0f;
+    r->vel_min = 15.0f;
+    r->horizonte_ms = horizonte_ms;
+    rastreador_reiniciar(r);
+}
+
+void rastreador_reiniciar(rastreador_t *r) {
+    r->iniciado = false;
+    r->distancia = 0.0f;
+    r->velocidade = 0.0f;
+    r->tempo_limiar_ms = RASTREADOR_SEM_PREVISAO;
+    r->previsto = false;
+}
+
+// Presença prevista ainda válida em instante_ms: sem medida há mais de RASTREADOR_INTERVALO_MAX_MS,
+// a estimativa é descartada em vez de manter a última previsão
+bool rastreador_vigente(rastreador_t *r, uint32_t instante_ms) {
+    if (r->iniciado && instante_ms - r->ultimo_ms > RASTREADOR_INTERVALO_MAX_MS) {
+        rastreador_reiniciar(r);
+    }
+    return r->previsto;
+}
+
+// Atualiza a estimativa com uma medida; retorna true quando a presença passa a ser prevista.
+// Usa apenas os instantes das amostras, então o resultado é o mesmo para o mesmo traço.
+bool rastreador_atualizar(rastreador_t *r, float medida_cm, uint32_t instante_ms) {
+    uint32_t dt_ms = instante_ms - r->ultimo_ms;
+
+    if (!r->iniciado || dt_ms > RASTREADOR_INTERVALO_MAX_MS) {
+        r->distancia = medida_cm;
+        r->velocidade = 0.0f;
+        r->ultimo_ms = instante_ms;
+        r->iniciado = true;
+        r->tempo_limiar_ms = RASTREADOR_SEM_PREVISAO;
+        r->previsto = medida_cm <= r->limiar_cm;
+        return false;
+    }
+    if (dt_ms == 0) return false;
+
+    // Predição e correção
+    float dt = dt_ms / 1000.0f;
+    float prevista = r->distancia + r->velocidade * dt;
+    float residuo = medida_cm - prevista;
+    r->distancia = prevista + r->alfa * residuo;
+    r->velocidade += (r->beta / dt) * residuo;
+    r->ultimo_ms = instante_ms;
+
+    // Tempo até cruzar o limiar na velocidade atual
+    if (r->distancia <= r->limiar_cm) {
+        r->tempo_limiar_ms = 0;
+    } else if (r->velocidade < -r->vel_min) {
+        r->tempo_limiar_ms = (uint32_t)((r->distancia - r->limiar_cm) / -r->velocidade * 1000.0f);
+    } else {
+        r->tempo_limiar_ms = RASTREADOR_SEM_PREVISAO;
+    }
+
+    bool anterior = r->previsto;
+    if (r->distancia <= r->limiar_cm) {
+        r->previsto = true;
+    } else if (r->distancia <= r->alcance_cm && r->tempo_limiar_ms <= r->horizonte_ms) {
+        r->previsto = true;
+    } else if (r->velocidade >= 0.0f || r->distancia > r->alcance_cm) {
+        r->previsto = false; // Alvo parou, recuou ou saiu do alcance
+    }
+    return r->previsto && !anterior;
+}
@@ -0,0 +1,33 @@
+#ifndef RASTREADOR_H
+#define RASTREADOR_H
+
+#include "pico/stdlib.h"
+
+// Valor de tempo até o limiar quando o alvo não está se aproximando
+#define RASTREADOR_SEM_PREVISAO UINT32_MAX
+
+// Intervalo máximo entre medidas antes de reiniciar a estimativa
+#define RASTREADOR_INTERVALO_MAX_MS 1000
+
+// Rastreador alfa-beta de um alvo em frente ao sensor
+typedef struct {
+    float alfa, beta;          // Ganhos de posição e velocidade
+    float distancia;           // Distância estimada (cm)
+    float velocidade;          // Velocidade estimada (cm/s, negativa = aproximando)
+    uint32_t ultimo_ms;        // Instante da última medida
+    bool iniciado;
+
+    float limiar_cm;           // Linha de presença
+    float alcance_cm;          // Só prevê presença para alvos mais perto que isso
+    float vel_min;             // Velocidade mínima de aproximação considerada (cm/s)
+    uint32_t horizonte_ms;     // Antecedência máxima do evento previsto
+    uint32_t tempo_limiar_ms;  // Tempo estimado até cruzar o limiar
+    bool previsto;             // Presença prevista ativa
+} rastreador_t;
+
+void rastreador_init(rastreador_t *r, float limiar_cm, uint32_t horizonte_ms);
+bool rastreador_atualizar(rastreador_t *r, float medida_cm, uint32_t instante_ms);
+void rastreador_reiniciar(rastreador_t *r);
+bool rastreador_vigente(rastreador_t *r, uint32_t instante_ms);
+
+#endif
@@ -0,0 +1,41 @@
+#include "reconexao.h"
+#include "pico/rand.h"
+
+void reconexao_init(reconexao_t *r, uint32_t min_ms, uint32_t max_ms) {
+    r->min_ms = min_ms;
+    r->max_ms = max_ms;
+    r->teto_ms = min_ms;
+    r->tentativas = 0;
+    r->caido = false;
+    r->queda_ms = 0;
+    r->quedas = 0;
+    r->recuperacao_ms = r->recuperacao_max_ms = 0;
+}
+
+// Espera até a próxima tentativa; cada chamada conta uma tentativa e dobra o teto
+uint32_t reconexao_espera_ms(reconexao_t *r) {
+    uint32_t metade = r->teto_ms / 2;
+    uint32_t espera = metade + get_rand_32() % (r->teto_ms - metade + 1);
+    r->teto_ms = r->teto_ms > r->max_ms / 2 ? r->max_ms : r->teto_ms * 2;
+    r->tentativas++;
+    return espera;
+}
+
+// Conexão perdida; chamadas repetidas antes do sucesso contam uma queda só
+void reconexao_queda(reconexao_t *r, uint32_t agora_ms) {
+    if (r->caido) return;
+    r->caido = true;
+    r->queda_ms = agora_ms;
+    r->quedas++;
+}
+
+// Conexão estabelecida: o recuo volta ao mínimo
+void reconexao_sucesso(reconexao_t *r, uint32_t agora_ms) {
+    if (r->caido) {
+        r->recuperacao_ms = agora_ms - r->queda_ms;
+        if (r->recuperacao_ms > r->recuperacao_max_ms) r->recuperacao_max_ms = r->recuperacao_ms;
+        r->caido = false;
+    }
+    r->teto_ms = r->min_ms;
+    r->tentativas = 0;
+}
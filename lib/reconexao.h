@@ -0,0 +1,26 @@
+#ifndef RECONEXAO_H
+#define RECONEXAO_H
+
+#include "pico/stdlib.h"
+
+// Espera entre tentativas de conexão com recuo exponencial e sorteio ("equal jitter"): a espera
+// fica entre metade e o total do teto, e o teto dobra a cada falha até o máximo. O sorteio
+// espalha as reconexões de vários dispositivos depois que o broker volta.
+typedef struct {
+    uint32_t min_ms, max_ms;
+    uint32_t teto_ms;
+    uint32_t tentativas;        // Desde a última conexão bem-sucedida
+
+    // Recuperação: da queda até a próxima conexão
+    bool caido;
+    uint32_t queda_ms;
+    uint32_t quedas;
+    uint32_t recuperacao_ms, recuperacao_max_ms;
+} reconexao_t;
+
+void reconexao_init(reconexao_t *r, uint32_t min_ms, uint32_t max_ms);
+uint32_t reconexao_espera_ms(reconexao_t *r);
+void reconexao_queda(reconexao_t *r, uint32_t agora_ms);
+void reconexao_sucesso(reconexao_t *r, uint32_t agora_ms);
+
+#endif
@@ -0,0 +1,181 @@
+#include <string.h>
+#include "saida.h"
+
+void saida_init(saida_t *s, const uint8_t qos[NUM_CLASSES_SAIDA], const uint8_t janela[NUM_CLASSES_SAIDA],
+                saida_publicar_fn publicar, void *dados) {
+    memset(s, 0, sizeof(*s));
+    memcpy(s->qos, qos, sizeof(s->qos));
+    memcpy(s->janela, janela, sizeof(s->janela));
+    s->publicar = publicar;
+    s->dados = dados;
+}
+
+// Tira a mensagem i e fecha o buraco do payload
+static void saida_remover(saida_t *s, uint8_t i) {
+    saida_msg_t *m = &s->msgs[i];
+    uint16_t fim = m->inicio + m->tamanho;
+    memmove(&s->bytes[m->inicio], &s->bytes[fim], s->usados - fim);
+    s->usados -= m->tamanho;
+    for (uint8_t j = 0; j < s->num; j++) {
+        if (s->msgs[j].inicio >= fim) s->msgs[j].inicio -= m->tamanho;
+    }
+    *m = s->msgs[--s->num];
+}
+
+// a chegou antes de b (a ordem dá a volta em 65536)
+static inline bool saida_antes(const saida_msg_t *a, const saida_msg_t *b) {
+    return (int16_t)(a->ordem - b->ordem) < 0;
+}
+
+// A classe ainda pode ter mais um envio sem confirmação
+static inline bool saida_janela_aberta(const saida_t *s, uint8_t classe) {
+    return !s->janela[classe] || s->pendentes[classe] < s->janela[classe];
+}
+
+// A próxima a sair: a mais antiga da classe mais urgente com a janela aberta
+static int saida_proxima(const saida_t *s) {
+    int melhor = -1;
+    for (uint8_t i = 0; i < s->num; i++) {
+        const saida_msg_t *m = &s->msgs[i];
+        if (!saida_janela_aberta(s, m->classe)) continue;
+        if (melhor < 0 || m->classe < s->msgs[melhor].classe ||
+            (m->classe == s->msgs[melhor].classe && saida_antes(m, &s->msgs[melhor]))) {
+            melhor = i;
+        }
+    }
+    return melhor;
+}
+
+// A primeira a ser descartada, se for de classe igual ou menos urgente que a recém-chegada
+static int saida_vitima(const saida_t *s, uint8_t classe) {
+    int vitima = -1;
+    for (uint8_t i = 0; i < s->num; i++) {
+        const saida_msg_t *m = &s->msgs[i];
+        if (m->classe < classe) continue;
+        if (vitima < 0 || m->classe > s->msgs[vitima].classe ||
+            (m->classe == s->msgs[vitima].classe && saida_antes(m, &s->msgs[vitima]))) {
+            vitima = i;
+        }
+    }
+    return vitima;
+}
+
+// Alguma mensagem de prioridade igual ou maior esperando
+static bool saida_esperando(const saida_t *s, uint8_t classe) {
+    for (uint8_t i = 0; i < s->num; i++) {
+        if (s->msgs[i].classe <= classe) return true;
+    }
+    return false;
+}
+
+// Entrega ao cliente e conta o envio na janela da classe
+static saida_resultado_t saida_entregar(saida_t *s, uint8_t classe, const char *topico, const void *payload,
+                                        uint16_t tamanho, bool retain) {
+    saida_resultado_t r = s->publicar(s->dados, (saida_classe_t)classe, topico, payload, tamanho, s->qos[classe], retain);
+    if (r == SAIDA_ENVIADA) {
+        s->enviadas++;
+        if (s->janela[classe]) s->pendentes[classe]++;
+    }
+    return r;
+}
+
+// Uma mensagem da classe iria direto ao cliente: nada de prioridade igual ou maior esperando
+// e a janela aberta. Quem gera mensagens sob demanda (o reenvio) só produz nesse caso.
+bool saida_livre(const saida_t *s, saida_classe_t classe) {
+    return !saida_esperando(s, classe) && saida_janela_aberta(s, classe);
+}
+
+// Para quem guarda as próprias mensagens e as produz sob demanda (o reenvio): entrega direto ao
+// cliente quando saida_livre, sem nunca guardar aqui. Retorna true se o cliente aceitou.
+bool saida_tentar(saida_t *s, saida_classe_t classe, const char *topico, const void *payload, uint16_t tamanho,
+                  bool retain) {
+    if (!saida_livre(s, classe)) return false;
+    saida_resultado_t r = saida_entregar(s, classe, topico, payload, tamanho, retain);
+    if (r == SAIDA_CHEIA) s->adiadas++;
+    if (r == SAIDA_ERRO) s->erros++;
+    return r == SAIDA_ENVIADA;
+}
+
+// O cliente concluiu uma requisição da classe: abre um lugar na janela
+void saida_confirmar(saida_t *s, saida_classe_t classe) {
+    if (s->pendentes[classe]) s->pendentes[classe]--;
+}
+
+// Nova conexão: as requisições da anterior não serão mais confirmadas
+void saida_reabrir(saida_t *s) {
+    memset(s->pendentes, 0, sizeof(s->pendentes));
+}
+
+// Retorna false se a mensagem foi descartada ou recusada
+bool saida_publicar(saida_t *s, saida_classe_t classe, const char *topico, const void *payload, uint16_t tamanho,
+                    bool retain, bool substituivel) {
+    uint16_t ordem = s->proxima_ordem;
+    bool substituiu = false;
+    if (substituivel) {
+        for (uint8_t i = 0; i < s->num; i++) {
+            if (s->msgs[i].substituivel && s->msgs[i].topico == topico) {
+                ordem = s->msgs[i].ordem;
+                saida_remover(s, i);
+                s->substituidas++;
+                substituiu = true;
+                break;
+            }
+        }
+    }
+
+    if (!substituiu && !saida_esperando(s, classe)) {
+        saida_resultado_t r = saida_janela_aberta(s, classe) ?
+                              saida_entregar(s, classe, topico, payload, tamanho, retain) : SAIDA_CHEIA;
+        if (r == SAIDA_ENVIADA) return true;
+        if (r == SAIDA_ERRO) {
+            s->erros++;
+            return false;
+        }
+        s->adiadas++;
+    }
+
+    if (tamanho > SAIDA_BYTES) {
+        s->descartadas[classe]++;
+        return false;
+    }
+    while (s->num == SAIDA_MAX || s->usados + tamanho > SAIDA_BYTES) {
+        int vitima = saida_vitima(s, classe);
+        if (vitima < 0) {
+            s->descartadas[classe]++; // Só há mensagens mais urgentes esperando
+            return false;
+        }
+        s->descartadas[s->msgs[vitima].classe]++;
+        saida_remover(s, (uint8_t)vitima);
+    }
+
+    saida_msg_t *m = &s->msgs[s->num++];
+    m->topico = topico;
+    m->inicio = s->usados;
+    m->tamanho = tamanho;
+    m->ordem = ordem;
+    m->classe = classe;
+    m->retain = retain;
+    m->substituivel = substituivel;
+    memcpy(&s->bytes[s->usados], payload, tamanho);
+    s->usados += tamanho;
+    if (!substituiu) s->proxima_ordem++;
+
+    if (s->num > s->num_max) s->num_max = s->num;
+    if (s->usados > s->usados_max) s->usados_max = s->usados;
+    return true;
+}
+
+// Entrega as mensagens que esperam, por prioridade, até o cliente ficar sem espaço.
+// Retorna true se o cliente recusou alguma por falta de espaço; as que esperam só por uma
+// janela cheia saem depois de saida_confirmar.
+bool saida_drenar(saida_t *s) {
+    int i;
+    while ((i = saida_proxima(s)) >= 0) {
+        const saida_msg_t *m = &s->msgs[i];
+        saida_resultado_t r = saida_entregar(s, m->classe, m->topico, &s->bytes[m->inicio], m->tamanho, m->retain);
+        if (r == SAIDA_CHEIA) return true;
+        if (r == SAIDA_ERRO) s->erros++;
+        saida_remover(s, (uint8_t)i);
+    }
+    return false;
+}
@@ -0,0 +1,84 @@
+#ifndef SAIDA_H
+#define SAIDA_H
+
+#include "pico/stdlib.h"
+
+#define SAIDA_MAX 16        // Mensagens esperando espaço no cliente MQTT
+#define SAIDA_BYTES 2048    // Soma dos payloads dessas mensagens
+
+// Classes de prioridade, da mais urgente para a menos
+typedef enum {
+    SAIDA_CONTROLE,     // Respostas a comandos
+    SAIDA_ESTADO,       // Mudanças de estado
+    SAIDA_TELEMETRIA,   // Distâncias e previsões
+    SAIDA_DIAGNOSTICO,  // Relatórios e métricas
+    SAIDA_REENVIO,      // Telemetria guardada durante a queda
+    NUM_CLASSES_SAIDA
+} saida_classe_t;
+
+typedef enum {
+    SAIDA_ENVIADA,
+    SAIDA_CHEIA,        // Sem espaço no cliente agora (ERR_MEM): tentar de novo depois
+    SAIDA_ERRO          // Recusada de vez
+} saida_resultado_t;
+
+// Entrega uma mensagem ao cliente MQTT. Numa classe com janela, o envio só é confirmado por
+// saida_confirmar, chamada quando o cliente conclui a requisição.
+typedef saida_resultado_t (*saida_publicar_fn)(void *dados, saida_classe_t classe, const char *topico,
+                                               const void *payload, uint16_t tamanho, uint8_t qos, bool retain);
+
+typedef struct {
+    const char *topico;         // Ponteiro do registro de tópicos: identifica o tópico
+    uint16_t inicio, tamanho;   // Payload em bytes[]
+    uint16_t ordem;             // Ordem de chegada dentro da classe
+    uint8_t classe;
+    bool retain, substituivel;
+} saida_msg_t;
+
+// Fila de saída com prioridade. Uma mensagem vai direto ao cliente quando não há outra de
+// prioridade igual ou maior esperando; se o cliente não tem espaço, ela espera aqui e sai por
+// saida_drenar, a mais urgente primeiro. Uma mensagem substituível troca a que ainda espera no
+// mesmo tópico, mantendo o lugar dela. Cheia, a fila descarta primeiro a mais antiga da classe
+// menos urgente. Uma classe com janela tem no máximo janela[classe] envios sem confirmação; as
+// outras mensagens dela esperam na fila.
+typedef struct {
+    saida_msg_t msgs[SAIDA_MAX];
+    uint8_t num;
+    uint16_t usados;
+    uint16_t proxima_ordem;
+    uint8_t bytes[SAIDA_BYTES];
+
+    uint8_t qos[NUM_CLASSES_SAIDA];
+    uint8_t janela[NUM_CLASSES_SAIDA];      // 0 = sem limite
+    uint8_t pendentes[NUM_CLASSES_SAIDA];   // Envios aguardando saida_confirmar
+    saida_publicar_fn publicar;
+    void *dados;
+
+    // Métricas
+    uint32_t enviadas, adiadas, substituidas, erros;
+    uint32_t descartadas[NUM_CLASSES_SAIDA];
+    uint8_t num_max;            // Maior ocupação desde o último saida_zerar_maximo
+    uint16_t usados_max;
+} saida_t;
+
+void saida_init(saida_t *s, const uint8_t qos[NUM_CLASSES_SAIDA], const uint8_t janela[NUM_CLASSES_SAIDA],
+                saida_publicar_fn publicar, void *dados);
+bool saida_publicar(saida_t *s, saida_classe_t classe, const char *topico, const void *payload, uint16_t tamanho,
+                    bool retain, bool substituivel);
+bool saida_drenar(saida_t *s);
+bool saida_livre(const saida_t *s, saida_classe_t classe);
+bool saida_tentar(saida_t *s, saida_classe_t classe, const char *topico, const void *payload, uint16_t tamanho,
+                  bool retain);
+void saida_confirmar(saida_t *s, saida_classe_t classe);
+void saida_reabrir(saida_t *s);
+
+static inline bool saida_vazia(const saida_t *s) {
+    return s->num == 0;
+}
+
+static inline void saida_zerar_maximo(saida_t *s) {
+    s->num_max = s->num;
+    s->usados_max = s->usados;
+}
+
+#endif
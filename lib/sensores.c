@@ -0,0 +1,127 @@
+#include "sensores.h"
+
+// Dispara o sensor seguinte da varredura depois do tempo de guarda
+static int64_t sensores_guarda_cb(__unused alarm_id_t id, void *dados) {
+    sensores_t *s = (sensores_t *)dados;
+    hcsr04_disparar(&s->sensor[s->proximo].hcsr04);
+    return 0;
+}
+
+// Fim de uma medição (interrupção do PIO)
+static void sensores_concluido(void *dados) {
+    sensores_t *s = (sensores_t *)dados;
+    if (s->ao_concluir) s->ao_concluir(s->dados_concluir);
+    if (s->modo != SENSORES_ENCADEADO || !s->varredura_ativa) return;
+
+    if (++s->proximo >= s->num) {
+        s->proximo = 0;
+        s->varredura_ativa = false;
+        return;
+    }
+    alarm_pool_add_alarm_in_us(s->pool, SENSORES_GUARDA_US, sensores_guarda_cb, s, true);
+}
+
+bool sensores_init(sensores_t *s, const sensor_pinos_t *pinos, uint8_t num, sensores_modo_t modo,
+                   alarm_pool_t *pool, filtro_modo_t filtro_modo, uint8_t janela, uint32_t idade_max_ms) {
+    if (num == 0 || num > SENSORES_MAX) return false;
+
+    s->num = num;
+    s->modo = modo;
+    s->pool = pool;
+    s->proximo = 0;
+    s->varredura_ativa = false;
+    s->leitura_proxima = 0;
+    s->ao_concluir = NULL;
+
+    for (uint8_t i = 0; i < num; i++) {
+        sensor_estado_t *sensor = &s->sensor[i];
+        if (!hcsr04_init(&sensor->hcsr04, pinos[i].trig_pin, pinos[i].echo_pin)) return false;
+        hcsr04_ao_concluir(&sensor->hcsr04, sensores_concluido, s);
+        filtro_init(&sensor->filtro, filtro_modo, janela, idade_max_ms);
+        sensor->distancia_cm = 400.0f;
+        sensor->instante_ms = 0;
+        sensor->falhas = 0;
+    }
+    return true;
+}
+
+// Chamada pelo escalonador: só um sensor mede por vez, então os ecos nunca se sobrepõem
+bool sensores_disparar(void *dados) {
+    sensores_t *s = (sensores_t *)dados;
+
+    if (s->modo == SENSORES_RODIZIO) {
+        uint8_t i = s->proximo;
+        if (!hcsr04_disparar(&s->sensor[i].hcsr04)) return false;
+        s->proximo = (i + 1) % s->num;
+        return true;
+    }
+
+    // Encadeado: ignora o disparo se a varredura anterior ainda não terminou
+    if (s->varredura_ativa &&
+        time_us_64() - s->inicio_varredura_us < (uint64_t)s->num * HCSR04_WATCHDOG_US) {
+        return false;
+    }
+    s->proximo = 0;
+    s->varredura_ativa = true;
+    s->inicio_varredura_us = time_us_64();
+    return hcsr04_disparar(&s->sensor[0].hcsr04);
+}
+
+// Registra uma função chamada (na interrupção) sempre que houver amostra nova para sensores_ler
+void sensores_ao_concluir(sensores_t *s, void (*fn)(void *dados), void *dados) {
+    s->dados_concluir = dados;
+    s->ao_concluir = fn;
+}
+
+// Retira a próxima amostra de qualquer sensor e aplica o filtro daquele sensor
+bool sensores_ler(sensores_t *s, sensores_leitura_t *leitura) {
+    hcsr04_amostra_t amostra;
+
+    for (uint8_t n = 0; n < s->num; n++) {
+        uint8_t i = s->leitura_proxima;
+        s->leitura_proxima = (i + 1) % s->num;
+
+        sensor_estado_t *sensor = &s->sensor[i];
+        while (hcsr04_ler(&sensor->hcsr04, &amostra)) {
+            uint32_t cm = hcsr04_eco_para_cm(amostra.eco_us);
+
+            leitura->indice = i;
+            leitura->instante_ms = amostra.instante_us / 1000;
+            leitura->duracao_us = amostra.valida ? amostra.eco_us : HCSR04_TIMEOUT_US;
+            // Só aceita leituras válidas (entre 2 e 400 cm)
+            leitura->valida = amostra.valida && cm >= 2 && cm <= 400;
+
+            if (leitura->valida) {
+                sensor->falhas = 0;
+            } else if (++sensor->falhas >= SENSORES_FALHAS_MAX) {
+                cm = 400; // Valor padrão para "muito longe"
+            } else {
+                continue;
+            }
+
+            leitura->bruta_cm = cm;
+            leitura->filtrada_cm = filtro_inserir(&sensor->filtro, cm, leitura->instante_ms);
+            sensor->distancia_cm = leitura->filtrada_cm;
+            sensor->instante_ms = leitura->instante_ms;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Fusão: objeto mais próximo entre os sensores com leitura recente
+float sensores_mais_proxima(const sensores_t *s, uint32_t agora_ms, uint8_t *indice) {
+    float menor = 400.0f;
+    uint8_t escolhido = 0;
+
+    for (uint8_t i = 0; i < s->num; i++) {
+        const sensor_estado_t *sensor = &s->sensor[i];
+        if (agora_ms - sensor->instante_ms > SENSORES_VALIDADE_MS) continue;
+        if (sensor->distancia_cm < menor) {
+            menor = sensor->distancia_cm;
+            escolhido = i;
+        }
+    }
+    if (indice) *indice = escolhido;
+    return menor;
+}
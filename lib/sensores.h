@@ -0,0 +1,72 @@
+#ifndef SENSORES_H
+#define SENSORES_H
+
+#include "pico/stdlib.h"
+#include "hcSR04.h"
+#include "filtro.h"
+
+// Número máximo de sensores no conjunto (uma máquina de estados do PIO por sensor)
+#define SENSORES_MAX 4
+
+// Intervalo entre o fim de um eco e o disparo do próximo sensor (reverberação)
+#define SENSORES_GUARDA_US 10000
+
+// Leituras sem eco válido antes de considerar o sensor "muito longe"
+#define SENSORES_FALHAS_MAX 3
+
+// Leitura mais antiga que isso não participa da fusão
+#define SENSORES_VALIDADE_MS 1000
+
+// Ordem de disparo
+typedef enum {
+    SENSORES_RODIZIO,  // Cada disparo do escalonador mede o próximo sensor
+    SENSORES_ENCADEADO // Cada disparo inicia uma varredura; o fim de um eco dispara o próximo sensor
+} sensores_modo_t;
+
+// Pinos de um sensor
+typedef struct {
+    uint trig_pin;
+    uint echo_pin;
+} sensor_pinos_t;
+
+// Estado de cada sensor do conjunto
+typedef struct {
+    hcsr04_t hcsr04;
+    filtro_t filtro;
+    float distancia_cm;    // Último valor filtrado
+    uint32_t instante_ms;  // Instante da última leitura aceita
+    int falhas;
+} sensor_estado_t;
+
+// Leitura devolvida por sensores_ler
+typedef struct {
+    uint8_t indice;        // Sensor de origem
+    uint32_t instante_ms;
+    uint32_t duracao_us;   // Tempo em que o sensor ficou medindo
+    uint32_t bruta_cm;     // Leitura sem filtro (400 = muito longe)
+    bool valida;           // Eco dentro de 2-400 cm
+    float filtrada_cm;
+} sensores_leitura_t;
+
+// Conjunto de sensores com disparo escalonado, sem sobreposição de ecos
+typedef struct {
+    sensor_estado_t sensor[SENSORES_MAX];
+    uint8_t num;
+    sensores_modo_t modo;
+    alarm_pool_t *pool;
+    volatile uint8_t proximo;          // Próximo sensor a disparar
+    volatile bool varredura_ativa;
+    volatile uint64_t inicio_varredura_us;
+    uint8_t leitura_proxima;           // Próximo sensor a ser lido (justiça entre buffers)
+    void (*ao_concluir)(void *dados);  // Chamada na interrupção a cada medição de qualquer sensor
+    void *dados_concluir;
+} sensores_t;
+
+bool sensores_init(sensores_t *s, const sensor_pinos_t *pinos, uint8_t num, sensores_modo_t modo,
+                   alarm_pool_t *pool, filtro_modo_t filtro_modo, uint8_t janela, uint32_t idade_max_ms);
+bool sensores_disparar(void *dados);
+bool sensores_ler(sensores_t *s, sensores_leitura_t *leitura);
+void sensores_ao_concluir(sensores_t *s, void (*fn)(void *dados), void *dados);
+float sensores_mais_proxima(const sensores_t *s, uint32_t agora_ms, uint8_t *indice);
+
+#endif
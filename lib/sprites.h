@@ -0,0 +1,72 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include "led_5x5.h"
+
+// Quadros da matriz como palavras GRB prontas para o PIO, montadas pelo compilador.
+// Incluído só por led_5x5.c: os dados ficam na flash e não são recalculados em execução.
+
+// Cor no formato do ws2812.pio (24 bits alinhados à esquerda), componentes de 0 a 255
+#define GRB(r, g, b) (((uint32_t)(g) << 24) | ((uint32_t)(r) << 16) | ((uint32_t)(b) << 8))
+
+// O LED 0 fica no canto inferior direito e as linhas alternam de sentido (serpentina).
+// Os sprites são escritos como vistos, linha de cima primeiro; as macros reordenam.
+#define LINHA(a, b, c, d, e) a, b, c, d, e
+#define LINHA_INV(a, b, c, d, e) e, d, c, b, a
+#define SPRITE(l0, l1, l2, l3, l4) { LINHA_INV l4, LINHA l3, LINHA_INV l2, LINHA l1, LINHA_INV l0 }
+
+// Cores
+#define AP 0 // Apagado
+#define VM GRB(51, 0, 0)  // Vermelho 20%
+#define V1 GRB(0, 1, 0)   // Verde, níveis do pulso
+#define V2 GRB(0, 2, 0)   // Verde 1%
+#define V3 GRB(0, 4, 0)
+
+#define FORMA_X(c) SPRITE( \
+    (AP, AP, AP, AP, AP), \
+    (AP, c,  AP, c,  AP), \
+    (AP, AP, c,  AP, AP), \
+    (AP, c,  AP, c,  AP), \
+    (AP, AP, AP, AP, AP))
+
+#define FORMA_CHECK(c) SPRITE( \
+    (AP, AP, AP, AP, AP), \
+    (AP, AP, AP, AP, c ), \
+    (AP, AP, AP, c,  AP), \
+    (c,  AP, c,  AP, AP), \
+    (AP, c,  AP, AP, AP))
+
+static const uint32_t SPRITE_APAGADO[NUM_PIXELS] = { 0 };
+static const uint32_t SPRITE_X[NUM_PIXELS] = FORMA_X(VM);
+static const uint32_t SPRITE_CHECK[NUM_PIXELS] = FORMA_CHECK(V2);
+
+// Pisca: X aceso e apagado
+static const uint32_t QUADROS_X_PISCANDO[][NUM_PIXELS] = {
+    FORMA_X(VM),
+    { 0 },
+};
+
+// Pulso: o check sobe e desce de brilho
+static const uint32_t QUADROS_CHECK_PULSANDO[][NUM_PIXELS] = {
+    FORMA_CHECK(V1),
+    FORMA_CHECK(V2),
+    FORMA_CHECK(V3),
+    FORMA_CHECK(V2),
+};
+
+// Rolagem: uma coluna vermelha atravessa a matriz da esquerda para a direita
+static const uint32_t QUADROS_VARREDURA[][NUM_PIXELS] = {
+    SPRITE((VM, AP, AP, AP, AP), (VM, AP, AP, AP, AP), (VM, AP, AP, AP, AP), (VM, AP, AP, AP, AP), (VM, AP, AP, AP, AP)),
+    SPRITE((AP, VM, AP, AP, AP), (AP, VM, AP, AP, AP), (AP, VM, AP, AP, AP), (AP, VM, AP, AP, AP), (AP, VM, AP, AP, AP)),
+    SPRITE((AP, AP, VM, AP, AP), (AP, AP, VM, AP, AP), (AP, AP, VM, AP, AP), (AP, AP, VM, AP, AP), (AP, AP, VM, AP, AP)),
+    SPRITE((AP, AP, AP, VM, AP), (AP, AP, AP, VM, AP), (AP, AP, AP, VM, AP), (AP, AP, AP, VM, AP), (AP, AP, AP, VM, AP)),
+    SPRITE((AP, AP, AP, AP, VM), (AP, AP, AP, AP, VM), (AP, AP, AP, AP, VM), (AP, AP, AP, AP, VM), (AP, AP, AP, AP, VM)),
+};
+
+#undef AP
+#undef VM
+#undef V1
+#undef V2
+#undef V3
+
+#endif
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
@@ -21,13 +22,29 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->address = address;
   ssd->i2c_port = i2c;
   ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  // Os pixels começam em endereço múltiplo de 8: cada coluna vira uma palavra de 64 bits
+  uint8_t *memoria = calloc(ssd->bufsize + 7, sizeof(uint8_t));
+  ssd->ram_buffer = memoria + 7;
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->espelho = calloc(ssd->bufsize - 1, sizeof(uint8_t));
+  ssd->tx_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->tx_buffer[0] = 0x40;
+  ssd->espelho_valido = false;
+  ssd->bytes_enviados = 0;
+  ssd->quadros_enviados = 0;
+  ssd->quadros_iguais = 0;
+  ssd->inicio_janela_us = time_us_64();
+  ssd->dma = NULL;
+  ssd->envio_pendente = false;
+  ssd->falhas_seguidas = 0;
+  ssd->rolagem_ativa = ssd->rolagem_no_painel = ssd->rolagem_pendente = false;
+  ssd->rolagem_passos = 0;
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
   ssd1306_command(ssd, SET_DISP | 0x00);
+  ssd1306_command(ssd, SET_SCROLL_OFF); // O painel pode ter ficado rolando antes de um reset
   ssd1306_command(ssd, SET_MEM_ADDR);
   ssd1306_command(ssd, 0x01);
   ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
@@ -54,6 +71,7 @@ void ssd1306_config(ssd1306_t *ssd) {
   ssd1306_command(ssd, SET_DISP | 0x01);
 }
 
+// Bloqueante; com DMA só pode ser usada com o transporte livre
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
@@ -65,23 +83,263 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
+// Comandos numa única transação: controle 0x00 seguido dos bytes de comando
+static void ssd1306_enviar_comandos(ssd1306_t *ssd, const uint8_t *comandos, size_t n) {
+  if (ssd->dma) {
+    i2c_dma_nova_transacao(ssd->dma);
+    i2c_dma_escrever(ssd->dma, comandos, n);
+  } else {
+    i2c_write_blocking(ssd->i2c_port, ssd->address, comandos, n, false);
+  }
+  ssd->bytes_enviados += n + 1;
+}
+
+// Envia uma janela (colunas x0..x1, páginas p0..p1) e atualiza o espelho.
+// No endereçamento vertical os bytes vão coluna a coluna, de p0 a p1 em cada coluna.
+// Com DMA a janela só é acrescentada à sequência, que sai inteira ao fim de ssd1306_send_data.
+static void ssd1306_enviar_janela(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  uint8_t comandos[] = { 0x00, SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1 };
+  ssd1306_enviar_comandos(ssd, comandos, sizeof(comandos));
+
+  size_t n = 1;
+  uint8_t altura = p1 - p0 + 1;
+  for (uint8_t x = x0; x <= x1; ++x) {
+    uint16_t base = x * ssd->pages + p0;
+    memcpy(&ssd->tx_buffer[n], &ssd->ram_buffer[base + 1], altura);
+    memcpy(&ssd->espelho[base], &ssd->ram_buffer[base + 1], altura);
+    n += altura;
+  }
+
+  if (ssd->dma) {
+    i2c_dma_nova_transacao(ssd->dma);
+    i2c_dma_escrever(ssd->dma, ssd->tx_buffer, n);
+  } else {
+    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->tx_buffer, n, false);
+  }
+  ssd->bytes_enviados += n + 1;
+}
+
+// Com DMA, entrega a sequência montada; se ela não couber, o painel fica desconhecido
+static void ssd1306_disparar(ssd1306_t *ssd) {
+  if (ssd->dma && !i2c_dma_enviar(ssd->dma, ssd->address)) {
+    ssd->espelho_valido = false;
+  }
+}
+
+// Passos que o painel deu desde a última ativação da rolagem (ou da última contagem)
+static uint16_t ssd1306_contar_passos(ssd1306_t *ssd) {
+  if (!ssd->rolagem_no_painel) return 0;
+  uint64_t agora = time_us_64();
+  if (agora <= ssd->rolagem_inicio_us) return 0;
+  uint16_t passos = (agora - ssd->rolagem_inicio_us) / ssd->rolagem_passo_us;
+  ssd->rolagem_inicio_us += (uint64_t)passos * ssd->rolagem_passo_us;
+  return passos;
+}
+
+// Envia só as regiões que mudaram desde o último envio; quadro igual não gera tráfego.
+// Com DMA retorna sem esperar; se ainda houver um quadro em trânsito o envio fica pendente.
+// Com a rolagem ativa a RAM do painel não pode ser escrita: a sequência começa desligando a
+// rolagem e termina religando, e os passos dados nesse meio tempo ficam contados.
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  if (ssd->dma) {
+    if (!i2c_dma_livre(ssd->dma)) {
+      ssd->envio_pendente = true;
+      return;
+    }
+    i2c_dma_comecar(ssd->dma);
+  }
+
+  // Janelas a enviar: o quadro inteiro, ou as faixas alteradas de cada página
+  uint8_t janelas = 0;
+  uint8_t jx0[8], jx1[8], jp0[8], jp1[8];
+  if (!ssd->espelho_valido) {
+    jx0[0] = 0;
+    jx1[0] = ssd->width - 1;
+    jp0[0] = 0;
+    jp1[0] = ssd->pages - 1;
+    janelas = 1;
+    ssd->espelho_valido = true;
+  } else {
+    uint8_t x_min[8], x_max[8];
+    bool sujo[8] = { false };
+    for (uint8_t x = 0; x < ssd->width; ++x) {
+      if (*ssd1306_coluna(ssd, x) == *(const uint64_t *)&ssd->espelho[x << 3]) continue; // Coluna inteira igual
+      const uint8_t *atual = &ssd->ram_buffer[x * ssd->pages + 1];
+      const uint8_t *painel = &ssd->espelho[x * ssd->pages];
+      for (uint8_t p = 0; p < ssd->pages; ++p) {
+        if (atual[p] == painel[p]) continue;
+        if (!sujo[p]) {
+          sujo[p] = true;
+          x_min[p] = x;
+        }
+        x_max[p] = x;
+      }
+    }
+
+    // Junta páginas vizinhas numa só janela quando isso custa menos bytes que janelas separadas
+    for (uint8_t p = 0; p < ssd->pages; ++p) {
+      if (!sujo[p]) continue;
+      if (janelas > 0) {
+        uint8_t j = janelas - 1;
+        uint8_t mx0 = x_min[p] < jx0[j] ? x_min[p] : jx0[j];
+        uint8_t mx1 = x_max[p] > jx1[j] ? x_max[p] : jx1[j];
+        uint32_t custo_junto = (uint32_t)(mx1 - mx0 + 1) * (p - jp0[j] + 1);
+        uint32_t custo_separado = (uint32_t)(jx1[j] - jx0[j] + 1) * (jp1[j] - jp0[j] + 1) +
+                                  (x_max[p] - x_min[p] + 1) + SSD1306_CUSTO_JANELA;
+        if (custo_junto <= custo_separado) {
+          jx0[j] = mx0;
+          jx1[j] = mx1;
+          jp1[j] = p;
+          continue;
+        }
+      }
+      jx0[janelas] = x_min[p];
+      jx1[janelas] = x_max[p];
+      jp0[janelas] = jp1[janelas] = p;
+      janelas++;
+    }
+  }
+
+  if (janelas == 0 && !ssd->rolagem_pendente) {
+    ssd->quadros_iguais++;
+    return;
+  }
+
+  if (ssd->rolagem_no_painel) {
+    ssd->rolagem_passos += ssd1306_contar_passos(ssd);
+    const uint8_t desligar[] = { 0x00, SET_SCROLL_OFF };
+    ssd1306_enviar_comandos(ssd, desligar, sizeof(desligar));
+  }
+  for (uint8_t j = 0; j < janelas; ++j) {
+    ssd1306_enviar_janela(ssd, jx0[j], jx1[j], jp0[j], jp1[j]);
+  }
+  if (ssd->rolagem_ativa) {
+    const uint8_t ligar[] = { 0x00, SET_SCROLL_LEFT, 0x00, ssd->rolagem_p0, ssd->rolagem_intervalo,
+                              ssd->rolagem_p1, 0x00, 0xFF, SET_SCROLL_ON };
+    ssd1306_enviar_comandos(ssd, ligar, sizeof(ligar));
+  }
+  ssd->rolagem_no_painel = ssd->rolagem_ativa;
+  ssd->rolagem_pendente = false;
+
+  if (janelas > 0) ssd->quadros_enviados++;
+  ssd1306_disparar(ssd);
+
+  // A rolagem recomeça quando o último byte sai: com DMA, depois do tempo de transmissão
+  ssd->rolagem_inicio_us = time_us_64();
+  if (ssd->dma) {
+    ssd->rolagem_inicio_us += (uint64_t)ssd->dma->num * 9 * 1000000 / ssd->dma->baudrate;
+  }
+}
+
+// Liga a rolagem horizontal por hardware das páginas p0..p1, para a esquerda, um passo a cada
+// intervalo (código de 3 bits do comando 0x27). Passa a valer no próximo ssd1306_send_data.
+void ssd1306_rolagem(ssd1306_t *ssd, uint8_t p0, uint8_t p1, uint8_t intervalo) {
+  // Quadros por passo de cada código de intervalo (datasheet do SSD1306)
+  static const uint16_t quadros[8] = { 5, 64, 128, 256, 3, 4, 25, 2 };
+  ssd->rolagem_p0 = p0;
+  ssd->rolagem_p1 = p1;
+  ssd->rolagem_intervalo = intervalo & 0x07;
+  ssd->rolagem_passo_us = quadros[ssd->rolagem_intervalo] * SSD1306_QUADRO_US;
+  ssd->rolagem_ativa = true;
+  ssd->rolagem_pendente = true;
+}
+
+// Desliga a rolagem no próximo envio
+void ssd1306_parar_rolagem(ssd1306_t *ssd) {
+  ssd->rolagem_ativa = false;
+  ssd->rolagem_pendente = ssd->rolagem_no_painel;
+}
+
+// Gira as páginas p0..p1 de um buffer (colunas de 8 bytes) n colunas para a esquerda
+static void ssd1306_girar(uint8_t *buffer, uint8_t largura, uint8_t p0, uint8_t p1, uint8_t n) {
+  uint8_t linha[128];
+  for (uint8_t p = p0; p <= p1; ++p) {
+    for (uint8_t x = 0; x < largura; ++x) linha[x] = buffer[(x << 3) + p];
+    for (uint8_t x = 0; x < largura; ++x) buffer[(x << 3) + p] = linha[(x + n) % largura];
+  }
+}
+
+// Aplica ao buffer e ao espelho os passos que o painel já deu, para que os dois continuem
+// iguais ao que está na tela. Retorna quantas colunas entraram pela direita.
+uint8_t ssd1306_rolagem_sincronizar(ssd1306_t *ssd) {
+  uint32_t passos = ssd->rolagem_passos + ssd1306_contar_passos(ssd);
+  ssd->rolagem_passos = 0;
+  if (passos == 0) return 0;
+
+  uint8_t n = passos % ssd->width;
+  if (n) {
+    ssd1306_girar(&ssd->ram_buffer[1], ssd->width, ssd->rolagem_p0, ssd->rolagem_p1, n);
+    ssd1306_girar(ssd->espelho, ssd->width, ssd->rolagem_p0, ssd->rolagem_p1, n);
+  }
+  return passos > ssd->width ? ssd->width : passos;
+}
+
+// Microssegundos até o painel terminar o passo de rolagem em andamento (0 sem rolagem no painel)
+uint32_t ssd1306_rolagem_restante_us(ssd1306_t *ssd) {
+  if (!ssd->rolagem_no_painel) return 0;
+  uint64_t agora = time_us_64();
+  if (agora < ssd->rolagem_inicio_us) return ssd->rolagem_inicio_us - agora + ssd->rolagem_passo_us;
+  return ssd->rolagem_passo_us - (agora - ssd->rolagem_inicio_us) % ssd->rolagem_passo_us;
+}
+
+// Marca as páginas p0..p1 como diferentes do painel: o próximo envio as reescreve inteiras
+void ssd1306_invalidar_paginas(ssd1306_t *ssd, uint8_t p0, uint8_t p1) {
+  for (uint8_t x = 0; x < ssd->width; ++x) {
+    for (uint8_t p = p0; p <= p1; ++p) {
+      ssd->espelho[(x << 3) + p] = ~ssd->ram_buffer[(x << 3) + p + 1];
+    }
+  }
+}
+
+// Passa a enviar pelo transporte DMA (depois de setup_ssd1306, que usa o envio bloqueante)
+void ssd1306_usar_dma(ssd1306_t *ssd, i2c_dma_t *dma) {
+  ssd->dma = dma;
+}
+
+// Chamada fora da interrupção depois que o transporte sinaliza o fim de um quadro:
+// trata falhas do barramento e envia o quadro que ficou pendente
+void ssd1306_envio_concluido(ssd1306_t *ssd) {
+  if (!ssd->dma) return;
+  if (ssd->dma->resultado != I2C_DMA_OK) {
+    ssd->espelho_valido = false; // O painel recebeu só parte do quadro
+    if (++ssd->falhas_seguidas > SSD1306_TENTATIVAS) {
+      ssd->envio_pendente = false; // Desiste até o próximo desenho
+      return;
+    }
+    ssd->envio_pendente = true;
+  } else {
+    ssd->falhas_seguidas = 0;
+  }
+
+  if (ssd->envio_pendente) {
+    ssd->envio_pendente = false;
+    ssd1306_send_data(ssd);
+  }
+}
+
+// Força o próximo envio a ser completo (ex: depois de reconfigurar o painel)
+void ssd1306_invalidar(ssd1306_t *ssd) {
+  ssd->espelho_valido = false;
+}
+
+// Bytes por segundo no barramento e quadros enviados/ignorados desde a última chamada
+void ssd1306_estatisticas(ssd1306_t *ssd, uint32_t *bytes_por_s, uint32_t *quadros, uint32_t *iguais) {
+  uint64_t agora = time_us_64();
+  uint64_t janela = agora - ssd->inicio_janela_us;
+  if (janela == 0) janela = 1;
+
+  *bytes_por_s = (uint32_t)(ssd->bytes_enviados * 1000000ull / janela);
+  *quadros = ssd->quadros_enviados;
+  *iguais = ssd->quadros_iguais;
+
+  ssd->bytes_enviados = 0;
+  ssd->quadros_enviados = 0;
+  ssd->quadros_iguais = 0;
+  ssd->inicio_janela_us = agora;
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height) return; // Fora da tela
   uint16_t index = (y >> 3) + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
   if (value)
@@ -90,54 +348,72 @@ void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
+// Aplica a origem (já limitada à máscara) a n colunas seguidas; o modo é testado uma vez só
+static void ssd1306_aplicar_colunas(uint64_t *coluna, uint8_t n, uint64_t mascara, uint64_t origem, ssd1306_modo_t modo) {
+  switch (modo) {
+    case SSD1306_COPIAR:
+      for (uint8_t i = 0; i < n; ++i) coluna[i] = (coluna[i] & ~mascara) | origem;
+      break;
+    case SSD1306_OU:
+      for (uint8_t i = 0; i < n; ++i) coluna[i] |= origem;
+      break;
+    case SSD1306_E:
+      for (uint8_t i = 0; i < n; ++i) coluna[i] &= ~mascara | origem;
+      break;
+    case SSD1306_OU_EXCLUSIVO:
+      for (uint8_t i = 0; i < n; ++i) coluna[i] ^= origem;
+      break;
+  }
+}
+
+// Retângulo cheio com recorte: a mesma palavra de 64 bits é aplicada a cada coluna
+void ssd1306_preencher(ssd1306_t *ssd, int16_t x, int16_t y, int16_t largura, int16_t altura, bool valor, ssd1306_modo_t modo) {
+  if (largura <= 0 || altura <= 0) return;
+  int16_t x0 = x < 0 ? 0 : x, y0 = y < 0 ? 0 : y;
+  int16_t x1 = x + largura - 1, y1 = y + altura - 1;
+  if (x1 >= ssd->width) x1 = ssd->width - 1;
+  if (y1 >= ssd->height) y1 = ssd->height - 1;
+  if (x0 > x1 || y0 > y1) return;
+
+  uint64_t mascara = ssd1306_mascara(y0, y1);
+  ssd1306_aplicar_colunas(ssd1306_coluna(ssd, x0), x1 - x0 + 1, mascara, valor ? mascara : 0, modo);
+}
+
 void setup_ssd1306(ssd1306_t *ssd, uint8_t endereco, i2c_inst_t *I2C_PORT)
 {
     ssd1306_init(ssd, WIDTH, HEIGHT, false, endereco, I2C_PORT); // Inicializa o display
     ssd1306_config(ssd);                                         // Configura o display
-    ssd1306_send_data(ssd);                                      // Envia os dados para o display
     ssd1306_fill(ssd, false);                                    // Limpa o display. O display inicia com todos os pixels apagados.
-    ssd1306_send_data(ssd);                                      // Atualiza display
+    ssd1306_send_data(ssd);                                      // Primeiro envio é completo: o conteúdo do painel é desconhecido
 }
 
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
-
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  memset(&ssd->ram_buffer[1], value ? 0xFF : 0x00, ssd->bufsize - 1);
 }
 
-
-
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
-
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    ssd1306_preencher(ssd, left, top, width, height, value, SSD1306_COPIAR);
+    return;
   }
+  ssd1306_preencher(ssd, left, top, width, 1, value, SSD1306_COPIAR);
+  ssd1306_preencher(ssd, left, top + height - 1, width, 1, value, SSD1306_COPIAR);
+  ssd1306_preencher(ssd, left, top, 1, height, value, SSD1306_COPIAR);
+  ssd1306_preencher(ssd, left + width - 1, top, 1, height, value, SSD1306_COPIAR);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Linhas horizontais e verticais viram faixas
+    if (y0 == y1) {
+        ssd1306_hline(ssd, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0, y0, value);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306_vline(ssd, x0, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -167,13 +443,13 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x1 < x0) return;
+  ssd1306_preencher(ssd, x0, y, x1 - x0 + 1, 1, value, SSD1306_COPIAR);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y1 < y0) return;
+  ssd1306_preencher(ssd, x, y0, 1, y1 - y0 + 1, value, SSD1306_COPIAR);
 }
 
 // Função para desenhar um caractere
@@ -192,13 +468,22 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
     index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
   }
 
-  // Desenha o caractere na tela
+  // As colunas do glifo já estão no formato das páginas: um byte por coluna
+  const uint8_t *glifo = &font[index];
+  if (y >= ssd->height) return;
+  uint8_t pagina = y >> 3;
+  uint64_t mascara = (uint64_t)0xFF << y; // Recorta embaixo: bits além do 63 se perdem
   for (uint8_t i = 0; i < 8; ++i)
   {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
+    uint16_t coluna = x + i;
+    if (coluna >= ssd->width) break;
+    if ((y & 0b111) == 0)
+    {
+      ssd->ram_buffer[(coluna << 3) + pagina + 1] = glifo[i]; // Alinhado à página: escrita direta
+    }
+    else
     {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
+      ssd1306_aplicar_colunas(ssd1306_coluna(ssd, coluna), 1, mascara, ((uint64_t)glifo[i] << y) & mascara, SSD1306_COPIAR);
     }
   }
 }
@@ -224,8 +509,8 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 }
 
 bool ssd1306_is_empty(ssd1306_t *ssd) {
-  for (uint16_t i = 1; i < ssd->bufsize; ++i) {
-      if (ssd->ram_buffer[i] != 0x00) {
+  for (uint8_t x = 0; x < ssd->width; ++x) {
+      if (*ssd1306_coluna(ssd, x) != 0) {
           return false; // Encontrou pelo menos um pixel aceso
       }
   }
@@ -233,21 +518,14 @@ bool ssd1306_is_empty(ssd1306_t *ssd) {
 }
 
 void draw_filled_square(ssd1306_t *ssd, uint8_t x, uint8_t y) {
-  for (uint8_t i = 0; i < 8; i++) {
-      for (uint8_t j = 0; j < 8; j++) {
-          ssd1306_pixel(ssd, x + j, y + i, true); // Desenha um pixel
-      }
-  }
+  ssd1306_preencher(ssd, x, y, 8, 8, true, SSD1306_COPIAR);
   ssd1306_send_data(ssd); // Atualiza o display
 }
 
 // Desenha o bitmap (a ser fornecido em display_oled.c) no display
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-  for (int i = 0; i < ssd->bufsize - 1; i++) {
-      ssd->ram_buffer[i + 1] = bitmap[i];
-
-      ssd1306_send_data(ssd);
-  }
+  memcpy(&ssd->ram_buffer[1], bitmap, ssd->bufsize - 1);
+  ssd1306_send_data(ssd);
 }
 
 void drawImage(ssd1306_t *ssd, const uint32_t desenho[8192]) {
@@ -263,5 +541,67 @@ void drawImage(ssd1306_t *ssd, const uint32_t desenho[8192]) {
       }
     }
   }
-  ssd1306_send_data(ssd); // Atualiza o display
-}
\ No newline at end of file
+}
+
+// Leitura sequencial dos bytes de um bitmap, com ou sem RLE.
+// No RLE, o controle < 0x80 traz (c + 1) bytes literais e o controle >= 0x80 repete o byte seguinte (c - 0x7E) vezes.
+typedef struct {
+  const uint8_t *dados;
+  bool rle, repetir;
+  uint8_t restantes;
+} ssd1306_leitor_t;
+
+static inline uint8_t ssd1306_ler(ssd1306_leitor_t *l) {
+  if (!l->rle) return *l->dados++;
+  if (l->restantes == 0) {
+    uint8_t controle = *l->dados++;
+    l->repetir = controle >= 0x80;
+    l->restantes = l->repetir ? controle - 0x7E : controle + 1;
+  }
+  if (--l->restantes == 0 && l->repetir) return *l->dados++;
+  return l->repetir ? *l->dados : *l->dados++;
+}
+
+// Copia um bitmap gerado na compilação para a sua posição, substituindo a caixa que ele ocupa.
+// Sem RLE é uma cópia por coluna (uma só quando o bitmap tem a altura do display); com RLE os
+// bytes são descomprimidos direto no ram_buffer.
+void ssd1306_blit(ssd1306_t *ssd, const ssd1306_bitmap_t *bitmap) {
+  uint8_t *destino = &ssd->ram_buffer[bitmap->x * ssd->pages + bitmap->pagina + 1];
+
+  if (!bitmap->rle) {
+    if (bitmap->paginas == ssd->pages) {
+      memcpy(destino, bitmap->dados, bitmap->tamanho);
+      return;
+    }
+    for (uint8_t c = 0; c < bitmap->largura; ++c) {
+      memcpy(&destino[c * ssd->pages], &bitmap->dados[c * bitmap->paginas], bitmap->paginas);
+    }
+    return;
+  }
+
+  ssd1306_leitor_t leitor = { .dados = bitmap->dados, .rle = true };
+  for (uint8_t c = 0; c < bitmap->largura; ++c, destino += ssd->pages) {
+    for (uint8_t p = 0; p < bitmap->paginas; ++p) destino[p] = ssd1306_ler(&leitor);
+  }
+}
+
+// Desenha um bitmap com o canto superior esquerdo em (x, y), em qualquer linha, com recorte
+// e combinado ao que já está no buffer pelo modo (cópia, OU, E, OU exclusivo)
+void ssd1306_blit_modo(ssd1306_t *ssd, const ssd1306_bitmap_t *bitmap, int16_t x, int16_t y, ssd1306_modo_t modo) {
+  uint8_t altura = bitmap->paginas * 8;
+  if (y <= -(int16_t)altura || y >= ssd->height || x >= ssd->width || x + bitmap->largura <= 0) return;
+
+  uint64_t cheia = altura >= 64 ? ~0ull : (1ull << altura) - 1;
+  uint64_t mascara = y >= 0 ? cheia << y : cheia >> -y;
+  ssd1306_leitor_t leitor = { .dados = bitmap->dados, .rle = bitmap->rle };
+  for (uint8_t c = 0; c < bitmap->largura; ++c) {
+    uint64_t origem = 0;
+    for (uint8_t p = 0; p < bitmap->paginas; ++p) origem |= (uint64_t)ssd1306_ler(&leitor) << (p * 8);
+
+    int16_t coluna = x + c;
+    if (coluna < 0) continue; // Os bytes da coluna já foram consumidos
+    if (coluna >= ssd->width) break;
+    origem = y >= 0 ? origem << y : origem >> -y;
+    ssd1306_aplicar_colunas(ssd1306_coluna(ssd, coluna), 1, mascara, origem & mascara, modo);
+  }
+}
@@ -1,11 +1,24 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "i2c_dma.h"
 
 
 #define WIDTH 128
 #define HEIGHT 64
 
+// Bytes fixos de cada janela enviada: endereço + controle + 6 de comando, endereço + controle dos dados
+#define SSD1306_CUSTO_JANELA 10
+
+// Palavras de DMA no pior caso: uma janela por página, cada uma com comandos, controle e uma página inteira
+#define SSD1306_DMA_PALAVRAS (8 * (WIDTH + 8))
+
+// Reenvios seguidos depois de uma falha no barramento antes de esperar o próximo desenho
+#define SSD1306_TENTATIVAS 3
+
 typedef enum {
   SET_CONTRAST = 0x81,
   SET_ENTIRE_ON = 0xA4,
@@ -23,9 +36,32 @@ typedef enum {
   SET_DISP_CLK_DIV = 0xD5,
   SET_PRECHARGE = 0xD9,
   SET_VCOM_DESEL = 0xDB,
-  SET_CHARGE_PUMP = 0x8D
+  SET_CHARGE_PUMP = 0x8D,
+  SET_SCROLL_RIGHT = 0x26,
+  SET_SCROLL_LEFT = 0x27,
+  SET_SCROLL_OFF = 0x2E,
+  SET_SCROLL_ON = 0x2F
 } ssd1306_command_t;
 
+// Códigos de intervalo da rolagem horizontal (quadros por passo)
+#define SSD1306_ROLAGEM_2_QUADROS 0x07
+#define SSD1306_ROLAGEM_25_QUADROS 0x06
+#define SSD1306_ROLAGEM_64_QUADROS 0x01
+
+// Duração estimada de um quadro com a configuração de ssd1306_config (oscilador ~370 kHz,
+// divisor 1, pré-carga 1+15, 64 linhas: ~88 Hz). Só serve para contar os passos da rolagem.
+#define SSD1306_QUADRO_US 11400
+
+// Modos de combinação da origem com o que já está no buffer
+typedef enum {
+  SSD1306_COPIAR,        // destino = origem
+  SSD1306_OU,            // destino |= origem (acende)
+  SSD1306_E,             // destino &= origem (apaga onde a origem é 0)
+  SSD1306_OU_EXCLUSIVO   // destino ^= origem (inverte)
+} ssd1306_modo_t;
+
+// O buffer tem as 8 páginas de cada coluna em sequência e começa alinhado em 8 bytes:
+// a coluna x é uma palavra de 64 bits (ssd1306_coluna) em que o bit y é o pixel (x, y)
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
@@ -33,15 +69,55 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  // Atualização parcial: só o que difere do espelho vai para o barramento
+  uint8_t *espelho;           // O que já está no painel (layout de ram_buffer, sem o byte 0x40)
+  uint8_t *tx_buffer;         // Janela montada para envio, com o byte de controle na frente
+  bool espelho_valido;        // false: conteúdo do painel desconhecido, envia o quadro inteiro
+  uint32_t bytes_enviados;    // Bytes no barramento desde a última chamada de ssd1306_estatisticas
+  uint32_t quadros_enviados;
+  uint32_t quadros_iguais;    // Envios ignorados por não haver mudança
+  uint64_t inicio_janela_us;
+  // Envio por DMA: ram_buffer fica livre para o próximo desenho enquanto o quadro anterior é transmitido
+  i2c_dma_t *dma;             // NULL: envio bloqueante
+  bool envio_pendente;        // Pedido de envio feito com o transporte ocupado
+  uint8_t falhas_seguidas;
+  // Rolagem horizontal por hardware das páginas rolagem_p0..rolagem_p1, para a esquerda
+  bool rolagem_ativa;         // Desejada
+  bool rolagem_no_painel;     // Ativada no último envio
+  bool rolagem_pendente;      // Ligar ou desligar no próximo envio, mesmo sem mudança no quadro
+  uint8_t rolagem_p0, rolagem_p1, rolagem_intervalo;
+  uint32_t rolagem_passo_us;
+  uint64_t rolagem_inicio_us; // Início do passo em andamento
+  uint16_t rolagem_passos;    // Passos dados pelo painel e ainda não aplicados ao buffer
 } ssd1306_t;
 
+// Bitmap no layout do ram_buffer (coluna a coluna, páginas da coluna em sequência), recortado na caixa
+// que contém os pixels acesos. Gerado na compilação por tools/img2ssd1306.c a partir de assets/.
+typedef struct {
+  uint8_t x, pagina;          // Canto superior esquerdo (coluna, página de 8 linhas)
+  uint8_t largura, paginas;
+  bool rle;                   // Dados comprimidos: ver ssd1306_blit
+  uint16_t tamanho;           // Bytes em dados
+  const uint8_t *dados;
+} ssd1306_bitmap_t;
+
 void setup_I2C(i2c_inst_t *I2C_PORT, uint I2C_SDA, uint I2C_SCL, uint clock);
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_invalidar(ssd1306_t *ssd);
+void ssd1306_usar_dma(ssd1306_t *ssd, i2c_dma_t *dma);
+void ssd1306_envio_concluido(ssd1306_t *ssd);
+void ssd1306_rolagem(ssd1306_t *ssd, uint8_t p0, uint8_t p1, uint8_t intervalo);
+void ssd1306_parar_rolagem(ssd1306_t *ssd);
+uint8_t ssd1306_rolagem_sincronizar(ssd1306_t *ssd);
+uint32_t ssd1306_rolagem_restante_us(ssd1306_t *ssd);
+void ssd1306_invalidar_paginas(ssd1306_t *ssd, uint8_t p0, uint8_t p1);
+void ssd1306_estatisticas(ssd1306_t *ssd, uint32_t *bytes_por_s, uint32_t *quadros, uint32_t *iguais);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
+void ssd1306_preencher(ssd1306_t *ssd, int16_t x, int16_t y, int16_t largura, int16_t altura, bool valor, ssd1306_modo_t modo);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
@@ -53,4 +129,17 @@ bool ssd1306_is_empty(ssd1306_t *ssd);
 void draw_filled_square(ssd1306_t *ssd, uint8_t x, uint8_t y);
 void setup_ssd1306(ssd1306_t *ssd, uint8_t endereco, i2c_inst_t *I2C_PORT);
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap);
-void drawImage(ssd1306_t *ssd, const uint32_t desenho[8192]);
\ No newline at end of file
+void drawImage(ssd1306_t *ssd, const uint32_t desenho[8192]);
+void ssd1306_blit(ssd1306_t *ssd, const ssd1306_bitmap_t *bitmap);
+void ssd1306_blit_modo(ssd1306_t *ssd, const ssd1306_bitmap_t *bitmap, int16_t x, int16_t y, ssd1306_modo_t modo);
+
+static inline uint64_t *ssd1306_coluna(ssd1306_t *ssd, uint8_t x) {
+  return (uint64_t *)&ssd->ram_buffer[(x << 3) + 1];
+}
+
+// Bits y0..y1 de uma coluna
+static inline uint64_t ssd1306_mascara(uint8_t y0, uint8_t y1) {
+  return (~0ull >> (63 - y1)) & (~0ull << y0);
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include "telemetria.h"
+
+void telemetria_init(telemetria_t *t, const telemetria_politica_t *politica) {
+    t->politica = politica;
+    t->publicado = 0;
+    t->publicado_ms = 0;
+    t->valido = false;
+    t->imediato = false;
+    t->publicacoes = t->suprimidas = 0;
+}
+
+// Transição de estado ou nova conexão: a próxima avaliação publica
+void telemetria_forcar(telemetria_t *t) {
+    t->imediato = true;
+}
+
+static bool telemetria_fora_da_banda(const telemetria_t *t, int32_t valor) {
+    int32_t variacao = valor - t->publicado;
+    if (variacao < 0) variacao = -variacao;
+    return variacao > t->politica->banda_morta;
+}
+
+// Decide se o valor deve ser publicado agora; se sim, ele passa a ser o último publicado
+bool telemetria_avaliar(telemetria_t *t, int32_t valor, uint32_t agora_ms) {
+    const telemetria_politica_t *p = t->politica;
+    uint32_t decorrido = agora_ms - t->publicado_ms;
+    bool publicar = !t->valido || t->imediato ||
+                    (p->intervalo_max_ms && decorrido >= p->intervalo_max_ms) ||
+                    (decorrido >= p->intervalo_min_ms && telemetria_fora_da_banda(t, valor));
+    if (!publicar) {
+        if (telemetria_fora_da_banda(t, valor)) t->suprimidas++; // Segurado pelo intervalo mínimo
+        return false;
+    }
+
+    t->publicado = valor;
+    t->publicado_ms = agora_ms;
+    t->valido = true;
+    t->imediato = false;
+    t->publicacoes++;
+    return true;
+}
+
+// Quanto falta para uma avaliação publicar sem que o valor mude: o fim do intervalo mínimo,
+// se houver variação segurada, ou o heartbeat. UINT32_MAX se nada estiver previsto.
+uint32_t telemetria_espera_ms(const telemetria_t *t, int32_t valor, uint32_t agora_ms) {
+    const telemetria_politica_t *p = t->politica;
+    if (!t->valido || t->imediato) return 0;
+
+    uint32_t decorrido = agora_ms - t->publicado_ms;
+    uint32_t limite;
+    if (telemetria_fora_da_banda(t, valor)) {
+        limite = p->intervalo_min_ms;
+    } else if (p->intervalo_max_ms) {
+        limite = p->intervalo_max_ms;
+    } else {
+        return UINT32_MAX;
+    }
+    return decorrido >= limite ? 0 : limite - decorrido;
+}
@@ -0,0 +1,28 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include "pico/stdlib.h"
+
+// Política de publicação de um tópico: só por exceção, com limites de taxa
+typedef struct {
+    int32_t banda_morta;        // Variação até a qual o valor conta como igual ao publicado
+    uint32_t intervalo_min_ms;  // Menor intervalo entre publicações por variação
+    uint32_t intervalo_max_ms;  // Heartbeat: publica mesmo sem variação (0 = nunca)
+} telemetria_politica_t;
+
+// Estado de um tópico sob uma política
+typedef struct {
+    const telemetria_politica_t *politica;
+    int32_t publicado;          // Último valor publicado
+    uint32_t publicado_ms;      // Instante da última publicação
+    bool valido;                // Já houve uma publicação
+    bool imediato;              // Publica na próxima avaliação, sem esperar o intervalo mínimo
+    uint32_t publicacoes, suprimidas;
+} telemetria_t;
+
+void telemetria_init(telemetria_t *t, const telemetria_politica_t *politica);
+void telemetria_forcar(telemetria_t *t);
+bool telemetria_avaliar(telemetria_t *t, int32_t valor, uint32_t agora_ms);
+uint32_t telemetria_espera_ms(const telemetria_t *t, int32_t valor, uint32_t agora_ms);
+
+#endif
@@ -0,0 +1,50 @@
+#include <string.h>
+#include "topicos.h"
+
+static uint32_t topicos_hash(const char *s, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ (uint8_t)s[i]) * 16777619u;
+    }
+    return h;
+}
+
+// Monta prefixo + sufixo de cada tópico; o id de um tópico é a sua posição em sufixos
+bool topicos_init(topicos_t *r, const char *prefixo, const char *const *sufixos, uint8_t num) {
+    if (num > TOPICOS_MAX) return false;
+    memset(r->tabela, 0, sizeof(r->tabela));
+    r->num = num;
+    r->usado = 0;
+
+    size_t n_prefixo = strlen(prefixo);
+    for (uint8_t id = 0; id < num; id++) {
+        size_t n_sufixo = strlen(sufixos[id]);
+        size_t n = n_prefixo + n_sufixo;
+        if (r->usado + n + 1 > TOPICOS_ARENA) return false;
+
+        char *nome = &r->arena[r->usado];
+        memcpy(nome, prefixo, n_prefixo);
+        memcpy(nome + n_prefixo, sufixos[id], n_sufixo + 1);
+        r->usado += n + 1;
+        r->nome[id] = nome;
+        r->tamanho[id] = n;
+        r->hash[id] = topicos_hash(nome, n);
+
+        // Sondagem linear; com a tabela no máximo meio cheia as sequências são curtas
+        uint32_t pos = r->hash[id] & (TOPICOS_TABELA - 1);
+        while (r->tabela[pos]) pos = (pos + 1) & (TOPICOS_TABELA - 1);
+        r->tabela[pos] = id + 1;
+    }
+    return true;
+}
+
+uint8_t topicos_buscar(const topicos_t *r, const char *topico, size_t tamanho) {
+    uint32_t h = topicos_hash(topico, tamanho);
+    for (uint32_t pos = h & (TOPICOS_TABELA - 1); r->tabela[pos]; pos = (pos + 1) & (TOPICOS_TABELA - 1)) {
+        uint8_t id = r->tabela[pos] - 1;
+        if (r->hash[id] == h && r->tamanho[id] == tamanho && memcmp(r->nome[id], topico, tamanho) == 0) {
+            return id;
+        }
+    }
+    return TOPICO_NENHUM;
+}
@@ -0,0 +1,31 @@
+#ifndef TOPICOS_H
+#define TOPICOS_H
+
+#include "pico/stdlib.h"
+
+#define TOPICOS_MAX 64           // Tópicos registrados
+#define TOPICOS_TABELA 128       // Posições da tabela hash (potência de 2, o dobro de TOPICOS_MAX)
+#define TOPICOS_ARENA 2048       // Bytes para todos os nomes completos
+#define TOPICO_NENHUM 0xFF       // Tópico desconhecido
+
+// Registro de tópicos: os nomes completos (com o prefixo do cliente, se houver) são montados
+// uma vez e não mudam mais, então podem ser usados por qualquer chamador ao mesmo tempo.
+// A busca de um tópico recebido é um hash FNV-1a e uma comparação.
+typedef struct {
+    uint8_t num;
+    const char *nome[TOPICOS_MAX];      // Nomes completos, na arena
+    uint16_t tamanho[TOPICOS_MAX];
+    uint32_t hash[TOPICOS_MAX];
+    uint8_t tabela[TOPICOS_TABELA];     // Índice + 1 de cada tópico; 0 = posição livre
+    uint16_t usado;
+    char arena[TOPICOS_ARENA];
+} topicos_t;
+
+bool topicos_init(topicos_t *r, const char *prefixo, const char *const *sufixos, uint8_t num);
+uint8_t topicos_buscar(const topicos_t *r, const char *topico, size_t tamanho);
+
+static inline const char *topicos_nome(const topicos_t *r, uint8_t id) {
+    return r->nome[id];
+}
+
+#endif
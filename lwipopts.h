@@ -30,4 +30,7 @@
 // This defaults to 4
 #define MQTT_REQ_MAX_IN_FLIGHT 5
 
+// This defaults to 256; /metrics publishes a single payload of up to 400 bytes
+#define MQTT_OUTPUT_RINGBUF_SIZE 512
+
 #endif
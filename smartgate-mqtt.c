@@ -6,6 +6,10 @@
 #include "pico/stdlib.h"         
 #include "pico/cyw43_arch.h" 
 #include "pico/unique_id.h"
+#include "pico/multicore.h"
+#include "pico/async_context_poll.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
 
 // Bibliotecas lwip
 #include "lwip/apps/mqtt.h" // Biblioteca LWIP MQTT -  fornece funções e recursos para conexão MQTT
@@ -14,12 +18,28 @@
 #include "lwip/altcp_tls.h" // Biblioteca que fornece funções e recursos para conexões seguras usando TLS:
 
 // Bibliotecas de hardware
-#include "lib/hcSR04.h"
+#include "lib/sensores.h"
+#include "lib/rastreador.h"
+#include "lib/amostragem.h"
+#include "lib/canal.h"
+#include "lib/nucleo.h"
+#include "lib/metricas.h"
+#include "lib/telemetria.h"
+#include "lib/lote.h"
+#include "lib/topicos.h"
+#include "lib/entrada.h"
+#include "lib/fila.h"
+#include "lib/reconexao.h"
+#include "lib/cache_boot.h"
+#include "lib/boot.h"
+#include "lib/saida.h"
 #include "lib/ledRGB.h"
 #include "lib/buzzer.h"
 #include "lib/ssd1306.h"
+#include "lib/i2c_dma.h"
+#include "lib/grafico.h"
 #include "lib/led_5x5.h"
-#include "lib/font.h"
+#include "icones.h" // Gerado na compilação a partir de assets/ (tools/img2ssd1306.c)
 
 //======================================================
 // DEFINIÇÕES E CONFIGURAÇÕES GLOBAIS
@@ -28,11 +48,32 @@
 // Definições de pinos
 #define TRIGGER 16 // Pino trigger do sensor ultrassônico
 #define ECHO 17 // Pino echo do sensor ultrassônico
+// Para portões largos, acrescente pares trigger/echo (até SENSORES_MAX), ex: { 18, 19 }
+static const sensor_pinos_t SENSORES_PINOS[] = {
+    { TRIGGER, ECHO },
+};
+#define NUM_SENSORES (sizeof(SENSORES_PINOS) / sizeof(SENSORES_PINOS[0]))
 #define I2C_PORT i2c1 // Porta I2C para display OLED
 #define I2C_SDA 14 // Pino SDA da interface I2C
 #define I2C_SCL 15 // Pino SCL da interface I2C
 #define SSD1306_ADDRESS 0x3C // Endereço I2C do display OLED
 
+// Medição do sensor ultrassônico
+#define SENSORES_MODO SENSORES_RODIZIO // Um sensor por disparo; SENSORES_ENCADEADO varre todos a cada disparo
+#define AMOSTRAGEM_MIN_MS 60 // Intervalo mínimo entre disparos (~16 Hz, respeita o eco e a reverberação)
+#define AMOSTRAGEM_MAX_MS 500 // Intervalo com a cena parada (2 Hz)
+#define FILTRO_MODO FILTRO_MEDIANA // Mediana, Hampel ou EMA
+#define FILTRO_JANELA 5 // Amostras na janela deslizante
+#define FILTRO_IDADE_MAX_MS (500 * NUM_SENSORES) // Amostras mais antigas saem da janela
+#define LIMIAR_PRESENCA_CM 30 // Distância que caracteriza presença no portão
+#define PREVISAO_HORIZONTE_MS 500 // Antecedência máxima da presença prevista
+
+// Divisão entre os núcleos: core0 cuida do Wi-Fi/MQTT, core1 do sensor, display, matriz e buzzer
+#define CORE1_ALARMES 16 // Alarmes do pool próprio do core1
+#define RELATORIO_TIME_S 5 // Tempo em segundos entre relatórios de amostragem e uso de CPU
+#define GRAFICO_PAGINA 7 // Página do display (linhas 56 a 63) com o histórico de distância
+#define GRAFICO_ESCALA_CM 200 // Distância que enche a barra do gráfico
+
 // Configurações do MQTT e Wi-Fi
 #define WIFI_SSID "SEU_SSID" // Substitua pelo nome da sua rede Wi-Fi
 #define WIFI_PASSWORD "SEU_PASSWORD_WIFI" // Substitua pela senha da sua rede Wi-Fi
@@ -47,12 +88,96 @@ typedef enum {
     PORTAO_ABERTO // Portão aberto para acesso
 } EstadoSistema;
 
-// Variáveis globais
+// Variáveis globais do core1 (tempo real)
 EstadoSistema estadoAtual = ESPERANDO; // Estado inicial do sistema
 ssd1306_t ssd; // Estrutura do display OLED
-uint64_t distancia = 150; // Distância medida pelo sensor (cm)
-volatile bool tocar_som_abertura = false; // Controla o som de da "Porta/Portão" que abriu
-volatile bool tocar_som_fechamento = false; // Controla o som de da "Porta/Portão" que fechou
+i2c_dma_t i2c_display; // Envio dos quadros do display por DMA
+grafico_t grafico; // Histórico de distância na última página do display
+uint64_t distancia = 150; // Distância do objeto mais próximo entre os sensores (cm)
+sensores_t sensores; // Conjunto de sensores ultrassônicos, cada um com seu filtro
+amostragem_t amostragem; // Escalonador adaptativo dos disparos do sensor
+rastreador_t rastreador; // Estimativa de distância e velocidade do alvo
+bool presenca_prevista = false; // Alvo deve cruzar o limiar dentro do horizonte
+alarm_pool_t *pool_core1; // Alarmes cujas interrupções chegam ao core1
+nucleo_uso_t uso_core1; // Tempo ocioso do core1
+async_context_poll_t contexto_core1; // Workers do core1, executados só por ele
+
+// Workers do core1, para medir o maior tempo de execução de cada um
+typedef enum {
+    WORKER_AMOSTRAS,
+    WORKER_COMANDOS,
+    WORKER_ESTADO,
+    WORKER_DISPLAY,
+    WORKER_GRAFICO,
+    NUM_WORKERS_CORE1
+} worker_core1_t;
+uint32_t worker_max_us[NUM_WORKERS_CORE1]; // Maior duração na janela do relatório
+
+#if METRICAS_ATIVAS
+// Fases com histograma de duração: os workers do core1 vêm primeiro, na ordem de worker_core1_t
+typedef enum {
+    FASE_FILTRO = NUM_WORKERS_CORE1, // core1: leitura do sensor e filtro de cada amostra
+    FASE_DESENHO,       // core1: desenho do quadro (ícone, LED RGB e matriz)
+    FASE_ENVIO_DISPLAY, // core1: ssd1306_send_data
+    FASE_EVENTOS,       // core0: worker de eventos do core1
+    FASE_MQTT_ENTRADA,  // core0: callback de dados recebidos
+    FASE_PUBLICACAO,    // core0: workers de publicação periódica
+    NUM_METRICAS
+} fase_t;
+
+static const char *const NOMES_METRICAS[NUM_METRICAS] = {
+    "amostras", "comandos", "estado", "display", "grafico",
+    "filtro", "desenho", "envio", "eventos", "entrada", "publica",
+};
+metrica_t metricas[NUM_METRICAS];
+#endif
+
+// Canais entre os núcleos: nenhum dado é compartilhado fora deles
+canal_t canal_core1; // core1 -> core0: distâncias, estado, previsão e relatórios
+canal_t canal_core0; // core0 -> core1: comandos do portão
+
+// Etapas da inicialização, em ordem de dependência. Cada etapa espera só o que declara: o core1
+// reserva o PIO e o core0 sobe o rádio enquanto o core1 configura o display.
+typedef enum {
+    BOOT_STDIO,
+    BOOT_ALARMES,       // core1: pool de alarmes
+    BOOT_PIO,           // core1: matriz e sensores
+    BOOT_REGISTRO,      // core0: identificador, tópicos e dados do cliente
+    BOOT_RADIO,         // core0: cyw43_arch_init
+    BOOT_DISPLAY,       // core1: I2C, OLED e DMA do display
+    BOOT_PERIFERICOS,   // core1: LEDs, amostragem e buzzers
+    BOOT_CORE1,         // core1: workers
+    BOOT_WIFI,          // Associação e DHCP
+    BOOT_DNS,
+    BOOT_MQTT,          // Do pedido de conexão ao CONNACK
+    NUM_ETAPAS_BOOT
+} etapa_boot_t;
+
+static boot_etapa_t ETAPAS_BOOT[NUM_ETAPAS_BOOT] = {
+    [BOOT_STDIO] = { .nome = "stdio" },
+    [BOOT_ALARMES] = { .nome = "alarmes" },
+    [BOOT_PIO] = { .nome = "pio", .dependencias = BOOT_DEP(BOOT_ALARMES) },
+    [BOOT_REGISTRO] = { .nome = "registro", .dependencias = BOOT_DEP(BOOT_STDIO) },
+    // O cyw43 fica com o PIO e os canais de DMA que a matriz e os sensores deixaram livres
+    [BOOT_RADIO] = { .nome = "radio", .dependencias = BOOT_DEP(BOOT_PIO) },
+    [BOOT_DISPLAY] = { .nome = "display", .dependencias = BOOT_DEP(BOOT_ALARMES) },
+    [BOOT_PERIFERICOS] = { .nome = "perifericos", .dependencias = BOOT_DEP(BOOT_PIO) },
+    [BOOT_CORE1] = { .nome = "core1", .dependencias = BOOT_DEP(BOOT_DISPLAY) | BOOT_DEP(BOOT_PERIFERICOS) },
+    [BOOT_WIFI] = { .nome = "wifi", .dependencias = BOOT_DEP(BOOT_RADIO) | BOOT_DEP(BOOT_REGISTRO) },
+    [BOOT_DNS] = { .nome = "dns", .dependencias = BOOT_DEP(BOOT_WIFI) },
+    [BOOT_MQTT] = { .nome = "mqtt", .dependencias = BOOT_DEP(BOOT_DNS) },
+};
+boot_t boot;
+
+// Variáveis globais do core0 (rede): cópias do que o core1 informou
+EstadoSistema estado_publicado = ESPERANDO;
+int distancia_publicada = 150;
+int distancia_sensor[SENSORES_MAX];
+evento_t previsao_publicada;
+nucleo_uso_t uso_core0; // Tempo ocioso do core0
+telemetria_t telemetria_distancia; // Publicação por exceção de cada tópico de telemetria
+telemetria_t telemetria_sensor[SENSORES_MAX];
+telemetria_t telemetria_status;
 
 
 #ifndef MQTT_SERVER
@@ -64,21 +189,17 @@ volatile bool tocar_som_fechamento = false; // Controla o som de da "Porta/Port
 #include MQTT_CERT_INC
 #endif
 
-#ifndef MQTT_TOPIC_LEN
-#define MQTT_TOPIC_LEN 100
-#endif
-
 //Dados do cliente MQTT
 typedef struct {
     mqtt_client_t* mqtt_client_inst;
     struct mqtt_connect_client_info_t mqtt_client_info;
-    char data[MQTT_OUTPUT_RINGBUF_SIZE];
-    char topic[MQTT_TOPIC_LEN];
-    uint32_t len;
     ip_addr_t mqtt_server_address;
     bool connect_done;
     int subscribe_count;
     bool stop_client;
+    bool endereco_ok;   // mqtt_server_address resolvido; refeito depois de uma queda do Wi-Fi
+    bool associando;    // Associação ao Wi-Fi pedida e ainda sem resultado
+    bool endereco_cache; // Endereço do broker lido do cache de boot e ainda sem CONNACK
 } MQTT_CLIENT_DATA_T;
 
 #ifndef DEBUG_printf
@@ -97,14 +218,82 @@ typedef struct {
 #define ERROR_printf printf
 #endif
 
-// Temporização da coleta de distância
-#define DIST_WORKER_TIME_S 2
-#define STATUS_WORKER_TIME_S 1 // Tempo em segundos para publicar o status do sistema
+// Telemetria por exceção: publica quando o valor sai da banda morta, respeitando o intervalo
+// mínimo, e repete o último valor no heartbeat para quem acabou de assinar
+#define DIST_BANDA_MORTA_CM 2 // Variação de distância que não justifica publicar
+#define DIST_INTERVALO_MIN_MS 250 // Maior taxa de publicação da distância (4 Hz)
+#define DIST_HEARTBEAT_S 30 // Distância republicada mesmo parada
+#define STATUS_HEARTBEAT_S 60 // Status republicado sem transição; transições saem na hora
+
+// Toda distância vinda do core1 também vai, com o instante, em quadros binários para /distance/batch.
+// /distance continua em texto para o IoT MQTT Panel.
+#ifndef DIST_LOTE_ATIVO
+#define DIST_LOTE_ATIVO 1
+#endif
+#define DIST_LOTE_AMOSTRAS 64 // Amostras por quadro
+#define DIST_LOTE_PRAZO_MS 2000 // Tempo máximo de uma amostra no quadro antes do envio
+
+// Cache de boot no último setor da flash: BSSID e canal da última associação e IP do broker.
+// O boot tenta a associação direta e o IP guardado; se falharem, volta à varredura e ao DNS.
+#ifndef CACHE_BOOT_ATIVO
+#define CACHE_BOOT_ATIVO 1
+#endif
+#define CACHE_BOOT_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+// Sem conexão com o broker, distância e status vão para a fila e são reenviados em /backlog,
+// com o instante original, quando a conexão volta. A área de flash estende a fila além da RAM,
+// mas cada página gravada para o core1 por alguns ms (e um apagamento de setor por ~50 ms).
+#ifndef FILA_FLASH_ATIVA
+#define FILA_FLASH_ATIVA 0
+#endif
+#define FILA_FLASH_SETORES 4 // 512 registros, logo antes do cache de boot
+#define FILA_FLASH_OFFSET (CACHE_BOOT_OFFSET - FILA_FLASH_SETORES * FLASH_SECTOR_SIZE)
+#define FILA_REENVIO_MS 100 // Intervalo entre rodadas de reenvio
+#define FILA_REENVIO_RODADA 2 // Registros por rodada (até 20/s)
+#define FILA_REENVIO_JANELA 2 // Reenvios sem PUBACK; o resto de MQTT_REQ_MAX_IN_FLIGHT fica para o tráfego ao vivo
+
+#define METRICAS_WORKER_TIME_S 10 // Tempo em segundos para publicar os histogramas de latência
+#define METRICAS_MSG_TAM 400 // Cabe em MQTT_OUTPUT_RINGBUF_SIZE junto com o cabeçalho
+
+// Política de publicação de cada tópico de telemetria
+static const telemetria_politica_t POLITICA_DISTANCIA = {
+    .banda_morta = DIST_BANDA_MORTA_CM,
+    .intervalo_min_ms = DIST_INTERVALO_MIN_MS,
+    .intervalo_max_ms = DIST_HEARTBEAT_S * 1000,
+};
+static const telemetria_politica_t POLITICA_STATUS = {
+    .banda_morta = 0,
+    .intervalo_min_ms = 0,
+    .intervalo_max_ms = STATUS_HEARTBEAT_S * 1000,
+};
+
+#if DIST_LOTE_ATIVO
+lote_t lote_distancia; // Quadro binário de distâncias em formação
+#endif
+
+fila_t fila; // Telemetria guardada enquanto não há conexão
+saida_t saida; // Publicações esperando espaço no cliente MQTT
+bool saida_agendada;
+reconexao_t reconexao_mqtt, reconexao_wifi;
+
+cache_boot_t cache_boot;
+bool cache_wifi; // BSSID e canal do cache ainda não recusados nesta execução
+
+bool boot_rapido = CACHE_BOOT_ATIVO; // Associação direta e IP do cache, sem varredura nem DNS
+bool boot_publicado;
 
 
 // Manter o programa ativo
 #define MQTT_KEEP_ALIVE_S 60
 
+// Reconexão com recuo exponencial: a espera começa no mínimo e dobra a cada falha até o máximo.
+// O enlace Wi-Fi é verificado periodicamente para não esperar o keep alive quando a rede cai.
+#define MQTT_RECONEXAO_MIN_MS 500 // Primeira espera depois de uma queda do broker (250 a 500 ms)
+#define MQTT_RECONEXAO_MAX_MS 15000
+#define WIFI_RECONEXAO_MIN_MS 2000
+#define WIFI_RECONEXAO_MAX_MS 60000
+#define ENLACE_VERIFICACAO_MS 1000
+
 // QoS - mqtt_subscribe
 // At most once (QoS 0)
 // At least once (QoS 1)
@@ -113,6 +302,22 @@ typedef struct {
 #define MQTT_PUBLISH_QOS 1
 #define MQTT_PUBLISH_RETAIN 0
 
+// Toda publicação passa pela fila de saída (lib/saida.c), por classe de prioridade. Respostas a
+// comandos e mudanças de estado vão em QoS 1; telemetria e diagnóstico em QoS 0, que libera o
+// lugar em MQTT_REQ_MAX_IN_FLIGHT assim que o TCP confirma, sem esperar o PUBACK. O reenvio da
+// fila offline vai em QoS 1, por último e com janela própria.
+#define SAIDA_REPETIR_MS 20 // Nova tentativa depois de um ERR_MEM do cliente
+static const uint8_t QOS_SAIDA[NUM_CLASSES_SAIDA] = {
+    [SAIDA_CONTROLE] = 1,
+    [SAIDA_ESTADO] = 1,
+    [SAIDA_TELEMETRIA] = 0,
+    [SAIDA_DIAGNOSTICO] = 0,
+    [SAIDA_REENVIO] = 1,
+};
+static const uint8_t JANELA_SAIDA[NUM_CLASSES_SAIDA] = {
+    [SAIDA_REENVIO] = FILA_REENVIO_JANELA,
+};
+
 // Tópico usado para: last will and testament
 #define MQTT_WILL_TOPIC "/online"
 #define MQTT_WILL_MSG "0"
@@ -127,6 +332,73 @@ typedef struct {
 #define MQTT_UNIQUE_TOPIC 0
 #endif
 
+// Tópicos do cliente; os de comando (assinados) vêm primeiro e indexam COMANDOS
+typedef enum {
+    TOPICO_GATE,
+    TOPICO_PRINT,
+    TOPICO_PING,
+    TOPICO_EXIT,
+    NUM_COMANDOS,
+    TOPICO_ONLINE = NUM_COMANDOS,
+    TOPICO_GATE_STATE,
+    TOPICO_STATUS,
+    TOPICO_DISTANCE,
+    TOPICO_DISTANCE_SENSOR, // /distance/0 a /distance/<SENSORES_MAX - 1>
+    TOPICO_DISTANCE_BATCH = TOPICO_DISTANCE_SENSOR + SENSORES_MAX,
+    TOPICO_DISTANCE_PREDICTED,
+    TOPICO_SAMPLER,
+    TOPICO_CPU,
+    TOPICO_DISPLAY,
+    TOPICO_METRICS,
+    TOPICO_UPTIME,
+    TOPICO_INBOUND,
+    TOPICO_BACKLOG,
+    TOPICO_QUEUE,
+    TOPICO_RECONNECT,
+    TOPICO_BOOT,
+    TOPICO_BOOT_TRACE,
+    TOPICO_OUTBOUND,
+    NUM_TOPICOS
+} topico_t;
+
+static const char *const NOMES_TOPICOS[NUM_TOPICOS] = {
+    [TOPICO_GATE] = "/gate",
+    [TOPICO_PRINT] = "/print",
+    [TOPICO_PING] = "/ping",
+    [TOPICO_EXIT] = "/exit",
+    [TOPICO_ONLINE] = MQTT_WILL_TOPIC,
+    [TOPICO_GATE_STATE] = "/gate/state",
+    [TOPICO_STATUS] = "/status",
+    [TOPICO_DISTANCE] = "/distance",
+    [TOPICO_DISTANCE_SENSOR + 0] = "/distance/0",
+    [TOPICO_DISTANCE_SENSOR + 1] = "/distance/1",
+    [TOPICO_DISTANCE_SENSOR + 2] = "/distance/2",
+    [TOPICO_DISTANCE_SENSOR + 3] = "/distance/3",
+    [TOPICO_DISTANCE_BATCH] = "/distance/batch",
+    [TOPICO_DISTANCE_PREDICTED] = "/distance/predicted",
+    [TOPICO_SAMPLER] = "/sampler",
+    [TOPICO_CPU] = "/cpu",
+    [TOPICO_DISPLAY] = "/display",
+    [TOPICO_METRICS] = "/metrics",
+    [TOPICO_UPTIME] = "/uptime",
+    [TOPICO_INBOUND] = "/inbound",
+    [TOPICO_BACKLOG] = "/backlog",
+    [TOPICO_QUEUE] = "/queue",
+    [TOPICO_RECONNECT] = "/reconnect",
+    [TOPICO_BOOT] = "/boot",
+    [TOPICO_BOOT_TRACE] = "/boot/trace",
+    [TOPICO_OUTBOUND] = "/outbound",
+};
+_Static_assert(SENSORES_MAX == 4, "NOMES_TOPICOS tem um /distance/<n> por sensor");
+
+topicos_t topicos; // Nomes completos, montados uma vez antes da conexão
+
+// Payloads recebidos: os que chegam num fragmento são tratados no buffer do cliente MQTT;
+// os maiores são remontados aqui, até este limite, e acima dele descartados
+#define MQTT_ENTRADA_MAX 1024
+static uint8_t buffer_entrada[MQTT_ENTRADA_MAX];
+entrada_t entrada;
+
 //======================================================
 // PROTÓTIPOS DE FUNÇÕES
 //======================================================
@@ -134,21 +406,90 @@ typedef struct {
 // Inicialização dos periféricos
 void setup();
 
+// Inicialização dos periféricos do core1 (interrupções e alarmes ficam nesse núcleo)
+static void setup_core1();
+
+// Laço de tempo real do core1
+static void core1_main();
+
+// Envia um evento pelo canal
+static void enviar_evento(canal_t *canal, uint8_t tipo, uint8_t origem, int16_t v0, int16_t v1, int16_t v2);
+
+// Registra o tempo de execução de um worker do core1
+static void medir_worker(worker_core1_t worker, uint64_t inicio_us);
+
+// Interrupção do PIO: amostra nova disponível
+static void sensor_concluido(void *dados);
+
+// Interrupção do I2C: fim do envio de um quadro do display
+static void display_enviado(void *dados);
+
+// Consome as amostras do sensor e atualiza a distância
+static void atualizar_distancia();
+
+// Muda o estado do sistema
+static void entrar_estado(EstadoSistema novo);
+
+// Aplica um comando do portão recebido do core0
+static void aplicar_comando(bool abrir);
+
+// Workers do core1
+static void amostras_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t amostras_worker = { .do_work = amostras_worker_fn };
+
+static void comandos_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t comandos_worker = { .do_work = comandos_worker_fn };
+
+static void estado_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t estado_worker = { .do_work = estado_worker_fn };
+
+static void display_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t display_worker = { .do_work = display_worker_fn };
+
+static void envio_display_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t envio_display_worker = { .do_work = envio_display_worker_fn };
+
+static void relatorio_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t relatorio_worker = { .do_work = relatorio_worker_fn };
+
+static void grafico_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t grafico_worker = { .do_work = grafico_worker_fn };
+
 // Requisição para publicar
 static void pub_request_cb(__unused void *arg, err_t err);
 
-// Topico MQTT
-static const char *full_topic(MQTT_CLIENT_DATA_T *state, const char *name);
+// Conclusão de um reenvio da fila offline: confirma o registro e abre um lugar na janela
+static void reenvio_request_cb(void *arg, err_t err);
+
+// Nome completo de um tópico
+static inline const char *topico(topico_t id) {
+    return topicos_nome(&topicos, id);
+}
+
+// Entrega uma mensagem da fila de saída ao cliente MQTT
+static saida_resultado_t saida_mqtt(void *dados, saida_classe_t classe, const char *topico, const void *payload,
+                                    uint16_t tamanho, uint8_t qos, bool retain);
+
+// Publica pela fila de saída na classe dada
+static void publicar(MQTT_CLIENT_DATA_T *state, saida_classe_t classe, topico_t id, const void *payload, uint16_t tamanho);
+
+// Entrega o que a fila de saída segurou
+static void agendar_saida(MQTT_CLIENT_DATA_T *state, uint32_t ms);
+static void saida_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t saida_worker = { .do_work = saida_worker_fn };
 
 // Controle do portão
 static void control_gate(MQTT_CLIENT_DATA_T *state, bool on);
 
 // Publicar distância
-static void publish_distance(MQTT_CLIENT_DATA_T *state);
+static void publish_distance(MQTT_CLIENT_DATA_T *state, topico_t id, int distance);
 
 // Publicar status
 static void publish_status(MQTT_CLIENT_DATA_T *state);
 
+// Publica os tópicos de telemetria cuja política pede e agenda a próxima verificação
+static void publicar_telemetria(MQTT_CLIENT_DATA_T *state);
+
 // Requisição de Assinatura - subscribe
 static void sub_request_cb(void *arg, err_t err);
 
@@ -164,13 +505,35 @@ static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t f
 // Dados de entrada publicados
 static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len);
 
-// Publicar distância
-static void distance_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
-static async_at_time_worker_t distance_worker = { .do_work = distance_worker_fn };
+// Heartbeat e variações seguradas pelo intervalo mínimo
+static void telemetria_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t telemetria_worker = { .do_work = telemetria_worker_fn };
 
-// Publicar status do sistema
-static void publish_status_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
-static async_at_time_worker_t publish_status_worker = { .do_work = publish_status_worker_fn };
+#if DIST_LOTE_ATIVO
+// Acrescenta uma distância ao quadro binário e o publica quando enche
+static void adicionar_lote(MQTT_CLIENT_DATA_T *state, const evento_t *evento);
+
+// Publicar o quadro de distâncias em /distance/batch
+static void publish_batch(MQTT_CLIENT_DATA_T *state);
+
+// Envia o quadro quando o prazo da primeira amostra vence
+static void lote_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t lote_worker = { .do_work = lote_worker_fn };
+#endif
+
+#if METRICAS_ATIVAS
+// Publicar histogramas de latência
+static void metricas_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t metricas_worker = { .do_work = metricas_worker_fn };
+#endif
+
+// Reenvia a fila em ritmo limitado depois que a conexão volta
+static void reenvio_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t reenvio_worker = { .do_work = reenvio_worker_fn };
+
+// Consumir os eventos do core1
+static void eventos_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t eventos_worker = { .do_work = eventos_worker_fn };
 
 // Conexão MQTT
 static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status);
@@ -178,6 +541,29 @@ static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection
 // Inicializar o cliente MQTT
 static void start_client(MQTT_CLIENT_DATA_T *state);
 
+// Publicar quedas e tempo de recuperação em /reconnect
+static void publish_reconnect(MQTT_CLIENT_DATA_T *state);
+
+// Publicar o resumo do boot em /boot e as etapas em /boot/trace
+static void publish_boot(MQTT_CLIENT_DATA_T *state);
+
+// Guarda a associação e o endereço do broker que funcionaram
+static void gravar_cache_boot(MQTT_CLIENT_DATA_T *state);
+
+// Abre (ou reabre) a conexão com o broker
+static void conectar_broker(MQTT_CLIENT_DATA_T *state);
+
+// Marca a conexão como perdida e agenda a próxima tentativa
+static void perder_conexao(MQTT_CLIENT_DATA_T *state);
+
+// Leva o cliente até o broker: associação ao Wi-Fi, DNS e conexão MQTT, com recuo entre tentativas
+static void conexao_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t conexao_worker = { .do_work = conexao_worker_fn };
+
+// Detecta a queda do enlace Wi-Fi com o cliente conectado
+static void enlace_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t enlace_worker = { .do_work = enlace_worker_fn };
+
 // Call back com o resultado do DNS
 static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg);
 
@@ -187,19 +573,48 @@ static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg);
 //======================================================
 int main(void) {
 
+    if (!boot_init(&boot, ETAPAS_BOOT, NUM_ETAPAS_BOOT)) {
+        panic("Boot stages out of dependency order");
+    }
+
     // Inicializa os periféricos
-    setup();    
+    boot_etapa(&boot, BOOT_STDIO);
+    setup();
+    boot_fim(&boot, BOOT_STDIO);
+
+    // Canais e métricas são usados pelos dois núcleos: ficam prontos antes do core1 partir.
+    // O core1 assume sensor, display, matriz e buzzer.
+    canal_init(&canal_core1);
+    canal_init(&canal_core0);
+#if METRICAS_ATIVAS
+    for (int i = 0; i < NUM_METRICAS; i++) {
+        metrica_init(&metricas[i], NOMES_METRICAS[i]);
+    }
+#endif
+    multicore_launch_core1(core1_main);
 
-    INFO_printf("mqtt client starting\n");
+    boot_etapa(&boot, BOOT_REGISTRO);
+    telemetria_init(&telemetria_distancia, &POLITICA_DISTANCIA);
+    for (int i = 0; i < SENSORES_MAX; i++) {
+        telemetria_init(&telemetria_sensor[i], &POLITICA_DISTANCIA);
+    }
+    telemetria_init(&telemetria_status, &POLITICA_STATUS);
+#if DIST_LOTE_ATIVO
+    lote_init(&lote_distancia, DIST_LOTE_AMOSTRAS, DIST_LOTE_PRAZO_MS);
+#endif
+#if FILA_FLASH_ATIVA
+    fila_init(&fila, FILA_FLASH_OFFSET, FILA_FLASH_SETORES);
+#else
+    fila_init(&fila, 0, 0);
+#endif
+    reconexao_init(&reconexao_mqtt, MQTT_RECONEXAO_MIN_MS, MQTT_RECONEXAO_MAX_MS);
+    reconexao_init(&reconexao_wifi, WIFI_RECONEXAO_MIN_MS, WIFI_RECONEXAO_MAX_MS);
 
+    INFO_printf("mqtt client starting\n");
 
     // Cria registro com os dados do cliente
     static MQTT_CLIENT_DATA_T state;
-
-    // Inicializa a arquitetura do cyw43
-    if (cyw43_arch_init()) {
-        panic("Failed to inizialize CYW43");
-    }
+    saida_init(&saida, QOS_SAIDA, JANELA_SAIDA, saida_mqtt, &state);
 
     // Usa identificador único da placa
     char unique_id_buf[5];
@@ -224,12 +639,35 @@ int main(void) {
     state.mqtt_client_info.client_user = NULL;
     state.mqtt_client_info.client_pass = NULL;
 #endif
-    static char will_topic[MQTT_TOPIC_LEN];
-    strncpy(will_topic, full_topic(&state, MQTT_WILL_TOPIC), sizeof(will_topic));
-    state.mqtt_client_info.will_topic = will_topic;
+    // Todos os nomes de tópico são montados aqui, com o prefixo do cliente se MQTT_UNIQUE_TOPIC
+#if MQTT_UNIQUE_TOPIC
+    char prefixo[sizeof(client_id_buf) + 1];
+    snprintf(prefixo, sizeof(prefixo), "/%s", client_id_buf);
+#else
+    const char *prefixo = "";
+#endif
+    if (!topicos_init(&topicos, prefixo, NOMES_TOPICOS, NUM_TOPICOS)) {
+        panic("Topic registry too small");
+    }
+    entrada_init(&entrada, buffer_entrada, sizeof(buffer_entrada));
+    state.mqtt_client_info.will_topic = topico(TOPICO_ONLINE);
     state.mqtt_client_info.will_msg = MQTT_WILL_MSG;
     state.mqtt_client_info.will_qos = MQTT_WILL_QOS;
     state.mqtt_client_info.will_retain = true;
+    boot_fim(&boot, BOOT_REGISTRO);
+
+    // Inicializa a arquitetura do cyw43 assim que o core1 reservou o PIO
+    boot_etapa(&boot, BOOT_RADIO);
+    if (cyw43_arch_init()) {
+        panic("Failed to inizialize CYW43");
+    }
+
+    // Eventos do core1 são tratados no contexto do lwIP, mesmo antes da conexão
+    eventos_worker.user_data = &state;
+    async_context_add_when_pending_worker(cyw43_arch_async_context(), &eventos_worker);
+    nucleo_uso_init(&uso_core0);
+    boot_fim(&boot, BOOT_RADIO);
+
 #if LWIP_ALTCP && LWIP_ALTCP_TLS
     // TLS enabled
 #ifdef MQTT_CERT_INC
@@ -248,88 +686,16 @@ int main(void) {
 #endif
 #endif
 
-    // Conectar à rede WiFI - fazer um loop até que esteja conectado
+    // Wi-Fi, DNS e broker são alcançados pelo conexao_worker, que também os refaz depois de uma queda
     cyw43_arch_enable_sta_mode();
-    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000)) {
-        panic("Failed to connect");
-    }
-    INFO_printf("\nConnected to Wifi\n");
-
-    //Faz um pedido de DNS para o endereço IP do servidor MQTT
-    cyw43_arch_lwip_begin();
-    int err = dns_gethostbyname(MQTT_SERVER, &state.mqtt_server_address, dns_found, &state);
-    cyw43_arch_lwip_end();
+    start_client(&state);
 
-    // Se tiver o endereço, inicia o cliente
-    if (err == ERR_OK) {
-        start_client(&state);
-    } else if (err != ERR_INPROGRESS) { // ERR_INPROGRESS means expect a callback
-        panic("dns request failed");
-    }
-
-    // Som de inicialização do sistema
-    somInicializacao(BUZZER2);
-
-    // Loop condicionado a conexão mqtt
-    while (!state.connect_done || mqtt_client_is_connected(state.mqtt_client_inst)) {
-        cyw43_arch_poll();
-        cyw43_arch_wait_for_work_until(make_timeout_time_ms(10000));
-
-        distancia = getCmFiltered(TRIGGER, ECHO, 6); // Mede a distância com filtragem para reduzir ruídos
-        if (distancia < 2) distancia = 2; // Valor mínimo seguro para evitar travamento
-        
-        // Limpa o display para nova renderização
-        ssd1306_fill(&ssd, false);
-        
-        // Toca o som da abertura da Porta/Portão quando necessário
-        if (tocar_som_abertura) {
-            tocar_som_abertura = false;
-            buzzer_pwm_off(BUZZER2);
-            somAberturaPortao(BUZZER2); 
+    // Só o comando /exit encerra o laço. O core0 só repassa eventos e dorme.
+    while (!state.stop_client || mqtt_client_is_connected(state.mqtt_client_inst)) {
+        if (canal_ocupacao(&canal_core1)) {
+            async_context_set_work_pending(cyw43_arch_async_context(), &eventos_worker);
         }
-        
-        // Toca o som de fechamento da Porta/Portão quando necessário
-        if (tocar_som_fechamento) {
-            apagarMatriz(); // Apaga a matriz LED
-            tocar_som_fechamento = false;
-            somFechamentoPortao(BUZZER2);
-        }
-        
-        // Máquina de estados do sistema
-        switch (estadoAtual) {
-            case ESPERANDO:
-            // Transição para PRESENCA_DETECTADA se detectar objeto próximo
-            if (distancia <= 30) {
-                estadoAtual = PRESENCA_DETECTADA;
-            }
-            setLeds(0, 0, 1); // LED Azul indica modo de espera
-            drawImage(&ssd, cadeado_fechado); // Mostra ícone de cadeado fechado
-            break;
-            
-            case PRESENCA_DETECTADA:
-            // Retorna para ESPERANDO se não houver mais presença
-            if (distancia > 30) {
-                estadoAtual = ESPERANDO;
-            }
-            desenhoX(); // Desenha um "X" na matriz LED
-            setLeds(1, 0, 0); // LED Vermelho indica alerta
-            drawImage(&ssd, alerta); // Mostra ícone de alerta
-            alarmePresencaPWM(BUZZER1); // Aciona o alarme sonoro
-            apagarMatriz(); // Apaga a matriz LED
-            break;
-            
-            case PORTAO_ABERTO:
-            desenhoCheck(); // Desenha um "check" na matriz LED
-            setLeds(0, 1, 0);  // LED Verde indica portão aberto
-            drawImage(&ssd, cadeado_aberto);  // Mostra ícone de cadeado aberto
-            break;
-        }
-
-
-        INFO_printf("Distância: %llu cm\n", distancia);
-        
-        ssd1306_send_data(&ssd); // Atualiza o display com as alterações
-        sleep_ms(30); // Pequeno atraso para estabilidade
+        nucleo_ocioso(&uso_core0); // Acorda com interrupções do Wi-Fi ou com o __sev() do core1
     }
 
     INFO_printf("mqtt client exiting\n");
@@ -341,84 +707,454 @@ int main(void) {
 //======================================================
 void setup() {
     stdio_init_all(); // Inicializa stdio
-    setupUltrasonicPins(TRIGGER, ECHO); // Configura pinos do sensor ultrassônico
+}
+
+// Chamada no core1: os tratadores do PIO e os alarmes do sensor ficam nesse núcleo
+static void setup_core1() {
+    boot_etapa(&boot, BOOT_ALARMES);
+    pool_core1 = alarm_pool_create_with_unused_hardware_alarm(CORE1_ALARMES);
+    boot_fim(&boot, BOOT_ALARMES);
+
+    // PIO primeiro: o core0 só sobe o rádio depois desta etapa
+    boot_etapa(&boot, BOOT_PIO);
+    setup_PIO(pool_core1); // Configura matriz LED 5x5, alimentada por DMA
+    // Configura os sensores ultrassônicos no PIO, cada um com seu filtro
+    if (!sensores_init(&sensores, SENSORES_PINOS, NUM_SENSORES, SENSORES_MODO, pool_core1,
+                       FILTRO_MODO, FILTRO_JANELA, FILTRO_IDADE_MAX_MS)) {
+        panic("Failed to initialize HC-SR04");
+    }
+    boot_fim(&boot, BOOT_PIO);
+
+    // A configuração do OLED bloqueia no I2C: acontece junto com a do rádio no core0
+    boot_etapa(&boot, BOOT_DISPLAY);
+    setup_I2C(I2C_PORT, I2C_SDA, I2C_SCL, 400 * 1000); // Configura I2C a 400kHz
+    setup_ssd1306(&ssd, SSD1306_ADDRESS, I2C_PORT); // Inicializa display OLED
+    // Depois da configuração, os quadros do display seguem por DMA sem bloquear o core1
+    if (i2c_dma_init(&i2c_display, I2C_PORT, I2C_SDA, I2C_SCL, 400 * 1000, pool_core1, SSD1306_DMA_PALAVRAS)) {
+        ssd1306_usar_dma(&ssd, &i2c_display);
+    }
+    grafico_init(&grafico, &ssd, GRAFICO_PAGINA, GRAFICO_ESCALA_CM); // Histórico de distância rolado pelo display
+    boot_fim(&boot, BOOT_DISPLAY);
+
+    boot_etapa(&boot, BOOT_PERIFERICOS);
     setupLED(LED_RED); // Configura LED vermelho
     setupLED(LED_GREEN); // Configura LED verde
     setupLED(LED_BLUE); // Configura LED azul
-    setup_I2C(I2C_PORT, I2C_SDA, I2C_SCL, 400 * 1000); // Configura I2C a 400kHz
-    setup_ssd1306(&ssd, SSD1306_ADDRESS, I2C_PORT); // Inicializa display OLED
-    setup_PIO(); // Configura matriz LED 5x5
+    rastreador_init(&rastreador, LIMIAR_PRESENCA_CM, PREVISAO_HORIZONTE_MS); // Previsão de presença
+    amostragem_init(&amostragem, pool_core1, sensores_disparar, &sensores, AMOSTRAGEM_MIN_MS, AMOSTRAGEM_MAX_MS);
+    amostragem_iniciar(&amostragem); // Medições disparadas por alarme de hardware
     init_pwm_buzzer(BUZZER1); // Inicializa buzzer 1 com PWM
     init_pwm_buzzer(BUZZER2); // Inicializa buzzer 2 com PWM
+    init_sequenciador_buzzer(pool_core1); // Sons tocados pelos alarmes do core1
+    boot_fim(&boot, BOOT_PERIFERICOS);
 }
 
-// Requisição para publicar
-static void pub_request_cb(__unused void *arg, err_t err) {
+//======================================================
+// CORE1 - TEMPO REAL
+//======================================================
+static void core1_main() {
+#if FILA_FLASH_ATIVA || CACHE_BOOT_ATIVO
+    flash_safe_execute_core_init(); // O core0 pode parar este núcleo para gravar a fila ou o cache na flash
+#endif
+    setup_core1();
+    boot_etapa(&boot, BOOT_CORE1);
+    nucleo_uso_init(&uso_core1);
+
+    // Todo o trabalho do core1 é feito por workers; o laço só despacha e dorme
+    if (!async_context_poll_init_with_defaults(&contexto_core1)) {
+        panic("Failed to initialize core1 async context");
+    }
+    async_context_t *contexto = &contexto_core1.core;
+    async_context_add_when_pending_worker(contexto, &amostras_worker);
+    async_context_add_when_pending_worker(contexto, &comandos_worker);
+    async_context_add_when_pending_worker(contexto, &estado_worker);
+    async_context_add_when_pending_worker(contexto, &display_worker);
+    async_context_add_when_pending_worker(contexto, &envio_display_worker);
+    async_context_add_at_time_worker_in_ms(contexto, &relatorio_worker, RELATORIO_TIME_S * 1000);
+    async_context_add_at_time_worker_in_ms(contexto, &grafico_worker, GRAFICO_ESPERA_MAX_MS);
+    sensores_ao_concluir(&sensores, sensor_concluido, NULL);
+    i2c_dma_ao_concluir(&i2c_display, display_enviado, NULL);
+
+    boot_fim(&boot, BOOT_CORE1);
+
+    // Som de inicialização do sistema, tocado pelo sequenciador sem bloquear
+    somInicializacao(BUZZER2);
+    enviar_evento(&canal_core1, EVENTO_ESTADO, estadoAtual, 0, 0, 0);
+    async_context_set_work_pending(contexto, &display_worker);
+
+    while (true) {
+        // Comandos do portão vindos do core0 (o __sev() do canal acorda este núcleo)
+        if (canal_ocupacao(&canal_core0)) {
+            async_context_set_work_pending(contexto, &comandos_worker);
+        }
+        async_context_poll(contexto);
+        // Dorme até o próximo worker com horário ou até a próxima interrupção
+        nucleo_ocioso_ate(&uso_core1, pool_core1, contexto->next_time);
+    }
+}
+
+// Envia um evento pelo canal; se o consumidor estiver atrasado o evento é descartado
+static void enviar_evento(canal_t *canal, uint8_t tipo, uint8_t origem, int16_t v0, int16_t v1, int16_t v2) {
+    evento_t evento = {
+        .tipo = tipo,
+        .origem = origem,
+        .valor = { v0, v1, v2 },
+        .instante_ms = to_ms_since_boot(get_absolute_time()),
+    };
+    canal_enviar(canal, &evento);
+}
+
+// Registra quanto tempo um worker do core1 executou
+static void medir_worker(worker_core1_t worker, uint64_t inicio_us) {
+    uint32_t duracao = (uint32_t)(time_us_64() - inicio_us);
+    if (duracao > worker_max_us[worker]) worker_max_us[worker] = duracao;
+    METRICA_REGISTRAR(&metricas[worker], duracao);
+}
+
+// Interrupção do PIO: há amostra nova nos buffers dos sensores
+static void sensor_concluido(__unused void *dados) {
+    async_context_set_work_pending(&contexto_core1.core, &amostras_worker);
+}
+
+// Interrupção do I2C: o quadro terminou de sair (ou falhou); o resto é tratado fora da interrupção
+static void display_enviado(__unused void *dados) {
+    async_context_set_work_pending(&contexto_core1.core, &envio_display_worker);
+}
+
+// Consome as amostras dos sensores e atualiza a distância
+static void atualizar_distancia() {
+    sensores_leitura_t leitura;
+    uint8_t mais_proximo;
+
+    // Cada amostra bruta gera um valor filtrado: a taxa filtrada é a mesma do sensor
+    METRICA_INICIO(inicio_filtro);
+    while (sensores_ler(&sensores, &leitura)) {
+        METRICA_FIM(&metricas[FASE_FILTRO], inicio_filtro);
+        amostragem_registrar_medicao(&amostragem, leitura.duracao_us);
+
+        float fundida = sensores_mais_proxima(&sensores, leitura.instante_ms, &mais_proximo);
+        amostragem_observar(&amostragem, fundida, leitura.instante_ms); // Ajusta a taxa à atividade
+        distancia = (uint64_t)(fundida + 0.5f);
+
+        // Com mais de um sensor, o core0 também publica cada um
+        if (sensores.num > 1) {
+            enviar_evento(&canal_core1, EVENTO_DISTANCIA, leitura.indice, (int16_t)(leitura.filtrada_cm + 0.5f), 0, 0);
+        }
+
+        // O rastreador segue o objeto mais próximo e usa a leitura bruta:
+        // a mediana atrasa justamente a aproximação
+        static uint8_t sensor_rastreado;
+        if (mais_proximo != sensor_rastreado) {
+            rastreador_reiniciar(&rastreador); // Outro sensor ficou mais perto: é outro alvo
+            sensor_rastreado = mais_proximo;
+        }
+        if (leitura.indice == sensor_rastreado) {
+            if (!leitura.valida) {
+                // Ecos perdidos (alvo fora de alcance ou perto demais): a previsão não se sustenta
+                rastreador_reiniciar(&rastreador);
+            } else if (rastreador_atualizar(&rastreador, leitura.bruta_cm, leitura.instante_ms)) {
+                uint32_t ttl = rastreador.tempo_limiar_ms == RASTREADOR_SEM_PREVISAO ? 0 : rastreador.tempo_limiar_ms;
+                enviar_evento(&canal_core1, EVENTO_PREVISAO, 0, (int16_t)rastreador.distancia,
+                              (int16_t)rastreador.velocidade, (int16_t)(ttl > INT16_MAX ? INT16_MAX : ttl));
+            }
+        }
+        // Sem medida nova do alvo, a previsão expira com a estimativa
+        presenca_prevista = rastreador_vigente(&rastreador, leitura.instante_ms);
+        METRICA_REINICIAR(inicio_filtro);
+    }
+    if (distancia < 2) distancia = 2; // Valor mínimo seguro para evitar travamento
+
+    static uint64_t distancia_enviada;
+    if (distancia != distancia_enviada) {
+        distancia_enviada = distancia;
+        INFO_printf("Distância: %llu cm\n", distancia);
+        enviar_evento(&canal_core1, EVENTO_DISTANCIA, CANAL_ORIGEM_FUSAO, (int16_t)distancia, 0, 0);
+    }
+}
+
+// Muda o estado e dispara os efeitos de entrada; o display é redesenhado pelo seu worker
+static void entrar_estado(EstadoSistema novo) {
+    if (novo == estadoAtual) return;
+    estadoAtual = novo;
+
+    if (novo == PRESENCA_DETECTADA) {
+        alarmePresencaPWM(BUZZER1); // Aciona o alarme sonoro até a presença acabar
+    } else {
+        pararAlarmePresenca(BUZZER1);
+    }
+    async_context_set_work_pending(&contexto_core1.core, &display_worker);
+    enviar_evento(&canal_core1, EVENTO_ESTADO, novo, 0, 0, 0); // Informa o core0 só quando o estado muda
+}
+
+// Aplica um comando do portão recebido do core0
+static void aplicar_comando(bool abrir) {
+    if (abrir) {
+        somAberturaPortao(BUZZER2);
+        entrar_estado(PORTAO_ABERTO);
+    } else {
+        somFechamentoPortao(BUZZER2);
+        entrar_estado((distancia > LIMIAR_PRESENCA_CM && !presenca_prevista) ? ESPERANDO : PRESENCA_DETECTADA);
+    }
+}
+
+// Amostras dos sensores
+static void amostras_worker_fn(async_context_t *context, __unused async_when_pending_worker_t *worker) {
+    uint64_t inicio = time_us_64();
+    atualizar_distancia(); // Consome as medições já feitas pelo PIO, sem esperar o eco
+    async_context_set_work_pending(context, &estado_worker);
+    medir_worker(WORKER_AMOSTRAS, inicio);
+}
+
+// Comandos do portão vindos do core0
+static void comandos_worker_fn(__unused async_context_t *context, __unused async_when_pending_worker_t *worker) {
+    uint64_t inicio = time_us_64();
+    evento_t evento;
+    while (canal_receber(&canal_core0, &evento)) {
+        if (evento.tipo == EVENTO_COMANDO_PORTAO) {
+            aplicar_comando(evento.origem);
+        }
+    }
+    medir_worker(WORKER_COMANDOS, inicio);
+}
+
+// Máquina de estados do sistema, avaliada a cada nova distância
+static void estado_worker_fn(__unused async_context_t *context, __unused async_when_pending_worker_t *worker) {
+    uint64_t inicio = time_us_64();
+    bool presenca = distancia <= LIMIAR_PRESENCA_CM || presenca_prevista;
+    switch (estadoAtual) {
+        case ESPERANDO:
+        // Transição para PRESENCA_DETECTADA se detectar objeto próximo ou se aproximando
+        if (presenca) entrar_estado(PRESENCA_DETECTADA);
+        break;
+
+        case PRESENCA_DETECTADA:
+        // Retorna para ESPERANDO se não houver mais presença
+        if (!presenca) entrar_estado(ESPERANDO);
+        break;
+
+        case PORTAO_ABERTO:
+        break; // Só sai com o comando "Close"
+    }
+    medir_worker(WORKER_ESTADO, inicio);
+}
+
+// Display, LED RGB e matriz: só são redesenhados quando o estado muda
+static void display_worker_fn(__unused async_context_t *context, __unused async_when_pending_worker_t *worker) {
+    uint64_t inicio = time_us_64();
+    METRICA_INICIO(inicio_fase);
+    ssd1306_preencher(&ssd, 0, 0, WIDTH, GRAFICO_PAGINA * 8, false, SSD1306_COPIAR); // Limpa a área do ícone; a última página é do gráfico
+    switch (estadoAtual) {
+        case ESPERANDO:
+        apagarMatriz(); // Apaga a matriz LED
+        setLeds(0, 0, 1); // LED Azul indica modo de espera
+        ssd1306_blit(&ssd, &ICONE_CADEADO_FECHADO); // Mostra ícone de cadeado fechado
+        break;
+
+        case PRESENCA_DETECTADA:
+        setLeds(1, 0, 0); // LED Vermelho indica alerta
+        matriz_animar(&ANIM_X_PISCANDO); // "X" piscando na matriz LED, tocado por alarme
+        ssd1306_blit(&ssd, &ICONE_ALERTA); // Mostra ícone de alerta
+        break;
+
+        case PORTAO_ABERTO:
+        matriz_animar(&ANIM_CHECK_PULSANDO); // "Check" pulsando na matriz LED
+        setLeds(0, 1, 0);  // LED Verde indica portão aberto
+        ssd1306_blit(&ssd, &ICONE_CADEADO_ABERTO);  // Mostra ícone de cadeado aberto
+        break;
+    }
+    METRICA_FIM(&metricas[FASE_DESENHO], inicio_fase);
+    METRICA_REINICIAR(inicio_fase);
+    ssd1306_send_data(&ssd); // Entrega as alterações ao DMA e retorna
+    METRICA_FIM(&metricas[FASE_ENVIO_DISPLAY], inicio_fase);
+    medir_worker(WORKER_DISPLAY, inicio);
+}
+
+// Coluna nova do histórico de distância; o resto do gráfico é rolado pelo próprio display.
+// Acorda logo depois de cada passo da rolagem, quando há coluna nova a escrever.
+static void grafico_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
+    uint64_t inicio = time_us_64();
+    uint32_t espera_ms = grafico_amostra(&grafico, (uint16_t)distancia);
+    async_context_add_at_time_worker_in_ms(context, worker, espera_ms);
+    medir_worker(WORKER_GRAFICO, inicio);
+}
+
+// Fim de um envio do display: refaz o quadro após falha no barramento ou envia o que ficou pendente
+static void envio_display_worker_fn(__unused async_context_t *context, __unused async_when_pending_worker_t *worker) {
+    ssd1306_envio_concluido(&ssd);
+}
+
+// Taxa de amostragem, uso do core1, maior tempo de worker e tráfego do display, medidos aqui para não haver leitura cruzada
+static void relatorio_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
+    float taxa_hz, duty;
+    amostragem_relatorio(&amostragem, &taxa_hz, &duty);
+    enviar_evento(&canal_core1, EVENTO_AMOSTRAGEM, 0, (int16_t)(taxa_hz * 10.0f), (int16_t)(duty * 1000.0f), 0);
+
+    uint8_t pior = 0;
+    for (uint8_t i = 1; i < NUM_WORKERS_CORE1; i++) {
+        if (worker_max_us[i] > worker_max_us[pior]) pior = i;
+    }
+    uint32_t max_us = worker_max_us[pior];
+    enviar_evento(&canal_core1, EVENTO_CPU, pior, (int16_t)(nucleo_utilizacao(&uso_core1) * 1000.0f),
+                  (int16_t)(max_us > INT16_MAX ? INT16_MAX : max_us), 0);
+    memset(worker_max_us, 0, sizeof(worker_max_us));
+
+    uint32_t bytes_por_s, quadros, iguais;
+    ssd1306_estatisticas(&ssd, &bytes_por_s, &quadros, &iguais);
+    enviar_evento(&canal_core1, EVENTO_DISPLAY, 0, (int16_t)(uint16_t)(bytes_por_s > UINT16_MAX ? UINT16_MAX : bytes_por_s),
+                  (int16_t)(quadros > INT16_MAX ? INT16_MAX : quadros), (int16_t)(iguais > INT16_MAX ? INT16_MAX : iguais));
+
+    async_context_add_at_time_worker_in_ms(context, worker, RELATORIO_TIME_S * 1000);
+}
+
+// Requisição para publicar. O lugar em MQTT_REQ_MAX_IN_FLIGHT só é liberado depois desta
+// chamada, então o que a fila de saída segurou vai no worker.
+static void pub_request_cb(void *arg, err_t err) {
     if (err != 0) {
         ERROR_printf("pub_request_cb failed %d", err);
     }
+    if (!saida_vazia(&saida)) agendar_saida((MQTT_CLIENT_DATA_T*)arg, 0);
 }
 
-//Topico MQTT
-static const char *full_topic(MQTT_CLIENT_DATA_T *state, const char *name) {
-#if MQTT_UNIQUE_TOPIC
-    static char full_topic[MQTT_TOPIC_LEN];
-    snprintf(full_topic, sizeof(full_topic), "/%s%s", state->mqtt_client_info.client_id, name);
-    return full_topic;
-#else
-    return name;
-#endif
+// ERR_MEM (sem lugar em MQTT_REQ_MAX_IN_FLIGHT ou no buffer de saída) e a conexão ainda não
+// refeita fazem a mensagem esperar; o resto é recusado
+static saida_resultado_t saida_mqtt(void *dados, saida_classe_t classe, const char *topico, const void *payload,
+                                    uint16_t tamanho, uint8_t qos, bool retain) {
+    MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)dados;
+    if (!state->connect_done) return SAIDA_CHEIA;
+    // O reenvio confirma a própria janela
+    mqtt_request_cb_t cb = classe == SAIDA_REENVIO ? reenvio_request_cb : pub_request_cb;
+    err_t err = mqtt_publish(state->mqtt_client_inst, topico, payload, tamanho, qos, retain, cb, state);
+    if (err == ERR_OK) return SAIDA_ENVIADA;
+    // Cabeçalho fixo, tamanho do tópico e id do pacote: acima disso nunca cabe no buffer de saída
+    if (err == ERR_MEM && tamanho + strlen(topico) + 9 <= MQTT_OUTPUT_RINGBUF_SIZE) return SAIDA_CHEIA;
+    ERROR_printf("mqtt_publish %s failed %d\n", topico, err);
+    return SAIDA_ERRO;
+}
+
+// Telemetria e diagnóstico são substituíveis: só o valor mais novo de cada tópico espera.
+// Os quadros de /distance/batch não se sobrepõem e esperam todos.
+static void publicar(MQTT_CLIENT_DATA_T *state, saida_classe_t classe, topico_t id, const void *payload, uint16_t tamanho) {
+    bool substituivel = (classe == SAIDA_TELEMETRIA || classe == SAIDA_DIAGNOSTICO) && id != TOPICO_DISTANCE_BATCH;
+    saida_publicar(&saida, classe, topico(id), payload, tamanho, MQTT_PUBLISH_RETAIN, substituivel);
+    if (!saida_vazia(&saida) && !saida_agendada) agendar_saida(state, SAIDA_REPETIR_MS);
+}
+
+static void agendar_saida(MQTT_CLIENT_DATA_T *state, uint32_t ms) {
+    async_context_t *contexto = cyw43_arch_async_context();
+    saida_worker.user_data = state;
+    async_context_remove_at_time_worker(contexto, &saida_worker);
+    async_context_add_at_time_worker_in_ms(contexto, &saida_worker, ms);
+    saida_agendada = true;
+}
+
+static void saida_worker_fn(__unused async_context_t *context, async_at_time_worker_t *worker) {
+    METRICA_INICIO(inicio);
+    MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)worker->user_data;
+    saida_agendada = false;
+    // Sem conexão, a fila espera o próximo CONNACK
+    if (state->connect_done && saida_drenar(&saida)) agendar_saida(state, SAIDA_REPETIR_MS);
+    METRICA_FIM(&metricas[FASE_PUBLICACAO], inicio);
 }
 
 // Controle do portão
 static void control_gate(MQTT_CLIENT_DATA_T *state, bool open) {
     // Publica o estado do portão
     const char* message = open ? "Open" : "Close";
-    if (open) {
-        tocar_som_abertura = true;  // Seta flag
-        estadoAtual = PORTAO_ABERTO;
-    } else {
-        tocar_som_fechamento = true;  // Seta flag
-        estadoAtual = (distancia > 30) ? ESPERANDO : PRESENCA_DETECTADA;
-    }
-    mqtt_publish(state->mqtt_client_inst, full_topic(state, "/gate/state"), message, strlen(message), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+    // O core1 muda o estado e toca o som; o novo estado volta pelo canal
+    enviar_evento(&canal_core0, EVENTO_COMANDO_PORTAO, open, 0, 0, 0);
+    publicar(state, SAIDA_CONTROLE, TOPICO_GATE_STATE, message, strlen(message));
 }
 
-// Publicar distância
-static void publish_distance(MQTT_CLIENT_DATA_T *state) {
-    static float old_distance;
-    const char *distance_key = full_topic(state, "/distance");
-    uint64_t distance = distancia; // ← USA A VARIÁVEL GLOBAL
-    if (distance != old_distance) {
-        old_distance = distance;
-        // Publish distance on /distance topic
-        char dist_str[16];
-        snprintf(dist_str, sizeof(dist_str), "%llu", distance); // Use %llu para uint64_t
-        INFO_printf("Publishing %s to %s\n", dist_str, distance_key);
-        mqtt_publish(state->mqtt_client_inst, distance_key, dist_str, strlen(dist_str), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+// Guarda um valor de telemetria para reenvio quando a conexão voltar
+static void guardar_offline(topico_t id, const char *valor) {
+    fila_adicionar(&fila, id, to_ms_since_boot(get_absolute_time()), valor, strlen(valor));
+}
+
+// Publicar distância em /distance ou /distance/<n>
+static void publish_distance(MQTT_CLIENT_DATA_T *state, topico_t id, int distance) {
+    const char *distance_key = topico(id);
+    char dist_str[16];
+    snprintf(dist_str, sizeof(dist_str), "%d", distance);
+    if (!state->connect_done) {
+        guardar_offline(id, dist_str);
+        return;
     }
+    INFO_printf("Publishing %s to %s\n", dist_str, distance_key);
+    publicar(state, SAIDA_TELEMETRIA, id, dist_str, strlen(dist_str));
 }
 
 // Publicar status
 static void publish_status(MQTT_CLIENT_DATA_T *state) {
     char status[64];
-    const char *status_key = full_topic(state, "/status");
-    if (estadoAtual == ESPERANDO)
+    const char *status_key = topico(TOPICO_STATUS);
+    if (!state->connect_done) {
+        // O texto não cabe num registro da fila: guarda o código do estado
+        snprintf(status, sizeof(status), "%d", (int)estado_publicado);
+        guardar_offline(TOPICO_STATUS, status);
+        return;
+    }
+    if (estado_publicado == ESPERANDO)
         strcpy(status, "Portao fechado – sem presença detectada");
-    else if (estadoAtual == PRESENCA_DETECTADA)
+    else if (estado_publicado == PRESENCA_DETECTADA)
         strcpy(status, "Presença detectada – aguardando ação");
     else
         strcpy(status, "Portao aberto – acesso autorizado");
 
     INFO_printf("Publishing status: %s to %s\n", status, status_key);
-    mqtt_publish(state->mqtt_client_inst, status_key, status, strlen(status), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+    publicar(state, SAIDA_ESTADO, TOPICO_STATUS, status, strlen(status));
+}
+
+// Publicar presença prevista junto com a distância
+static void publish_predicted(MQTT_CLIENT_DATA_T *state) {
+    char msg[48];
+    const char *predicted_key = topico(TOPICO_DISTANCE_PREDICTED);
+    // Distância estimada, velocidade (cm/s) e tempo até cruzar o limiar (ms)
+    snprintf(msg, sizeof(msg), "%d,%d,%d", previsao_publicada.valor[0], previsao_publicada.valor[1],
+             previsao_publicada.valor[2]);
+    INFO_printf("Publishing %s to %s\n", msg, predicted_key);
+    publicar(state, SAIDA_TELEMETRIA, TOPICO_DISTANCE_PREDICTED, msg, strlen(msg));
+}
+
+// Publicar taxa de amostragem e duty cycle do sensor
+static void publish_sampler(MQTT_CLIENT_DATA_T *state, const evento_t *relatorio) {
+    char msg[32];
+    const char *sampler_key = topico(TOPICO_SAMPLER);
+    // Hz, % do tempo medindo
+    snprintf(msg, sizeof(msg), "%.1f,%.1f", relatorio->valor[0] / 10.0f, relatorio->valor[1] / 10.0f);
+    INFO_printf("Publishing %s to %s\n", msg, sampler_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_SAMPLER, msg, strlen(msg));
+}
+
+// Publicar utilização de cada núcleo, eventos perdidos nos canais e o maior tempo de um worker do core1
+static void publish_cpu(MQTT_CLIENT_DATA_T *state, const evento_t *relatorio) {
+    char msg[40];
+    const char *cpu_key = topico(TOPICO_CPU);
+    snprintf(msg, sizeof(msg), "%.1f,%.1f,%u,%d", nucleo_utilizacao(&uso_core0) * 100.0f, relatorio->valor[0] / 10.0f,
+             (unsigned)(canal_core1.descartados + canal_core0.descartados), relatorio->valor[1]);
+    INFO_printf("Publishing %s to %s\n", msg, cpu_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_CPU, msg, strlen(msg));
+}
+
+// Publicar o tráfego I2C do display e quantos quadros foram enviados ou ignorados por não mudarem
+static void publish_display(MQTT_CLIENT_DATA_T *state, const evento_t *relatorio) {
+    char msg[32];
+    const char *display_key = topico(TOPICO_DISPLAY);
+    snprintf(msg, sizeof(msg), "%u,%d,%d", (unsigned)(uint16_t)relatorio->valor[0], relatorio->valor[1], relatorio->valor[2]);
+    INFO_printf("Publishing %s to %s\n", msg, display_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_DISPLAY, msg, strlen(msg));
 }
 
 // Requisição de Assinatura - subscribe
 static void sub_request_cb(void *arg, err_t err) {
     MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)arg;
     if (err != 0) {
-        panic("subscribe request failed %d", err);
+        // Sem a assinatura os comandos não chegam: refaz a conexão inteira
+        ERROR_printf("subscribe request failed %d\n", err);
+        if (state->connect_done) {
+            mqtt_disconnect(state->mqtt_client_inst);
+            perder_conexao(state);
+        }
+        return;
     }
     state->subscribe_count++;
 }
@@ -427,7 +1163,7 @@ static void sub_request_cb(void *arg, err_t err) {
 static void unsub_request_cb(void *arg, err_t err) {
     MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)arg;
     if (err != 0) {
-        panic("unsubscribe request failed %d", err);
+        ERROR_printf("unsubscribe request failed %d\n", err); // O /exit desconecta mesmo assim
     }
     state->subscribe_count--;
     assert(state->subscribe_count >= 0);
@@ -441,99 +1177,402 @@ static void unsub_request_cb(void *arg, err_t err) {
 // Tópicos de assinatura
 static void sub_unsub_topics(MQTT_CLIENT_DATA_T* state, bool sub) {
     mqtt_request_cb_t cb = sub ? sub_request_cb : unsub_request_cb;
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/gate"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/print"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/ping"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/exit"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
+    for (uint8_t id = 0; id < NUM_COMANDOS; id++) {
+        mqtt_sub_unsub(state->mqtt_client_inst, topico(id), MQTT_SUBSCRIBE_QOS, cb, state, sub);
+    }
 }
 
-// Dados de entrada MQTT
+// "Open"/"1" abre e "Close"/"0" fecha, sem diferenciar maiúsculas; -1 para o resto
+static int payload_portao(const char *dados, u16_t len) {
+    switch (len) {
+        case 1: return dados[0] == '1' ? 1 : dados[0] == '0' ? 0 : -1;
+        case 4: return lwip_strnicmp(dados, "open", 4) == 0 ? 1 : -1;
+        case 5: return lwip_strnicmp(dados, "close", 5) == 0 ? 0 : -1;
+        default: return -1;
+    }
+}
+
+static void comando_gate(MQTT_CLIENT_DATA_T *state, const char *dados, u16_t len) {
+    int abrir = payload_portao(dados, len);
+    if (abrir >= 0) control_gate(state, abrir);
+}
+
+static void comando_print(__unused MQTT_CLIENT_DATA_T *state, const char *dados, u16_t len) {
+    INFO_printf("%.*s\n", len, dados);
+}
+
+static void comando_ping(MQTT_CLIENT_DATA_T *state, __unused const char *dados, __unused u16_t len) {
+    char buf[11];
+    snprintf(buf, sizeof(buf), "%u", to_ms_since_boot(get_absolute_time()) / 1000);
+    publicar(state, SAIDA_CONTROLE, TOPICO_UPTIME, buf, strlen(buf));
+}
+
+static void comando_exit(MQTT_CLIENT_DATA_T *state, __unused const char *dados, __unused u16_t len) {
+    state->stop_client = true; // stop the client when ALL subscriptions are stopped
+    sub_unsub_topics(state, false); // unsubscribe
+}
+
+// Tratador de cada tópico de comando, indexado pelo id do registro
+typedef void (*comando_fn)(MQTT_CLIENT_DATA_T *state, const char *dados, u16_t len);
+static const comando_fn COMANDOS[NUM_COMANDOS] = {
+    [TOPICO_GATE] = comando_gate,
+    [TOPICO_PRINT] = comando_print,
+    [TOPICO_PING] = comando_ping,
+    [TOPICO_EXIT] = comando_exit,
+};
+
+// Dados de entrada MQTT: um fragmento do payload; o tratador recebe o payload inteiro, sem terminador
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags) {
+    METRICA_INICIO(inicio);
     MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)arg;
-#if MQTT_UNIQUE_TOPIC
-    const char *basic_topic = state->topic + strlen(state->mqtt_client_info.client_id) + 1;
-#else
-    const char *basic_topic = state->topic;
-#endif
-    strncpy(state->data, (const char *)data, len);
-    state->len = len;
-    state->data[len] = '\0';
-
-    DEBUG_printf("Topic: %s, Message: %s\n", state->topic, state->data);
-    if (strcmp(basic_topic, "/gate") == 0)
-    {
-        if (lwip_stricmp((const char *)state->data, "Open") == 0 || strcmp((const char *)state->data, "1") == 0)
-            control_gate(state, true);
-        else if (lwip_stricmp((const char *)state->data, "Close") == 0 || strcmp((const char *)state->data, "0") == 0)
-            control_gate(state, false);
-    } else if (strcmp(basic_topic, "/print") == 0) {
-        INFO_printf("%.*s\n", len, data);
-    } else if (strcmp(basic_topic, "/ping") == 0) {
-        char buf[11];
-        snprintf(buf, sizeof(buf), "%u", to_ms_since_boot(get_absolute_time()) / 1000);
-        mqtt_publish(state->mqtt_client_inst, full_topic(state, "/uptime"), buf, strlen(buf), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-    } else if (strcmp(basic_topic, "/exit") == 0) {
-        state->stop_client = true; // stop the client when ALL subscriptions are stopped
-        sub_unsub_topics(state, false); // unsubscribe
+    uint16_t tamanho;
+    const uint8_t *payload = entrada_fragmento(&entrada, data, len, flags & MQTT_DATA_FLAG_LAST, &tamanho);
+    if (payload) {
+        DEBUG_printf("Topic: %s, Message: %.*s\n", topico(entrada.id), tamanho, (const char *)payload);
+        COMANDOS[entrada.id](state, (const char *)payload, tamanho);
     }
+    METRICA_FIM(&metricas[FASE_MQTT_ENTRADA], inicio);
 }
 
-// Dados de entrada publicados
-static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len) {
-    MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)arg;
-    strncpy(state->topic, topic, sizeof(state->topic));
+// Dados de entrada publicados: o tópico é resolvido aqui, uma vez por publicação, sem cópia
+static void mqtt_incoming_publish_cb(__unused void *arg, const char *topic, u32_t tot_len) {
+    uint8_t id = topicos_buscar(&topicos, topic, strlen(topic));
+    entrada_comecar(&entrada, id < NUM_COMANDOS ? id : ENTRADA_NENHUM, tot_len);
 }
 
-// Publicar distância
-static void distance_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
+// Publicar os contadores de entrada quando algum mudar
+static void publish_inbound(MQTT_CLIENT_DATA_T *state) {
+    static uint32_t ultima_soma;
+    uint32_t soma = entrada.recebidas + entrada.desconhecidas + entrada.grandes + entrada.truncadas;
+    if (soma == ultima_soma) return;
+    ultima_soma = soma;
+
+    char msg[48];
+    const char *inbound_key = topico(TOPICO_INBOUND);
+    snprintf(msg, sizeof(msg), "%u,%u,%u,%u,%u", (unsigned)entrada.recebidas, (unsigned)entrada.remontadas,
+             (unsigned)entrada.desconhecidas, (unsigned)entrada.grandes, (unsigned)entrada.truncadas);
+    INFO_printf("Publishing %s to %s\n", msg, inbound_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_INBOUND, msg, strlen(msg));
+}
+
+// Publicar profundidade, descartes e duração da última drenagem da fila quando algum mudar
+static void publish_fila(MQTT_CLIENT_DATA_T *state) {
+    static uint32_t ultima_profundidade, ultimos_descartados, ultima_drenagem;
+    uint32_t profundidade = fila_profundidade(&fila);
+    if (profundidade == ultima_profundidade && fila.descartados == ultimos_descartados &&
+        fila.drenagem_ms == ultima_drenagem) return;
+    ultima_profundidade = profundidade;
+    ultimos_descartados = fila.descartados;
+    ultima_drenagem = fila.drenagem_ms;
+
+    char msg[40];
+    const char *queue_key = topico(TOPICO_QUEUE);
+    snprintf(msg, sizeof(msg), "%u,%u,%u", (unsigned)profundidade, (unsigned)fila.descartados, (unsigned)fila.drenagem_ms);
+    INFO_printf("Publishing %s to %s\n", msg, queue_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_QUEUE, msg, strlen(msg));
+}
+
+// Soma dos contadores da fila de saída, para publicar só quando algum muda
+static uint32_t soma_saida(void) {
+    uint32_t soma = saida.num_max + saida.usados_max + saida.adiadas + saida.substituidas + saida.erros;
+    for (uint8_t i = 0; i < NUM_CLASSES_SAIDA; i++) soma += saida.descartadas[i];
+    return soma;
+}
+
+// Publicar ocupação e descartes da fila de saída quando algum mudar
+static void publish_saida(MQTT_CLIENT_DATA_T *state) {
+    static uint32_t ultima_soma;
+    if (soma_saida() == ultima_soma) return;
+
+    char msg[96];
+    const char *outbound_key = topico(TOPICO_OUTBOUND);
+    // O reenvio nunca espera na fila de saída, então não tem descartes
+    snprintf(msg, sizeof(msg), "%u,%u,%u,%u,%u,%u,%u,%u,%u,%u", saida.num, saida.num_max, saida.usados_max,
+             (unsigned)saida.adiadas, (unsigned)saida.substituidas, (unsigned)saida.erros,
+             (unsigned)saida.descartadas[SAIDA_CONTROLE], (unsigned)saida.descartadas[SAIDA_ESTADO],
+             (unsigned)saida.descartadas[SAIDA_TELEMETRIA], (unsigned)saida.descartadas[SAIDA_DIAGNOSTICO]);
+    saida_zerar_maximo(&saida); // Os máximos do próximo relatório começam na ocupação atual
+    ultima_soma = soma_saida();
+    INFO_printf("Publishing %s to %s\n", msg, outbound_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_OUTBOUND, msg, strlen(msg));
+}
+
+// Conclusão de um reenvio (em ordem, como os PUBACKs): confirmado, o registro sai da fila
+// offline; com erro ou tempo esgotado, o reenvio recomeça dele. Libera um lugar na janela.
+static void reenvio_request_cb(void *arg, err_t err) {
+    if (err != 0) {
+        ERROR_printf("reenvio_request_cb failed %d", err);
+    }
+    fila_confirmado(&fila, err == ERR_OK, to_ms_since_boot(get_absolute_time()));
+    saida_confirmar(&saida, SAIDA_REENVIO);
+    if (!saida_vazia(&saida)) agendar_saida((MQTT_CLIENT_DATA_T*)arg, 0);
+}
+
+// Reenvia os registros mais antigos em /backlog ("<tópico>,<instante_ms>,<valor>") pela fila de
+// saída, na classe menos urgente. A janela da classe deixa lugares em MQTT_REQ_MAX_IN_FLIGHT
+// para o estado do portão e o /ping. Cada registro só sai da fila offline com o PUBACK.
+static void reenvio_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
+    METRICA_INICIO(inicio);
+    MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)worker->user_data;
+    if (!state->connect_done) return; // Retomado na próxima conexão
+
+    const char *backlog_key = topico(TOPICO_BACKLOG);
+    const fila_registro_t *r;
+    // Só quando o registro vai direto ao cliente: com tráfego ao vivo esperando, a janela cheia
+    // ou o cliente sem espaço, ele continua na fila offline para a próxima rodada
+    for (int i = 0; i < FILA_REENVIO_RODADA && (r = fila_proximo(&fila)); i++) {
+        char msg[64];
+        int len = snprintf(msg, sizeof(msg), "%s,%lu,%.*s", NOMES_TOPICOS[r->topico],
+                           (unsigned long)r->instante_ms, r->tamanho, (const char *)r->payload);
+        // Sem retain: um valor antigo nunca substitui o estado retido atual
+        if (!saida_tentar(&saida, SAIDA_REENVIO, backlog_key, msg, len, false)) break;
+        fila_enviado(&fila);
+    }
+    if (fila_profundidade(&fila)) {
+        async_context_add_at_time_worker_in_ms(context, worker, FILA_REENVIO_MS);
+    }
+    METRICA_FIM(&metricas[FASE_PUBLICACAO], inicio);
+}
+
+// Avalia cada tópico de telemetria pela sua política. Chamada quando chega um valor novo
+// e pelo worker, que fica agendado para o primeiro heartbeat ou fim de intervalo mínimo.
+// Sem conexão, o que seria publicado vai para a fila.
+static void publicar_telemetria(MQTT_CLIENT_DATA_T *state) {
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+
+    if (telemetria_avaliar(&telemetria_status, estado_publicado, agora)) {
+        publish_status(state);
+    }
+    uint32_t espera = telemetria_espera_ms(&telemetria_status, estado_publicado, agora);
+
+    if (telemetria_avaliar(&telemetria_distancia, distancia_publicada, agora)) {
+        publish_distance(state, TOPICO_DISTANCE, distancia_publicada);
+    }
+    uint32_t e = telemetria_espera_ms(&telemetria_distancia, distancia_publicada, agora);
+    if (e < espera) espera = e;
+
+    // Com mais de um sensor, publica também cada um em /distance/<n>
+    for (uint8_t i = 0; NUM_SENSORES > 1 && i < NUM_SENSORES; i++) {
+        if (telemetria_avaliar(&telemetria_sensor[i], distancia_sensor[i], agora)) {
+            publish_distance(state, TOPICO_DISTANCE_SENSOR + i, distancia_sensor[i]);
+        }
+        e = telemetria_espera_ms(&telemetria_sensor[i], distancia_sensor[i], agora);
+        if (e < espera) espera = e;
+    }
+
+    async_context_t *contexto = cyw43_arch_async_context();
+    async_context_remove_at_time_worker(contexto, &telemetria_worker);
+    if (espera != UINT32_MAX) {
+        telemetria_worker.user_data = state;
+        async_context_add_at_time_worker_in_ms(contexto, &telemetria_worker, espera);
+    }
+}
+
+static void telemetria_worker_fn(__unused async_context_t *context, async_at_time_worker_t *worker) {
+    METRICA_INICIO(inicio);
+    publicar_telemetria((MQTT_CLIENT_DATA_T*)worker->user_data);
+    METRICA_FIM(&metricas[FASE_PUBLICACAO], inicio);
+}
+
+#if DIST_LOTE_ATIVO
+// Publicar o quadro de distâncias; sem conexão as amostras são descartadas
+static void publish_batch(MQTT_CLIENT_DATA_T *state) {
+    async_context_remove_at_time_worker(cyw43_arch_async_context(), &lote_worker);
+    if (lote_vazio(&lote_distancia)) return;
+
+    uint16_t tamanho = lote_fechar(&lote_distancia);
+    if (state->connect_done) {
+        const char *batch_key = topico(TOPICO_DISTANCE_BATCH);
+        INFO_printf("Publishing %u samples (%u bytes) to %s\n", lote_distancia.n, tamanho, batch_key);
+        publicar(state, SAIDA_TELEMETRIA, TOPICO_DISTANCE_BATCH, lote_distancia.quadro, tamanho);
+    }
+    lote_limpar(&lote_distancia);
+}
+
+static void adicionar_lote(MQTT_CLIENT_DATA_T *state, const evento_t *evento) {
+    bool primeira = lote_vazio(&lote_distancia);
+    if (lote_adicionar(&lote_distancia, evento->instante_ms, evento->valor[0])) {
+        publish_batch(state);
+    } else if (primeira) {
+        uint32_t agora = to_ms_since_boot(get_absolute_time());
+        lote_worker.user_data = state;
+        async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &lote_worker,
+                                               lote_espera_ms(&lote_distancia, agora));
+    }
+}
+
+static void lote_worker_fn(__unused async_context_t *context, async_at_time_worker_t *worker) {
+    METRICA_INICIO(inicio);
+    publish_batch((MQTT_CLIENT_DATA_T*)worker->user_data);
+    METRICA_FIM(&metricas[FASE_PUBLICACAO], inicio);
+}
+#endif
+
+// Consumir os eventos do core1: atualiza as cópias locais e publica o que é imediato
+static void eventos_worker_fn(__unused async_context_t *context, async_when_pending_worker_t *worker) {
+    METRICA_INICIO(inicio);
     MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)worker->user_data;
-    publish_distance(state);
-    async_context_add_at_time_worker_in_ms(context, worker, DIST_WORKER_TIME_S * 1000);
+    evento_t evento;
+    bool telemetria = false;
+    while (canal_receber(&canal_core1, &evento)) {
+        switch (evento.tipo) {
+            case EVENTO_DISTANCIA:
+            if (evento.origem == CANAL_ORIGEM_FUSAO) {
+                distancia_publicada = evento.valor[0];
+#if DIST_LOTE_ATIVO
+                adicionar_lote(state, &evento);
+#endif
+            } else if (evento.origem < SENSORES_MAX) {
+                distancia_sensor[evento.origem] = evento.valor[0];
+            }
+            telemetria = true;
+            break;
+
+            case EVENTO_ESTADO:
+            // Transição sai na hora, junto com a distância que a causou
+            estado_publicado = (EstadoSistema)evento.origem;
+            telemetria_forcar(&telemetria_status);
+            telemetria_forcar(&telemetria_distancia);
+            telemetria = true;
+            break;
+
+            case EVENTO_PREVISAO:
+            previsao_publicada = evento;
+            if (state->connect_done) publish_predicted(state); // Presença prevista é publicada assim que detectada
+            break;
+
+            case EVENTO_AMOSTRAGEM:
+            if (state->connect_done) publish_sampler(state, &evento);
+            break;
+
+            case EVENTO_CPU:
+            if (state->connect_done) {
+                publish_cpu(state, &evento);
+                publish_inbound(state); // Mesma cadência do relatório de CPU
+                publish_fila(state);
+                publish_saida(state);
+            }
+            break;
+
+            case EVENTO_DISPLAY:
+            if (state->connect_done) publish_display(state, &evento);
+            break;
+        }
+    }
+    if (telemetria) publicar_telemetria(state);
+    METRICA_FIM(&metricas[FASE_EVENTOS], inicio);
 }
 
-// publicar status do sistema
-static void publish_status_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
+#if METRICAS_ATIVAS
+// Publicar histogramas de latência de cada fase, numa única mensagem
+static void metricas_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
     MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)worker->user_data;
-    publish_status(state);
-    async_context_add_at_time_worker_in_ms(context, worker, STATUS_WORKER_TIME_S * 800);
+    static char msg[METRICAS_MSG_TAM];
+    const char *metricas_key = topico(TOPICO_METRICS);
+    int len = state->connect_done ? metricas_formatar(metricas, NUM_METRICAS, msg, sizeof(msg)) : 0;
+    if (len > 0) {
+        INFO_printf("Publishing %s to %s\n", msg, metricas_key);
+        publicar(state, SAIDA_DIAGNOSTICO, TOPICO_METRICS, msg, len);
+    }
+    async_context_add_at_time_worker_in_ms(context, worker, METRICAS_WORKER_TIME_S * 1000);
 }
+#endif
 
 // Conexão MQTT
 static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status) {
     MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)arg;
     if (status == MQTT_CONNECT_ACCEPTED) {
+        INFO_printf("Connected to mqtt server\n");
         state->connect_done = true;
+        uint32_t agora = to_ms_since_boot(get_absolute_time());
+        reconexao_sucesso(&reconexao_mqtt, agora);
+        boot_fim(&boot, BOOT_MQTT);
+        state->endereco_cache = false;
+        // O lwIP sempre abre sessão limpa: as assinaturas são refeitas a cada conexão
         sub_unsub_topics(state, true); // subscribe;
 
         // indicate online
         if (state->mqtt_client_info.will_topic) {
-            mqtt_publish(state->mqtt_client_inst, state->mqtt_client_info.will_topic, "1", 1, MQTT_WILL_QOS, true, pub_request_cb, state);
+            saida_publicar(&saida, SAIDA_ESTADO, state->mqtt_client_info.will_topic, "1", 1, true, false);
         }
 
-        // Publish distance every 10 sec if it's changed
-        distance_worker.user_data = state;
-        async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &distance_worker, 0);
-
-        // Adicione esta linha para ativar o worker de status:
-        publish_status_worker.user_data = state;
-        async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &publish_status_worker, 0);
-    } else if (status == MQTT_CONNECT_DISCONNECTED) {
-        if (!state->connect_done) {
-            panic("Failed to connect to mqtt server");
+        // Distância e status publicados por exceção; na conexão, todos saem uma vez
+        telemetria_forcar(&telemetria_status);
+        telemetria_forcar(&telemetria_distancia);
+        for (int i = 0; i < SENSORES_MAX; i++) {
+            telemetria_forcar(&telemetria_sensor[i]);
         }
+        publicar_telemetria(state);
+        if (reconexao_mqtt.quedas) publish_reconnect(state);
+        if (!boot_publicado) publish_boot(state);
+        // O que a fila de saída segurou antes da queda, e a rajada da conexão que não coube
+        if (!saida_vazia(&saida)) agendar_saida(state, 0);
+#if CACHE_BOOT_ATIVO
+        gravar_cache_boot(state);
+#endif
+
+        // O que ficou guardado durante a queda sai depois do estado atual, em ritmo limitado
+        async_context_t *contexto = cyw43_arch_async_context();
+        saida_reabrir(&saida);
+        fila_reenviar(&fila); // Os reenvios sem PUBACK da conexão anterior se perderam com ela
+        fila_drenagem_comecar(&fila, to_ms_since_boot(get_absolute_time()));
+        reenvio_worker.user_data = state;
+        async_context_remove_at_time_worker(contexto, &reenvio_worker);
+        async_context_add_at_time_worker_in_ms(contexto, &reenvio_worker, FILA_REENVIO_MS);
+
+#if METRICAS_ATIVAS
+        // Histogramas de latência por fase
+        metricas_worker.user_data = state;
+        async_context_remove_at_time_worker(contexto, &metricas_worker);
+        async_context_add_at_time_worker_in_ms(contexto, &metricas_worker, METRICAS_WORKER_TIME_S * 1000);
+#endif
+        async_context_remove_at_time_worker(contexto, &enlace_worker);
+        async_context_add_at_time_worker_in_ms(contexto, &enlace_worker, ENLACE_VERIFICACAO_MS);
+    } else {
+        // Queda, recusa ou tempo esgotado: a telemetria passa para a fila e a conexão é refeita
+        ERROR_printf("mqtt connection lost (status %d)\n", status);
+        perder_conexao(state);
     }
-    else {
-        panic("Unexpected status");
+}
+
+// Publicar quedas do broker e tempo até a reconexão (da queda ao CONNACK)
+static void publish_reconnect(MQTT_CLIENT_DATA_T *state) {
+    char msg[48];
+    const char *reconnect_key = topico(TOPICO_RECONNECT);
+    snprintf(msg, sizeof(msg), "%u,%u,%u,%u", (unsigned)reconexao_mqtt.quedas, (unsigned)reconexao_wifi.quedas,
+             (unsigned)reconexao_mqtt.recuperacao_ms, (unsigned)reconexao_mqtt.recuperacao_max_ms);
+    INFO_printf("Publishing %s to %s\n", msg, reconnect_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_RECONNECT, msg, strlen(msg));
+}
+
+// Agenda o conexao_worker com a espera do recuo
+static void agendar_conexao(MQTT_CLIENT_DATA_T *state, reconexao_t *r) {
+    uint32_t espera = reconexao_espera_ms(r);
+    INFO_printf("Retrying in %u ms\n", (unsigned)espera);
+    async_context_remove_at_time_worker(cyw43_arch_async_context(), &conexao_worker);
+    async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &conexao_worker, espera);
+}
+
+static void perder_conexao(MQTT_CLIENT_DATA_T *state) {
+    state->connect_done = false;
+    state->subscribe_count = 0;
+    if (state->endereco_cache) {
+        // O IP guardado não atendeu: a próxima tentativa passa pelo DNS
+        state->endereco_cache = false;
+        state->endereco_ok = false;
+        boot_rapido = false;
     }
+    async_context_remove_at_time_worker(cyw43_arch_async_context(), &enlace_worker);
+    if (state->stop_client) return;
+    reconexao_queda(&reconexao_mqtt, to_ms_since_boot(get_absolute_time()));
+    agendar_conexao(state, &reconexao_mqtt);
 }
 
-// Inicializar o cliente MQTT
+// Inicializar o cliente MQTT; a primeira tentativa sai já
 static void start_client(MQTT_CLIENT_DATA_T *state) {
 #if LWIP_ALTCP && LWIP_ALTCP_TLS
-    const int port = MQTT_TLS_PORT;
     INFO_printf("Using TLS\n");
 #else
-    const int port = MQTT_PORT;
     INFO_printf("Warning: Not using TLS\n");
 #endif
 
@@ -541,28 +1580,177 @@ static void start_client(MQTT_CLIENT_DATA_T *state) {
     if (!state->mqtt_client_inst) {
         panic("MQTT client instance creation error");
     }
-    INFO_printf("IP address of this device %s\n", ipaddr_ntoa(&(netif_list->ip_addr)));
+#if CACHE_BOOT_ATIVO
+    if (cache_boot_ler(CACHE_BOOT_OFFSET, cache_boot_chave(WIFI_SSID, MQTT_SERVER), &cache_boot)) {
+        cache_wifi = true;
+        ip_addr_set_ip4_u32(&state->mqtt_server_address, cache_boot.broker_ip);
+        state->endereco_ok = state->endereco_cache = true;
+        INFO_printf("Boot cache: channel %u, broker %s\n", cache_boot.canal, ipaddr_ntoa(&state->mqtt_server_address));
+    } else {
+        boot_rapido = false;
+    }
+#endif
+    conexao_worker.user_data = state;
+    enlace_worker.user_data = state;
+    async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &conexao_worker, 0);
+}
+
+#if CACHE_BOOT_ATIVO
+// Só grava quando algo mudou (troca de AP, de canal ou de IP do broker)
+static void gravar_cache_boot(MQTT_CLIENT_DATA_T *state) {
+    cache_boot_t novo = { .chave = cache_boot_chave(WIFI_SSID, MQTT_SERVER) };
+    uint8_t canal[12]; // channel_info_t: canal atual, canal alvo, canal da varredura
+    if (cyw43_wifi_get_bssid(&cyw43_state, novo.bssid) != 0 ||
+        cyw43_ioctl(&cyw43_state, CYW43_IOCTL_GET_CHANNEL, sizeof(canal), canal, CYW43_ITF_STA) != 0) {
+        return;
+    }
+    novo.canal = canal[0];
+    novo.broker_ip = ip_addr_get_ip4_u32(&state->mqtt_server_address);
+    if (!cache_boot_gravar(CACHE_BOOT_OFFSET, &novo)) {
+        ERROR_printf("Boot cache write failed\n");
+    }
+}
+#endif
+
+// Publicar o resumo do boot ("modo,inicio_ms,wifi_ms,dns_ms,mqtt_ms,total_ms") e todas as etapas
+static void publish_boot(MQTT_CLIENT_DATA_T *state) {
+    char msg[64];
+    const char *boot_key = topico(TOPICO_BOOT);
+    snprintf(msg, sizeof(msg), "%s,%u,%u,%u,%u,%u", boot_rapido ? "cache" : "completo",
+             (unsigned)boot.etapas[BOOT_WIFI].inicio_ms,
+             (unsigned)boot_duracao_ms(&boot, BOOT_WIFI),
+             (unsigned)boot_duracao_ms(&boot, BOOT_DNS),
+             (unsigned)boot_duracao_ms(&boot, BOOT_MQTT),
+             (unsigned)boot.etapas[BOOT_MQTT].fim_ms);
+    INFO_printf("Publishing %s to %s\n", msg, boot_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_BOOT, msg, strlen(msg));
+
+    static char trace[METRICAS_MSG_TAM];
+    const char *trace_key = topico(TOPICO_BOOT_TRACE);
+    int len = boot_formatar(&boot, trace, sizeof(trace));
+    INFO_printf("Publishing %s to %s\n", trace, trace_key);
+    publicar(state, SAIDA_DIAGNOSTICO, TOPICO_BOOT_TRACE, trace, len);
+    boot_publicado = true;
+}
+
+// mqtt_client_connect zera o cliente, então os callbacks de entrada são refeitos a cada conexão
+static void conectar_broker(MQTT_CLIENT_DATA_T *state) {
+#if LWIP_ALTCP && LWIP_ALTCP_TLS
+    const int port = MQTT_TLS_PORT;
+#else
+    const int port = MQTT_PORT;
+#endif
     INFO_printf("Connecting to mqtt server at %s\n", ipaddr_ntoa(&state->mqtt_server_address));
 
+    boot_inicio(&boot, BOOT_MQTT); // Só a primeira tentativa conta
     cyw43_arch_lwip_begin();
-    if (mqtt_client_connect(state->mqtt_client_inst, &state->mqtt_server_address, port, mqtt_connection_cb, state, &state->mqtt_client_info) != ERR_OK) {
-        panic("MQTT broker connection error");
-    }
+    err_t err = mqtt_client_connect(state->mqtt_client_inst, &state->mqtt_server_address, port, mqtt_connection_cb, state, &state->mqtt_client_info);
+    if (err == ERR_OK) {
 #if LWIP_ALTCP && LWIP_ALTCP_TLS
-    // This is important for MBEDTLS_SSL_SERVER_NAME_INDICATION
-    mbedtls_ssl_set_hostname(altcp_tls_context(state->mqtt_client_inst->conn), MQTT_SERVER);
+        // This is important for MBEDTLS_SSL_SERVER_NAME_INDICATION
+        mbedtls_ssl_set_hostname(altcp_tls_context(state->mqtt_client_inst->conn), MQTT_SERVER);
 #endif
-    mqtt_set_inpub_callback(state->mqtt_client_inst, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, state);
+        mqtt_set_inpub_callback(state->mqtt_client_inst, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, state);
+    } else {
+        // Sem memória ou rede para abrir a conexão: tenta de novo mais tarde
+        ERROR_printf("mqtt_client_connect failed %d\n", err);
+        agendar_conexao(state, &reconexao_mqtt);
+    }
     cyw43_arch_lwip_end();
 }
 
+// Cada execução avança uma etapa: associação ao Wi-Fi, DNS, conexão com o broker. As etapas
+// assíncronas (associação, DNS, CONNACK) continuam por verificação periódica ou callback.
+static void conexao_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
+    MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)worker->user_data;
+    if (state->stop_client || state->connect_done || mqtt_client_is_connected(state->mqtt_client_inst)) return;
+
+    int enlace = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+    if (enlace != CYW43_LINK_UP) {
+        if (enlace == CYW43_LINK_JOIN || enlace == CYW43_LINK_NOIP) {
+            async_context_add_at_time_worker_in_ms(context, worker, ENLACE_VERIFICACAO_MS); // Em andamento
+        } else if (state->associando && cache_wifi) {
+            // O AP guardado não respondeu: volta já para a associação com varredura
+            ERROR_printf("Cached Wi-Fi join failed %d\n", enlace);
+            state->associando = false;
+            cache_wifi = false;
+            boot_rapido = false;
+            async_context_add_at_time_worker_in_ms(context, worker, 0);
+        } else if (state->associando) {
+            // A associação pedida falhou (rede ausente, senha errada): espera o recuo
+            ERROR_printf("Wi-Fi join failed %d\n", enlace);
+            state->associando = false;
+            agendar_conexao(state, &reconexao_wifi);
+        } else {
+            INFO_printf("Joining %s%s\n", WIFI_SSID, cache_wifi ? " (cached BSSID)" : "");
+            state->associando = true;
+            boot_inicio(&boot, BOOT_WIFI);
+            int err;
+            if (cache_wifi) {
+                // BSSID e canal conhecidos: a associação não varre os canais
+                err = cyw43_wifi_join(&cyw43_state, strlen(WIFI_SSID), (const uint8_t *)WIFI_SSID,
+                                      strlen(WIFI_PASSWORD), (const uint8_t *)WIFI_PASSWORD,
+                                      CYW43_AUTH_WPA2_AES_PSK, cache_boot.bssid, cache_boot.canal);
+            } else {
+                err = cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK);
+            }
+            if (err != 0) {
+                state->associando = false;
+                agendar_conexao(state, &reconexao_wifi);
+            } else {
+                async_context_add_at_time_worker_in_ms(context, worker, ENLACE_VERIFICACAO_MS);
+            }
+        }
+        return;
+    }
+    if (state->associando) {
+        state->associando = false;
+        reconexao_sucesso(&reconexao_wifi, to_ms_since_boot(get_absolute_time()));
+        boot_fim(&boot, BOOT_WIFI);
+        boot_inicio(&boot, BOOT_DNS);
+        INFO_printf("Connected to Wifi, IP address %s\n", ipaddr_ntoa(&(netif_list->ip_addr)));
+    }
+
+    if (!state->endereco_ok) {
+        err_t err = dns_gethostbyname(MQTT_SERVER, &state->mqtt_server_address, dns_found, state);
+        if (err == ERR_INPROGRESS) return; // dns_found continua
+        if (err != ERR_OK) {
+            ERROR_printf("dns request failed %d\n", err);
+            agendar_conexao(state, &reconexao_mqtt);
+            return;
+        }
+        state->endereco_ok = true;
+    }
+    boot_fim(&boot, BOOT_DNS);
+    conectar_broker(state);
+}
+
+// Sem enlace, o TCP só perceberia a queda pelo keep alive; desconecta já e recomeça pela associação
+static void enlace_worker_fn(async_context_t *context, async_at_time_worker_t *worker) {
+    MQTT_CLIENT_DATA_T* state = (MQTT_CLIENT_DATA_T*)worker->user_data;
+    if (!state->connect_done) return;
+    if (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP) {
+        async_context_add_at_time_worker_in_ms(context, worker, ENLACE_VERIFICACAO_MS);
+        return;
+    }
+    ERROR_printf("Wi-Fi link lost\n");
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    reconexao_queda(&reconexao_wifi, agora);
+    state->endereco_ok = false;
+    mqtt_disconnect(state->mqtt_client_inst);
+    perder_conexao(state);
+}
+
 // Call back com o resultado do DNS
-static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg) {
+static void dns_found(__unused const char *hostname, const ip_addr_t *ipaddr, void *arg) {
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T*)arg;
     if (ipaddr) {
         state->mqtt_server_address = *ipaddr;
-        start_client(state);
+        state->endereco_ok = true;
+        boot_fim(&boot, BOOT_DNS);
+        conectar_broker(state);
     } else {
-        panic("dns request failed");
+        ERROR_printf("dns request failed\n");
+        agendar_conexao(state, &reconexao_mqtt);
     }
-}
\ No newline at end of file
+}
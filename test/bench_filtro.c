@@ -0,0 +1,102 @@
+// Filtro incremental contra getCmFiltered (6 leituras bloqueantes, 15 ms entre elas, bubble sort)
+// sobre os mesmos traços. Para cada um: valores filtrados por segundo, tempo até cada valor no
+// relógio virtual, custo no host e erro médio contra a distância real.
+//
+// Uso: bench_filtro [traço.csv ...]   (sem argumentos, usa os traços sintéticos)
+
+#include <string.h>
+#include "teste.h"
+#include "tracos.h"
+#include "filtro.h"
+#include "hcSR04.h"
+
+#define AMOSTRAS_MAX 20000
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CICLOS() __rdtsc()
+#else
+#define CICLOS() 0ull
+#endif
+
+// Eco do traço: cada disparo do getCmFiltered consome a próxima amostra
+typedef struct {
+    const traco_amostra_t *a;
+    size_t n, i;
+} leitor_t;
+
+static uint32_t eco_traco(void *dados) {
+    leitor_t *l = dados;
+    uint32_t cm = l->a[l->i % l->n].medida_cm;
+    l->i++;
+    return cm * 58;
+}
+
+static void comparar(const char *nome, const traco_amostra_t *a, size_t n) {
+    // getCmFiltered: cada valor consome 6 disparos e o tempo de espera correspondente
+    mock_reiniciar();
+    leitor_t l = { a, n, 0 };
+    mock_eco(eco_traco, &l);
+    size_t valores_antigo = 0;
+    double erro_antigo = 0.0;
+    uint64_t virtual = mock_agora_us, host = teste_ns(), ciclos = CICLOS();
+    while (l.i + 6 <= n) {
+        float real = a[l.i + 3].real_cm;
+        uint64_t cm = getCmFiltered(16, 17, 6);
+        erro_antigo += fabs((double)cm - real);
+        valores_antigo++;
+    }
+    double antigo_ms = (mock_agora_us - virtual) / 1000.0 / valores_antigo;
+    double antigo_ns = (double)(teste_ns() - host) / valores_antigo;
+    double antigo_ciclos = (double)(CICLOS() - ciclos) / valores_antigo;
+
+    // Filtro: um valor por amostra válida, custo só do cálculo
+    double erro[3] = {0}, ns[3], cic[3];
+    size_t valores = 0;
+    for (int modo = 0; modo < 3; modo++) {
+        filtro_t f;
+        filtro_init(&f, modo, 5, 1000);
+        valores = 0;
+        uint64_t t0 = teste_ns(), c0 = CICLOS();
+        for (size_t i = 0; i < n; i++) {
+            uint32_t cm = a[i].medida_cm;
+            if (cm < 2 || cm > 400) continue;
+            float saida = filtro_inserir(&f, (float)cm, a[i].instante_ms);
+            erro[modo] += fabsf(saida - a[i].real_cm);
+            valores++;
+        }
+        ns[modo] = (double)(teste_ns() - t0) / valores;
+        cic[modo] = (double)(CICLOS() - c0) / valores;
+        erro[modo] /= valores;
+    }
+    double duracao_s = a[n - 1].instante_ms / 1000.0;
+
+    printf("%s (%zu amostras, %.0f s)\n", nome, n, duracao_s);
+    // O getCmFiltered prende a CPU o tempo todo: a taxa é o inverso do tempo por valor
+    printf("  getCmFiltered   %6.1f valores/s  %9.1f us de CPU por valor  %8.0f ns %8.0f ciclos no host  erro %5.2f cm\n",
+           1000.0 / antigo_ms, antigo_ms * 1000.0, antigo_ns, antigo_ciclos, erro_antigo / valores_antigo);
+    static const char *const MODOS[3] = { "mediana", "hampel", "ema" };
+    for (int modo = 0; modo < 3; modo++) {
+        printf("  filtro %-8s %6.1f valores/s  %9.3f us de CPU por valor  %8.0f ns %8.0f ciclos no host  erro %5.2f cm\n",
+               MODOS[modo], valores / duracao_s, ns[modo] / 1000.0, ns[modo], cic[modo], erro[modo]);
+    }
+}
+
+int main(int argc, char **argv) {
+    static traco_amostra_t a[AMOSTRAS_MAX];
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            size_t n = traco_ler_csv(argv[i], a, AMOSTRAS_MAX);
+            if (n < 6) {
+                fprintf(stderr, "bench_filtro: %s vazio ou ilegível\n", argv[i]);
+                return 1;
+            }
+            comparar(argv[i], a, n);
+        }
+        return 0;
+    }
+    for (int t = 0; t < NUM_TRACOS; t++) {
+        comparar(NOMES_TRACOS[t], a, traco_gerar(t, a, AMOSTRAS_MAX));
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Custo de uma amostra do HC-SR04: getPulse (espera ativa pelo eco) contra o motor do PIO
+// (disparo, interrupção e leitura do buffer). O tempo de CPU preso em cada amostra é medido
+// no relógio virtual; o custo das instruções, no relógio do host.
+//
+// Uso: bench_hcsr04 [amostras]
+
+#include <stdlib.h>
+#include "teste.h"
+#include "hcSR04.h"
+
+static uint32_t eco_sorteado(void *dados) {
+    (void)dados;
+    return 580 + (uint32_t)(rand() % 20000); // 10 cm a ~3,5 m
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 20000;
+    mock_reiniciar();
+    srand(1);
+
+    // Espera ativa: a CPU fica presa do disparo ao fim do eco
+    mock_eco(eco_sorteado, NULL);
+    uint64_t virtual = mock_agora_us;
+    uint64_t inicio = teste_ns();
+    uint64_t soma = 0;
+    for (int i = 0; i < n; i++) soma += getPulse(16, 17);
+    uint64_t host_bloqueante = teste_ns() - inicio;
+    uint64_t cpu_bloqueante = mock_agora_us - virtual;
+
+    // Motor do PIO: a CPU só dispara e, depois da interrupção, lê o buffer. O eco corre
+    // fora da CPU, então o relógio virtual só anda nas chamadas.
+    hcsr04_t s;
+    hcsr04_init(&s, 16, 17);
+    hcsr04_amostra_t a;
+    uint64_t cpu_pio = 0, host_pio = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t eco = eco_sorteado(NULL);
+        virtual = mock_agora_us;
+        inicio = teste_ns();
+        hcsr04_disparar(&s);
+        uint64_t parcial = teste_ns() - inicio;
+        cpu_pio += mock_agora_us - virtual;
+
+        mock_pio_eco(s.pio, s.sm, eco); // Hardware: não conta como CPU do laço principal
+
+        virtual = mock_agora_us;
+        inicio = teste_ns();
+        while (hcsr04_ler(&s, &a)) soma += a.eco_us;
+        host_pio += parcial + teste_ns() - inicio;
+        cpu_pio += mock_agora_us - virtual;
+    }
+
+    printf("%d amostras\n", n);
+    printf("getPulse:    %8.1f us de CPU presa por amostra, %6.1f ns no host\n",
+           (double)cpu_bloqueante / n, (double)host_bloqueante / n);
+    printf("motor PIO:   %8.1f us de CPU presa por amostra, %6.1f ns no host\n",
+           (double)cpu_pio / n, (double)host_pio / n);
+    return soma == 0;
+}
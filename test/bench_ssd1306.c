@@ -0,0 +1,223 @@
+// Primitivas de desenho do SSD1306: as atuais (colunas de 64 bits) contra as antigas, pixel a
+// pixel (ref/ssd1306_antigo.c). Primeiro aplica a mesma sequência aleatória às duas e exige
+// buffers idênticos; depois mede o custo de cada primitiva no host. Por fim, os ícones gerados
+// por tools/img2ssd1306.c (crus e com RLE) desenhados com ssd1306_blit contra o drawImage antigo
+// sobre as imagens de assets/ em ARGB: mesmo ram_buffer e o custo de cada caminho.
+//
+// Uso: bench_ssd1306 [operações]   (padrão: 20000)
+
+#include <string.h>
+#include "teste.h"
+#include "ssd1306.h"
+#include "ref/ssd1306_antigo.h"
+#include "icones.h"
+#include "icones_rle.h"
+
+#define REPETICOES 20000
+
+static uint32_t semente = 2024;
+
+static uint32_t sorteio(uint32_t max) {
+    semente = semente * 1664525u + 1013904223u;
+    return (semente >> 8) % max;
+}
+
+typedef enum { OP_FILL, OP_RECT_CHEIO, OP_RECT, OP_HLINE, OP_VLINE, OP_LINE, OP_CHAR, OP_CHAR_DESALINHADO,
+               OP_STRING, OP_PIXEL, NUM_OPS } operacao_t;
+
+static const char *const NOMES_OPS[NUM_OPS] = {
+    "fill", "rect cheio", "rect", "hline", "vline", "line (diagonal)", "char alinhado",
+    "char desalinhado", "string (14)", "pixel",
+};
+
+// Parâmetros sempre dentro da tela: as primitivas antigas não recortam
+typedef struct {
+    uint8_t x0, y0, x1, y1;
+    bool valor;
+    char c;
+} parametros_t;
+
+static parametros_t sortear(operacao_t op) {
+    parametros_t p;
+    p.valor = sorteio(2);
+    p.c = ' ' + sorteio('~' - ' ' + 1);
+    p.x0 = sorteio(WIDTH);
+    p.y0 = sorteio(HEIGHT);
+    p.x1 = p.x0 + sorteio(WIDTH - p.x0);
+    p.y1 = p.y0 + sorteio(HEIGHT - p.y0);
+    if (op == OP_LINE) {
+        p.x1 = sorteio(WIDTH);
+        p.y1 = sorteio(HEIGHT);
+        if (p.x1 == p.x0) p.x1 = (p.x0 + 1) % WIDTH;
+        if (p.y1 == p.y0) p.y1 = (p.y0 + 1) % HEIGHT;
+    } else if (op == OP_CHAR || op == OP_CHAR_DESALINHADO || op == OP_STRING) {
+        p.x0 = sorteio(WIDTH - 8 + 1);
+        p.y0 = sorteio(HEIGHT - 8 + 1);
+        if (op == OP_CHAR) p.y0 &= ~7;
+        if (op == OP_CHAR_DESALINHADO) {
+            p.y0 = sorteio(HEIGHT - 8);
+            if ((p.y0 & 7) == 0) p.y0++;
+        }
+    }
+    return p;
+}
+
+static const char *const TEXTO = "Distancia: 123";
+
+typedef struct {
+    const char *arquivo;
+    const ssd1306_bitmap_t *cru, *rle;
+} icone_t;
+
+static const icone_t ICONES[] = {
+    { "cadeado_fechado.pbm", &ICONE_CADEADO_FECHADO, &ICONE_CADEADO_FECHADO_RLE },
+    { "cadeado_aberto.pbm", &ICONE_CADEADO_ABERTO, &ICONE_CADEADO_ABERTO_RLE },
+    { "alerta.pbm", &ICONE_ALERTA, &ICONE_ALERTA_RLE },
+};
+
+// A imagem de assets/ (PBM P1, 128x64) no formato que o drawImage recebia: ARGB por pixel
+static bool ler_argb(const char *arquivo, uint32_t argb[8192]) {
+    char caminho[256];
+    snprintf(caminho, sizeof(caminho), "%s/%s", DIRETORIO_ASSETS, arquivo);
+    FILE *f = fopen(caminho, "r");
+    if (!f) return false;
+    int c, n = 0, numeros = 0;
+    if (fgetc(f) != 'P' || fgetc(f) != '1') n = -1;
+    while (n >= 0 && n < 8192 && (c = fgetc(f)) != EOF) {
+        if (c == '#') {
+            while ((c = fgetc(f)) != EOF && c != '\n') {}
+        } else if (numeros < 2) {
+            // Largura e altura: as imagens são sempre da tela inteira
+            if (c >= '0' && c <= '9') {
+                int valor = 0;
+                for (; c >= '0' && c <= '9'; c = fgetc(f)) valor = valor * 10 + c - '0';
+                if (valor != (numeros ? HEIGHT : WIDTH)) n = -1;
+                numeros++;
+            }
+        } else if (c == '0' || c == '1') {
+            argb[n++] = c == '1' ? 0xFFFFFFFFu : 0x00000000u;
+        }
+    }
+    fclose(f);
+    return n == 8192;
+}
+
+static void desenhar(ssd1306_t *ssd, bool antigo, operacao_t op, const parametros_t *p) {
+    uint8_t largura = p->x1 - p->x0 + 1, altura = p->y1 - p->y0 + 1;
+    switch (op) {
+        case OP_FILL:
+        antigo ? antigo_fill(ssd, p->valor) : ssd1306_fill(ssd, p->valor);
+        break;
+        case OP_RECT_CHEIO:
+        case OP_RECT:
+        antigo ? antigo_rect(ssd, p->y0, p->x0, largura, altura, p->valor, op == OP_RECT_CHEIO)
+               : ssd1306_rect(ssd, p->y0, p->x0, largura, altura, p->valor, op == OP_RECT_CHEIO);
+        break;
+        case OP_HLINE:
+        antigo ? antigo_hline(ssd, p->x0, p->x1, p->y0, p->valor) : ssd1306_hline(ssd, p->x0, p->x1, p->y0, p->valor);
+        break;
+        case OP_VLINE:
+        antigo ? antigo_vline(ssd, p->x0, p->y0, p->y1, p->valor) : ssd1306_vline(ssd, p->x0, p->y0, p->y1, p->valor);
+        break;
+        case OP_LINE:
+        antigo ? antigo_line(ssd, p->x0, p->y0, p->x1, p->y1, p->valor)
+               : ssd1306_line(ssd, p->x0, p->y0, p->x1, p->y1, p->valor);
+        break;
+        case OP_CHAR:
+        case OP_CHAR_DESALINHADO:
+        antigo ? antigo_draw_char(ssd, p->c, p->x0, p->y0) : ssd1306_draw_char(ssd, p->c, p->x0, p->y0);
+        break;
+        case OP_STRING:
+        antigo ? antigo_draw_string(ssd, TEXTO, 0, p->y0) : ssd1306_draw_string(ssd, TEXTO, 0, p->y0);
+        break;
+        default:
+        antigo ? antigo_pixel(ssd, p->x0, p->y0, p->valor) : ssd1306_pixel(ssd, p->x0, p->y0, p->valor);
+        break;
+    }
+}
+
+static double medir(ssd1306_t *ssd, bool antigo, operacao_t op, const parametros_t *p, int n) {
+    uint64_t inicio = teste_ns();
+    for (int i = 0; i < n; i++) desenhar(ssd, antigo, op, &p[i]);
+    return (double)(teste_ns() - inicio) / n;
+}
+
+int main(int argc, char **argv) {
+    int operacoes = argc > 1 ? atoi(argv[1]) : 20000;
+
+    ssd1306_t novo, antigo;
+    ssd1306_init(&novo, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    ssd1306_init(&antigo, WIDTH, HEIGHT, false, 0x3C, i2c0);
+
+    // Mesma sequência nas duas: os buffers têm que ser iguais a cada passo
+    int diferentes = 0;
+    for (int i = 0; i < operacoes; i++) {
+        // O fill apaga tudo: fica raro para a tela acumular desenhos
+        operacao_t op = sorteio(50) == 0 ? OP_FILL : (operacao_t)(1 + sorteio(NUM_OPS - 1));
+        parametros_t p = sortear(op);
+        desenhar(&novo, false, op, &p);
+        desenhar(&antigo, true, op, &p);
+        if (memcmp(&novo.ram_buffer[1], &antigo.ram_buffer[1], novo.bufsize - 1) != 0) diferentes++;
+        if (ssd1306_is_empty(&novo) != antigo_is_empty(&antigo)) diferentes++;
+    }
+    VERIFICA(diferentes == 0);
+    printf("%d operações aleatórias: %d com buffers diferentes\n\n", operacoes, diferentes);
+
+    static parametros_t p[REPETICOES];
+    printf("%-18s %12s %12s %8s\n", "primitiva", "antiga (ns)", "atual (ns)", "ganho");
+    for (operacao_t op = 0; op < NUM_OPS; op++) {
+        for (int i = 0; i < REPETICOES; i++) p[i] = sortear(op);
+        int n = op == OP_FILL || op == OP_RECT_CHEIO ? REPETICOES / 10 : REPETICOES;
+        double t_antigo = medir(&antigo, true, op, p, n);
+        double t_novo = medir(&novo, false, op, p, n);
+        printf("%-18s %12.1f %12.1f %7.1fx\n", NOMES_OPS[op], t_antigo, t_novo, t_antigo / t_novo);
+    }
+
+    // is_empty com a tela vazia percorre o buffer inteiro
+    ssd1306_fill(&novo, false);
+    antigo_fill(&antigo, false);
+    volatile bool vazio = true;
+    uint64_t inicio = teste_ns();
+    for (int i = 0; i < REPETICOES; i++) vazio &= antigo_is_empty(&antigo);
+    double t_antigo = (double)(teste_ns() - inicio) / REPETICOES;
+    inicio = teste_ns();
+    for (int i = 0; i < REPETICOES; i++) vazio &= ssd1306_is_empty(&novo);
+    double t_novo = (double)(teste_ns() - inicio) / REPETICOES;
+    VERIFICA(vazio);
+    printf("%-18s %12.1f %12.1f %7.1fx\n", "is_empty", t_antigo, t_novo, t_antigo / t_novo);
+
+    // Ícones: o blit dos bitmaps gerados tem que reproduzir o drawImage sobre a imagem de origem
+    static uint32_t argb[8192];
+    printf("\n%-18s %8s %8s %12s %12s %12s\n", "ícone", "bytes", "rle", "drawImage", "blit (ns)", "blit rle");
+    for (size_t i = 0; i < sizeof(ICONES) / sizeof(ICONES[0]); i++) {
+        const icone_t *icone = &ICONES[i];
+        VERIFICA(ler_argb(icone->arquivo, argb));
+        antigo_fill(&antigo, false);
+        antigo_draw_image(&antigo, argb);
+        ssd1306_fill(&novo, false);
+        ssd1306_blit(&novo, icone->cru);
+        VERIFICA(memcmp(&novo.ram_buffer[1], &antigo.ram_buffer[1], novo.bufsize - 1) == 0);
+        ssd1306_fill(&novo, false);
+        ssd1306_blit(&novo, icone->rle);
+        VERIFICA(memcmp(&novo.ram_buffer[1], &antigo.ram_buffer[1], novo.bufsize - 1) == 0);
+        ssd1306_fill(&novo, false);
+        drawImage(&novo, argb);
+        VERIFICA(memcmp(&novo.ram_buffer[1], &antigo.ram_buffer[1], novo.bufsize - 1) == 0);
+
+        // O drawImage só acende pixels: repetido sobre o mesmo buffer, faz o mesmo trabalho
+        int n = REPETICOES / 10;
+        inicio = teste_ns();
+        for (int k = 0; k < n; k++) antigo_draw_image(&antigo, argb);
+        t_antigo = (double)(teste_ns() - inicio) / n;
+        inicio = teste_ns();
+        for (int k = 0; k < REPETICOES; k++) ssd1306_blit(&novo, icone->cru);
+        t_novo = (double)(teste_ns() - inicio) / REPETICOES;
+        inicio = teste_ns();
+        for (int k = 0; k < REPETICOES; k++) ssd1306_blit(&novo, icone->rle);
+        double t_rle = (double)(teste_ns() - inicio) / REPETICOES;
+        printf("%-18s %8u %8u %12.1f %12.1f %12.1f\n", icone->arquivo, icone->cru->tamanho, icone->rle->tamanho,
+               t_antigo, t_novo, t_rle);
+    }
+
+    return teste_fim();
+}
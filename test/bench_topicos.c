@@ -0,0 +1,177 @@
+// Despacho das publicações recebidas: a cadeia de strcmp antiga (tópico e payload copiados para
+// buffers do estado, prefixo do cliente pulado) contra o registro com hash (lib/topicos.c) e a
+// entrega sem cópia (lib/entrada.c). Uma enxurrada de comandos aleatórios, 10% para tópicos sem
+// tratador, com 4, 8, 16 e 32 tópicos de comando; os dois caminhos têm que chamar os mesmos
+// tratadores.
+//
+// Uso: bench_topicos [mensagens]   (padrão: 2000000)
+
+#include <string.h>
+#include <strings.h>
+#include "teste.h"
+#include "topicos.h"
+#include "entrada.h"
+
+#define PREFIXO "/pico1a2b"
+#define COMANDOS_MAX 32
+#define OUTROS 22       // Tópicos só publicados, como no firmware
+#define DESCONHECIDOS 8
+#define MENSAGENS_DIFERENTES 4096
+
+static char nomes[COMANDOS_MAX + OUTROS][24];
+static const char *sufixos[COMANDOS_MAX + OUTROS];
+static char desconhecidos[DESCONHECIDOS][40];
+
+typedef struct {
+    const char *topico;
+    const char *payload;
+    uint16_t tamanho;
+    uint8_t esperado;   // Tratador que deve ser chamado (ENTRADA_NENHUM = nenhum)
+} mensagem_t;
+
+static mensagem_t mensagens[MENSAGENS_DIFERENTES];
+static char completos[COMANDOS_MAX][40];
+static uint32_t chamadas[2][COMANDOS_MAX + 1];
+
+static uint32_t semente = 4242;
+static uint32_t sorteio(uint32_t max) {
+    semente = semente * 1664525u + 1013904223u;
+    return (semente >> 8) % max;
+}
+
+// Os tratadores fazem o mínimo: o que se mede é o despacho. O do portão interpreta o payload.
+static void tratar(int caminho, uint8_t id, const char *dados, size_t tamanho) {
+    chamadas[caminho][id]++;
+    (void)dados;
+}
+
+// ---------------------------------------------------------------- Caminho antigo
+
+static struct {
+    char topic[64];
+    char data[512];
+    size_t len;
+} estado;
+
+static void antigo_publish_cb(const char *topic) {
+    strncpy(estado.topic, topic, sizeof(estado.topic) - 1);
+}
+
+static void antigo_data_cb(const uint8_t *data, uint16_t len, uint8_t num) {
+    const char *basic_topic = estado.topic + strlen(PREFIXO);
+    strncpy(estado.data, (const char *)data, len);
+    estado.len = len;
+    estado.data[len] = '\0';
+
+    for (uint8_t id = 0; id < num; id++) {
+        if (strcmp(basic_topic, sufixos[id]) == 0) {
+            if (id == 0) {
+                if (strcasecmp(estado.data, "Open") == 0 || strcmp(estado.data, "1") == 0 ||
+                    strcasecmp(estado.data, "Close") == 0 || strcmp(estado.data, "0") == 0) {
+                    tratar(0, id, estado.data, estado.len);
+                }
+            } else {
+                tratar(0, id, estado.data, estado.len);
+            }
+            return;
+        }
+    }
+}
+
+// ---------------------------------------------------------------- Caminho atual
+
+static topicos_t topicos;
+static entrada_t entrada;
+static uint8_t buffer_entrada[1024];
+
+static int payload_portao(const char *dados, uint16_t len) {
+    switch (len) {
+        case 1: return dados[0] == '1' ? 1 : dados[0] == '0' ? 0 : -1;
+        case 4: return strncasecmp(dados, "open", 4) == 0 ? 1 : -1;
+        case 5: return strncasecmp(dados, "close", 5) == 0 ? 0 : -1;
+        default: return -1;
+    }
+}
+
+static void atual_publish_cb(const char *topic, uint32_t tot_len, uint8_t num) {
+    uint8_t id = topicos_buscar(&topicos, topic, strlen(topic));
+    entrada_comecar(&entrada, id < num ? id : ENTRADA_NENHUM, tot_len);
+}
+
+static void atual_data_cb(const uint8_t *data, uint16_t len) {
+    uint16_t tamanho;
+    const uint8_t *payload = entrada_fragmento(&entrada, data, len, true, &tamanho);
+    if (!payload) return;
+    if (entrada.id == 0) {
+        if (payload_portao((const char *)payload, tamanho) >= 0) tratar(1, 0, (const char *)payload, tamanho);
+    } else {
+        tratar(1, entrada.id, (const char *)payload, tamanho);
+    }
+}
+
+int main(int argc, char **argv) {
+    long total = argc > 1 ? atol(argv[1]) : 2000000;
+    static const char *const COMANDOS_FIRMWARE[] = { "/gate", "/print", "/ping", "/exit" };
+    static const char *const PAYLOADS[] = { "Open", "close", "1", "0", "talvez", "ola mundo", "" };
+
+    for (int i = 0; i < COMANDOS_MAX + OUTROS; i++) {
+        if (i < 4) {
+            strcpy(nomes[i], COMANDOS_FIRMWARE[i]);
+        } else if (i < COMANDOS_MAX) {
+            snprintf(nomes[i], sizeof(nomes[i]), "/cmd/%02d", i);
+        } else {
+            snprintf(nomes[i], sizeof(nomes[i]), "/telemetria/%02d", i - COMANDOS_MAX);
+        }
+        sufixos[i] = nomes[i];
+    }
+    for (int i = 0; i < DESCONHECIDOS; i++) snprintf(desconhecidos[i], sizeof(desconhecidos[i]), PREFIXO "/outro/%d", i);
+
+    printf("%-8s %14s %14s\n", "tópicos", "strcmp (ns)", "registro (ns)");
+    for (uint8_t num = 4; num <= COMANDOS_MAX; num *= 2) {
+        // Registro como no firmware: comandos primeiro, depois os tópicos só publicados
+        static const char *registro[COMANDOS_MAX + OUTROS];
+        for (int i = 0; i < num; i++) registro[i] = sufixos[i];
+        for (int i = 0; i < OUTROS; i++) registro[num + i] = sufixos[COMANDOS_MAX + i];
+        VERIFICA(topicos_init(&topicos, PREFIXO, registro, num + OUTROS));
+        entrada_init(&entrada, buffer_entrada, sizeof(buffer_entrada));
+        for (int i = 0; i < num; i++) snprintf(completos[i], sizeof(completos[i]), PREFIXO "%s", sufixos[i]);
+
+        for (int i = 0; i < MENSAGENS_DIFERENTES; i++) {
+            mensagem_t *m = &mensagens[i];
+            if (sorteio(10) == 0) {
+                m->topico = desconhecidos[sorteio(DESCONHECIDOS)];
+                m->esperado = ENTRADA_NENHUM;
+            } else {
+                m->esperado = sorteio(num);
+                m->topico = completos[m->esperado];
+            }
+            m->payload = PAYLOADS[sorteio(count_of(PAYLOADS))];
+            m->tamanho = strlen(m->payload);
+        }
+
+        memset(chamadas, 0, sizeof(chamadas));
+        uint64_t inicio = teste_ns();
+        for (long i = 0; i < total; i++) {
+            const mensagem_t *m = &mensagens[i & (MENSAGENS_DIFERENTES - 1)];
+            antigo_publish_cb(m->topico);
+            antigo_data_cb((const uint8_t *)m->payload, m->tamanho, num);
+        }
+        double t_antigo = (double)(teste_ns() - inicio) / total;
+
+        inicio = teste_ns();
+        for (long i = 0; i < total; i++) {
+            const mensagem_t *m = &mensagens[i & (MENSAGENS_DIFERENTES - 1)];
+            atual_publish_cb(m->topico, m->tamanho, num);
+            atual_data_cb((const uint8_t *)m->payload, m->tamanho);
+        }
+        double t_atual = (double)(teste_ns() - inicio) / total;
+
+        // Mesmos tratadores chamados, e os tópicos desconhecidos contados
+        VERIFICA(memcmp(chamadas[0], chamadas[1], sizeof(chamadas[0])) == 0);
+        uint32_t desconhecidas = 0;
+        for (long i = 0; i < total; i++) desconhecidas += mensagens[i & (MENSAGENS_DIFERENTES - 1)].esperado == ENTRADA_NENHUM;
+        VERIFICA(entrada.desconhecidas == desconhecidas);
+        printf("%-8u %14.1f %14.1f\n", num, t_antigo, t_atual);
+    }
+    return teste_fim();
+}
@@ -0,0 +1,13 @@
+// Substitui o cabeçalho gerado pelo pioasm: o programa é simulado em mock.c
+#ifndef MOCK_HCSR04_PIO_H
+#define MOCK_HCSR04_PIO_H
+
+#include "hardware/pio.h"
+
+static const pio_program_t hcsr04_program = { .length = 13, .origin = -1 };
+
+static inline void hcsr04_program_init(PIO pio, uint sm, uint offset, uint trig_pin, uint echo_pin) {
+    (void)pio; (void)sm; (void)offset; (void)trig_pin; (void)echo_pin;
+}
+
+#endif
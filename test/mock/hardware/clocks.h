@@ -0,0 +1,9 @@
+#ifndef MOCK_HARDWARE_CLOCKS_H
+#define MOCK_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+#define clk_sys 5
+static inline uint32_t clock_get_hz(int clock) { (void)clock; return 125000000; }
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef MOCK_HARDWARE_FLASH_H
+#define MOCK_HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+#define FLASH_PAGE_SIZE 256u
+#define FLASH_SECTOR_SIZE 4096u
+#define PICO_FLASH_SIZE_BYTES MOCK_FLASH_TAM
+#define XIP_BASE ((uintptr_t)mock_flash)
+
+void flash_range_erase(uint32_t offset, size_t tamanho);
+void flash_range_program(uint32_t offset, const uint8_t *dados, size_t tamanho);
+
+#endif
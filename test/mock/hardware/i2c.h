@@ -0,0 +1,31 @@
+#ifndef MOCK_HARDWARE_I2C_H
+#define MOCK_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// Barramento I2C sem periférico: as escritas são contadas e, se o teste instalar um ouvinte,
+// entregues a ele (ex: um painel simulado)
+typedef struct i2c_inst {
+    uint32_t escritas, bytes;
+    void (*ouvinte)(void *dados, uint8_t endereco, const uint8_t *bytes, size_t n);
+    void *dados_ouvinte;
+} i2c_inst_t;
+
+extern i2c_inst_t mock_i2c[2];
+#define i2c0 (&mock_i2c[0])
+#define i2c1 (&mock_i2c[1])
+
+#define GPIO_FUNC_I2C 3
+static inline void gpio_set_function(uint pino, uint funcao) { (void)pino; (void)funcao; }
+static inline void gpio_pull_up(uint pino) { (void)pino; }
+
+static inline uint i2c_init(i2c_inst_t *i2c, uint baudrate) { (void)i2c; return baudrate; }
+static inline int i2c_write_blocking(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t n, bool manter) {
+    (void)manter;
+    i2c->escritas++;
+    i2c->bytes += n;
+    if (i2c->ouvinte) i2c->ouvinte(i2c->dados_ouvinte, endereco, dados, n);
+    return (int)n;
+}
+
+#endif
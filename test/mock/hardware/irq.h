@@ -0,0 +1,14 @@
+#ifndef MOCK_HARDWARE_IRQ_H
+#define MOCK_HARDWARE_IRQ_H
+
+#include "pico/stdlib.h"
+
+#define PIO0_IRQ_0 7
+#define PIO1_IRQ_0 6
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+void irq_add_shared_handler(uint irq, irq_handler_t tratador, uint8_t prioridade);
+static inline void irq_set_enabled(uint irq, bool ativa) { (void)irq; (void)ativa; }
+
+#endif
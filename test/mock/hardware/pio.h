@@ -0,0 +1,33 @@
+#ifndef MOCK_HARDWARE_PIO_H
+#define MOCK_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+#define NUM_PIO_STATE_MACHINES MOCK_PIO_SM
+#define pis_sm0_rx_fifo_not_empty 0
+
+typedef mock_pio_t *PIO;
+#define pio0 (&mock_pio[0])
+#define pio1 (&mock_pio[1])
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+int pio_claim_unused_sm(PIO pio, bool obrigatorio);
+bool pio_can_add_program(PIO pio, const pio_program_t *programa);
+uint pio_add_program(PIO pio, const pio_program_t *programa);
+void pio_sm_put(PIO pio, uint sm, uint32_t valor);
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm);
+uint32_t pio_sm_get(PIO pio, uint sm);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+void pio_sm_restart(PIO pio, uint sm);
+
+static inline void pio_set_irq0_source_enabled(PIO pio, int fonte, bool ativa) { (void)pio; (void)fonte; (void)ativa; }
+static inline void pio_sm_set_enabled(PIO pio, uint sm, bool ativa) { (void)pio; (void)sm; (void)ativa; }
+static inline uint pio_encode_jmp(uint endereco) { return endereco; }
+static inline void pio_sm_exec(PIO pio, uint sm, uint instrucao) { (void)pio; (void)sm; (void)instrucao; }
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef MOCK_HARDWARE_SYNC_H
+#define MOCK_HARDWARE_SYNC_H
+
+#include <sched.h>
+
+// Nos testes cada núcleo é uma thread: WFE cede o processador e SEV não precisa fazer nada
+#define __dmb() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __sev() ((void)0)
+#define __wfe() sched_yield()
+
+#endif
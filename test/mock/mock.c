@@ -0,0 +1,189 @@
+#include <string.h>
+#include "mock.h"
+#include "pico/stdlib.h"
+#include "pico/rand.h"
+#include "pico/flash.h"
+#include "hardware/pio.h"
+#include "hardware/irq.h"
+#include "hardware/flash.h"
+#include "i2c_dma.h"
+
+uint64_t mock_agora_us;
+__thread uint mock_nucleo;
+
+// Atômico: nos testes com um thread por núcleo os dois leem e avançam o mesmo relógio
+void mock_avancar_us(uint64_t us) {
+    __atomic_add_fetch(&mock_agora_us, us, __ATOMIC_SEQ_CST);
+}
+
+uint64_t time_us_64(void) {
+    return __atomic_add_fetch(&mock_agora_us, MOCK_PASSO_LEITURA_US, __ATOMIC_SEQ_CST);
+}
+
+// ---------------------------------------------------------------- GPIO e eco
+
+static mock_eco_fn eco_fn;
+static void *eco_dados;
+static bool trigger_alto;
+static uint64_t eco_inicio, eco_fim;
+
+void mock_eco(mock_eco_fn fn, void *dados) {
+    eco_fn = fn;
+    eco_dados = dados;
+}
+
+void gpio_put(uint pino, bool valor) {
+    (void)pino;
+    if (trigger_alto && !valor && eco_fn) {
+        uint32_t duracao = eco_fn(eco_dados);
+        eco_inicio = mock_agora_us + MOCK_ECO_ATRASO_US;
+        eco_fim = duracao ? eco_inicio + duracao : eco_inicio;
+    }
+    trigger_alto = valor;
+}
+
+bool gpio_get(uint pino) {
+    (void)pino;
+    return mock_agora_us >= eco_inicio && mock_agora_us < eco_fim;
+}
+
+// ---------------------------------------------------------------- PIO e interrupções
+
+mock_pio_t mock_pio[2];
+
+#define MOCK_IRQS 8
+static irq_handler_t tratadores[MOCK_IRQS][4];
+
+void mock_reiniciar(void) {
+    memset(mock_pio, 0, sizeof(mock_pio));
+    memset(tratadores, 0, sizeof(tratadores));
+    eco_fn = NULL;
+    trigger_alto = false;
+    eco_inicio = eco_fim = 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool obrigatorio) {
+    (void)obrigatorio;
+    for (uint sm = 0; sm < MOCK_PIO_SM; sm++) {
+        if (!pio->usada[sm]) {
+            pio->usada[sm] = true;
+            return sm;
+        }
+    }
+    return -1;
+}
+
+bool pio_can_add_program(PIO pio, const pio_program_t *programa) {
+    (void)programa;
+    return !pio->programa;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *programa) {
+    (void)programa;
+    pio->programa = true;
+    return 0;
+}
+
+void pio_sm_put(PIO pio, uint sm, uint32_t valor) {
+    pio->medindo[sm] = true;
+    pio->limite[sm] = valor;
+}
+
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm) {
+    return pio->fifo_n[sm] == 0;
+}
+
+uint32_t pio_sm_get(PIO pio, uint sm) {
+    uint32_t valor = pio->fifo[sm][0];
+    memmove(&pio->fifo[sm][0], &pio->fifo[sm][1], (MOCK_FIFO - 1) * sizeof(uint32_t));
+    pio->fifo_n[sm]--;
+    return valor;
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm) {
+    pio->fifo_n[sm] = 0;
+}
+
+void pio_sm_restart(PIO pio, uint sm) {
+    pio->medindo[sm] = false;
+    pio->reinicios[sm]++;
+}
+
+void mock_pio_eco(mock_pio_t *pio, uint sm, uint32_t eco_us) {
+    if (!pio->medindo[sm]) return;
+    pio->medindo[sm] = false;
+    uint32_t resultado = (eco_us == 0 || eco_us > pio->limite[sm]) ? 0xFFFFFFFF : pio->limite[sm] - eco_us;
+    if (pio->fifo_n[sm] < MOCK_FIFO) pio->fifo[sm][pio->fifo_n[sm]++] = resultado;
+    mock_irq_disparar(pio == &mock_pio[0] ? PIO0_IRQ_0 : PIO1_IRQ_0);
+}
+
+void irq_add_shared_handler(uint irq, irq_handler_t tratador, uint8_t prioridade) {
+    (void)prioridade;
+    for (uint i = 0; i < 4; i++) {
+        if (!tratadores[irq][i]) {
+            tratadores[irq][i] = tratador;
+            return;
+        }
+    }
+}
+
+void mock_irq_disparar(uint irq) {
+    for (uint i = 0; i < 4 && tratadores[irq][i]; i++) tratadores[irq][i]();
+}
+
+// ---------------------------------------------------------------- Flash e sorteio
+
+uint8_t mock_flash[MOCK_FLASH_TAM];
+uint32_t mock_flash_programas, mock_flash_apagamentos;
+
+void flash_range_erase(uint32_t offset, size_t tamanho) {
+    memset(&mock_flash[offset], 0xFF, tamanho);
+    mock_flash_apagamentos++;
+}
+
+void flash_range_program(uint32_t offset, const uint8_t *dados, size_t tamanho) {
+    // Programar só leva bits de 1 para 0
+    for (size_t i = 0; i < tamanho; i++) mock_flash[offset + i] &= dados[i];
+    mock_flash_programas++;
+}
+
+int flash_safe_execute(void (*fn)(void *), void *param, uint32_t prazo_ms) {
+    (void)prazo_ms;
+    fn(param);
+    return PICO_OK;
+}
+
+static uint64_t semente = 0x853c49e6748fea9bull;
+
+uint32_t get_rand_32(void) {
+    semente = semente * 6364136223846793005ull + 1442695040888963407ull;
+    return (uint32_t)(semente >> 33);
+}
+
+// ---------------------------------------------------------------- I2C e transporte DMA
+
+i2c_inst_t mock_i2c[2];
+
+// O transporte só conta as palavras: a transferência termina na hora, sem interrupção
+void i2c_dma_comecar(i2c_dma_t *t) {
+    t->num = 0;
+    t->reiniciar = false;
+    t->estouro = false;
+}
+
+void i2c_dma_nova_transacao(i2c_dma_t *t) {
+    t->reiniciar = true;
+}
+
+void i2c_dma_escrever(i2c_dma_t *t, const uint8_t *dados, size_t n) {
+    (void)dados;
+    t->num += n;
+    t->reiniciar = false;
+}
+
+bool i2c_dma_enviar(i2c_dma_t *t, uint8_t endereco) {
+    (void)endereco;
+    t->resultado = I2C_DMA_OK;
+    t->ocupado = false;
+    return !t->estouro;
+}
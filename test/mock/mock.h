@@ -0,0 +1,53 @@
+#ifndef MOCK_H
+#define MOCK_H
+
+// Simulação no host do que o firmware usa do SDK do Pico: relógio virtual, GPIO com eco do
+// HC-SR04, máquinas de estados do PIO com FIFO de saída, interrupções compartilhadas, flash e
+// um barramento I2C que só conta o que é escrito.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+// Relógio virtual em µs. Cada leitura avança MOCK_PASSO_LEITURA_US, como o tempo gasto
+// por um laço de espera ativa no hardware.
+#define MOCK_PASSO_LEITURA_US 1
+extern uint64_t mock_agora_us;
+void mock_avancar_us(uint64_t us);
+
+// Eco do HC-SR04 nos pinos GPIO: ao descer o trigger, o pino de eco sobe depois de
+// MOCK_ECO_ATRASO_US e fica alto pela duração que a função devolver (0 = sem eco).
+#define MOCK_ECO_ATRASO_US 450
+typedef uint32_t (*mock_eco_fn)(void *dados);
+void mock_eco(mock_eco_fn fn, void *dados);
+
+// Máquinas de estados do PIO: o valor escrito no TX FIFO (limite de espera em µs) inicia
+// uma medição; o teste a conclui com mock_pio_eco, que põe o resultado no RX FIFO como o
+// programa hcsr04 faria e executa os tratadores de interrupção instalados.
+#define MOCK_PIO_SM 4
+#define MOCK_FIFO 4
+typedef struct mock_pio {
+    bool usada[MOCK_PIO_SM];
+    bool medindo[MOCK_PIO_SM];
+    uint32_t limite[MOCK_PIO_SM];
+    uint32_t fifo[MOCK_PIO_SM][MOCK_FIFO];
+    uint8_t fifo_n[MOCK_PIO_SM];
+    uint32_t reinicios[MOCK_PIO_SM];
+    bool programa;
+} mock_pio_t;
+extern mock_pio_t mock_pio[2];
+void mock_pio_eco(mock_pio_t *pio, uint sm, uint32_t eco_us); // eco_us = 0: sem eco
+void mock_irq_disparar(uint irq);
+void mock_reiniciar(void);
+
+// Flash simulada (apagada = 0xFF), lida pelo XIP_BASE
+#define MOCK_FLASH_TAM (64 * 4096)
+extern uint8_t mock_flash[MOCK_FLASH_TAM];
+extern uint32_t mock_flash_programas, mock_flash_apagamentos;
+
+// Núcleo que a thread atual representa
+extern __thread uint mock_nucleo;
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef MOCK_PICO_FLASH_H
+#define MOCK_PICO_FLASH_H
+
+#include "pico/stdlib.h"
+
+int flash_safe_execute(void (*fn)(void *), void *param, uint32_t prazo_ms);
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef MOCK_PICO_RAND_H
+#define MOCK_PICO_RAND_H
+
+#include "pico/stdlib.h"
+
+uint32_t get_rand_32(void); // Sequência fixa, para simulações reproduzíveis
+
+#endif
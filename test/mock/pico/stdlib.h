@@ -0,0 +1,36 @@
+#ifndef MOCK_PICO_STDLIB_H
+#define MOCK_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "mock.h"
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __unused __attribute__((unused))
+#define tight_loop_contents() ((void)0)
+#define PICO_OK 0
+
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef struct alarm_pool alarm_pool_t;
+
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline int64_t absolute_time_diff_us(absolute_time_t de, absolute_time_t ate) { return (int64_t)(ate - de); }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline void sleep_us(uint64_t us) { mock_avancar_us(us); }
+static inline void sleep_ms(uint32_t ms) { mock_avancar_us((uint64_t)ms * 1000); }
+static inline void busy_wait_us(uint64_t us) { mock_avancar_us(us); }
+static inline uint get_core_num(void) { return mock_nucleo; }
+
+#define GPIO_IN false
+#define GPIO_OUT true
+static inline void gpio_init(uint pino) { (void)pino; }
+static inline void gpio_set_dir(uint pino, bool saida) { (void)pino; (void)saida; }
+void gpio_put(uint pino, bool valor);
+bool gpio_get(uint pino);
+
+#endif
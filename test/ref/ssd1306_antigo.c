@@ -0,0 +1,142 @@
+#include "ssd1306_antigo.h"
+#include "font.h"
+
+void antigo_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  uint16_t index = (y >> 3) + (x << 3) + 1;
+  uint8_t pixel = (y & 0b111);
+  if (value)
+    ssd->ram_buffer[index] |= (1 << pixel);
+  else
+    ssd->ram_buffer[index] &= ~(1 << pixel);
+}
+
+void antigo_fill(ssd1306_t *ssd, bool value) {
+    for (uint8_t y = 0; y < ssd->height; ++y) {
+        for (uint8_t x = 0; x < ssd->width; ++x) {
+            antigo_pixel(ssd, x, y, value);
+        }
+    }
+}
+
+void antigo_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  for (uint8_t x = left; x < left + width; ++x) {
+    antigo_pixel(ssd, x, top, value);
+    antigo_pixel(ssd, x, top + height - 1, value);
+  }
+  for (uint8_t y = top; y < top + height; ++y) {
+    antigo_pixel(ssd, left, y, value);
+    antigo_pixel(ssd, left + width - 1, y, value);
+  }
+
+  if (fill) {
+    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
+      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
+        antigo_pixel(ssd, x, y, value);
+      }
+    }
+  }
+}
+
+void antigo_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+
+    int err = dx - dy;
+
+    while (true) {
+        antigo_pixel(ssd, x0, y0, value);
+
+        if (x0 == x1 && y0 == y1) break;
+
+        int e2 = err * 2;
+
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void antigo_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+  for (uint8_t x = x0; x <= x1; ++x)
+    antigo_pixel(ssd, x, y, value);
+}
+
+void antigo_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  for (uint8_t y = y0; y <= y1; ++y)
+    antigo_pixel(ssd, x, y, value);
+}
+
+void antigo_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  uint16_t index = 0;
+
+  if (c >= ' ' && c <= '~')
+  {
+    index = (c - ' ') * 8;
+  }
+  else
+  {
+    index = 0;
+  }
+
+  for (uint8_t i = 0; i < 8; ++i)
+  {
+    uint8_t line = font[index + i];
+    for (uint8_t j = 0; j < 8; ++j)
+    {
+      antigo_pixel(ssd, x + i, y + j, line & (1 << j));
+    }
+  }
+}
+
+void antigo_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+  while (*str)
+  {
+    antigo_draw_char(ssd, *str++, x, y);
+    x += 8;
+    if (x + 8 >= ssd->width)
+    {
+      x = 0;
+      y += 8;
+    }
+    if (y + 8 >= ssd->height)
+    {
+      break;
+    }
+  }
+}
+
+bool antigo_is_empty(ssd1306_t *ssd) {
+  for (uint16_t i = 1; i < ssd->bufsize; ++i) {
+      if (ssd->ram_buffer[i] != 0x00) {
+          return false;
+      }
+  }
+  return true;
+}
+
+// drawImage antes dos ícones gerados, sem o ssd1306_send_data do final
+void antigo_draw_image(ssd1306_t *ssd, const uint32_t desenho[8192]) {
+  // Desenho feito ao exportar o arquivo no Piskelapp automatizado
+  for (int j = 0; j < 64; j++)
+  {
+    for (int i = 0; i < 128; i++)
+    {
+      int a = j * 128 + i;
+      if (desenho[a] >= 0xff000000)
+      {
+        antigo_pixel(ssd, i, j, true);
+      }
+    }
+  }
+}
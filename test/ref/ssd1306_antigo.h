@@ -0,0 +1,20 @@
+#ifndef SSD1306_ANTIGO_H
+#define SSD1306_ANTIGO_H
+
+// Primitivas de desenho do lib/ssd1306.c antes da reescrita por colunas de 64 bits, pixel a
+// pixel, para comparar resultado e custo. Não recortam: só valem dentro da tela.
+
+#include "ssd1306.h"
+
+void antigo_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
+void antigo_fill(ssd1306_t *ssd, bool value);
+void antigo_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
+void antigo_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
+void antigo_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
+void antigo_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
+void antigo_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
+void antigo_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+bool antigo_is_empty(ssd1306_t *ssd);
+void antigo_draw_image(ssd1306_t *ssd, const uint32_t desenho[8192]);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef TESTE_H
+#define TESTE_H
+
+// Verificações dos testes de host: cada falha é impressa e o programa termina com erro
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+static int teste_falhas;
+
+#define VERIFICA(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+        teste_falhas++; \
+    } \
+} while (0)
+
+static inline int teste_fim(void) {
+    if (teste_falhas) {
+        fprintf(stderr, "%d verificação(ões) falharam\n", teste_falhas);
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
+
+// Relógio do host para os benchmarks, em ns
+static inline uint64_t teste_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+#endif
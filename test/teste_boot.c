@@ -0,0 +1,241 @@
+// Etapas da inicialização (lib/boot.c) com um thread por núcleo: cada etapa só começa depois
+// que todas as da sua máscara terminaram, também as do outro núcleo; tabelas com dependência
+// para frente ou fora da tabela são recusadas; e o relatório de /boot/trace sai na ordem da
+// tabela e, num buffer curto, é cortado numa etapa inteira.
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "teste.h"
+#include "mock.h"
+#include "boot.h"
+
+#define RODADAS 300
+
+// A tabela do firmware (smartgate-mqtt.c), com o núcleo que executa cada etapa
+enum { STDIO, ALARMES, PIO, REGISTRO, RADIO, DISPLAY, PERIFERICOS, CORE1, WIFI, DNS, MQTT, NUM_FIRMWARE };
+static boot_etapa_t firmware[NUM_FIRMWARE] = {
+    [STDIO] = { .nome = "stdio" },
+    [ALARMES] = { .nome = "alarmes" },
+    [PIO] = { .nome = "pio", .dependencias = BOOT_DEP(ALARMES) },
+    [REGISTRO] = { .nome = "registro", .dependencias = BOOT_DEP(STDIO) },
+    [RADIO] = { .nome = "radio", .dependencias = BOOT_DEP(PIO) },
+    [DISPLAY] = { .nome = "display", .dependencias = BOOT_DEP(ALARMES) },
+    [PERIFERICOS] = { .nome = "perifericos", .dependencias = BOOT_DEP(PIO) },
+    [CORE1] = { .nome = "core1", .dependencias = BOOT_DEP(DISPLAY) | BOOT_DEP(PERIFERICOS) },
+    [WIFI] = { .nome = "wifi", .dependencias = BOOT_DEP(RADIO) | BOOT_DEP(REGISTRO) },
+    [DNS] = { .nome = "dns", .dependencias = BOOT_DEP(WIFI) },
+    [MQTT] = { .nome = "mqtt", .dependencias = BOOT_DEP(DNS) },
+};
+static const uint8_t NUCLEO_FIRMWARE[NUM_FIRMWARE] = { 0, 1, 1, 0, 0, 1, 1, 1, 0, 0, 0 };
+#define FIRMWARE_TRACE_TAM 400 // METRICAS_MSG_TAM
+
+// Cadeia que alterna de núcleo a cada etapa, com máscaras de mais de um bit
+#define NUM_CADEIA 16
+static boot_etapa_t cadeia[NUM_CADEIA];
+static uint8_t nucleo_cadeia[NUM_CADEIA];
+
+typedef struct {
+    boot_t boot;
+    const uint8_t *nucleos;
+    uint8_t segurar, ate_chegar; // segurar não termina até ate_chegar ser pedida (0xFF: nenhuma)
+    uint32_t semente[2];
+    uint32_t sequencia;          // Ordem global dos eventos, comum aos dois núcleos
+    uint32_t chegada[BOOT_ETAPAS_MAX], inicio[BOOT_ETAPAS_MAX], fim[BOOT_ETAPAS_MAX];
+    volatile bool chegou[BOOT_ETAPAS_MAX];
+} execucao_t;
+
+typedef struct {
+    execucao_t *x;
+    uint nucleo;
+} nucleo_t;
+
+static uint32_t evento(execucao_t *x) {
+    return __atomic_add_fetch(&x->sequencia, 1, __ATOMIC_SEQ_CST);
+}
+
+static uint32_t sortear(uint32_t *s) {
+    *s = *s * 1664525u + 1013904223u;
+    return *s >> 16;
+}
+
+// Executa as etapas deste núcleo na ordem da tabela, cada uma com um trabalho de duração sorteada
+static void *executar(void *param) {
+    nucleo_t *n = (nucleo_t *)param;
+    execucao_t *x = n->x;
+    mock_nucleo = n->nucleo;
+    for (uint8_t e = 0; e < x->boot.num; e++) {
+        if (x->nucleos[e] != n->nucleo) continue;
+        x->chegada[e] = evento(x);
+        x->chegou[e] = true;
+        boot_etapa(&x->boot, e);
+        x->inicio[e] = evento(x);
+
+        mock_avancar_us(1000 + sortear(&x->semente[n->nucleo]) % 3000);
+        for (uint32_t k = sortear(&x->semente[n->nucleo]) % 4; k; k--) sched_yield();
+        if (e == x->segurar) {
+            while (!x->chegou[x->ate_chegar]) sched_yield();
+        }
+
+        x->fim[e] = evento(x);
+        boot_fim(&x->boot, e);
+    }
+    return NULL;
+}
+
+static void rodar(execucao_t *x, boot_etapa_t *etapas, uint8_t num, const uint8_t *nucleos,
+                  uint8_t segurar, uint8_t ate_chegar, uint32_t semente) {
+    memset(x, 0, sizeof(*x));
+    VERIFICA(boot_init(&x->boot, etapas, num));
+    x->nucleos = nucleos;
+    x->segurar = segurar;
+    x->ate_chegar = ate_chegar;
+    x->semente[0] = semente;
+    x->semente[1] = ~semente;
+    nucleo_t n[2] = { { x, 0 }, { x, 1 } };
+    pthread_t t[2];
+    for (int i = 0; i < 2; i++) pthread_create(&t[i], NULL, executar, &n[i]);
+    for (int i = 0; i < 2; i++) pthread_join(t[i], NULL);
+}
+
+// Toda dependência terminou antes do início, em eventos e no relógio; devolve quantas etapas
+// chegaram antes de uma dependência do outro núcleo terminar (esperaram de fato)
+static uint32_t verificar(const execucao_t *x) {
+    uint32_t esperas = 0;
+    for (uint8_t e = 0; e < x->boot.num; e++) {
+        const boot_etapa_t *et = &x->boot.etapas[e];
+        VERIFICA(boot_concluida(&x->boot, e));
+        VERIFICA(et->nucleo == x->nucleos[e]);
+        VERIFICA(et->fim_ms >= et->inicio_ms);
+        bool esperou = false;
+        for (uint8_t d = 0; d < x->boot.num; d++) {
+            if (!(et->dependencias & BOOT_DEP(d))) continue;
+            VERIFICA(x->fim[d] < x->inicio[e]);
+            VERIFICA(x->boot.etapas[d].fim_ms <= et->inicio_ms);
+            if (x->nucleos[d] != x->nucleos[e] && x->chegada[e] < x->fim[d]) esperou = true;
+        }
+        esperas += esperou;
+    }
+    return esperas;
+}
+
+// O relatório completo: as etapas concluídas, na ordem da tabela
+static void verificar_trace(const boot_t *b, const char *trace) {
+    const char *p = trace;
+    for (uint8_t e = 0; e < b->num; e++) {
+        const boot_etapa_t *et = &b->etapas[e];
+        if (!et->concluida) continue;
+        char esperado[64];
+        snprintf(esperado, sizeof(esperado), "%s:%u,%u,%u;", et->nome, et->nucleo,
+                 (unsigned)et->inicio_ms, (unsigned)et->fim_ms);
+        VERIFICA(strncmp(p, esperado, strlen(esperado)) == 0);
+        p += strlen(esperado);
+    }
+    VERIFICA(*p == '\0');
+}
+
+int main(void) {
+    static execucao_t x;
+
+    // A tabela do firmware: o pio (core1) só termina depois que o core0 pediu o rádio, que
+    // então tem que esperar por ele no outro núcleo
+    uint32_t esperas = 0;
+    for (uint32_t r = 0; r < RODADAS; r++) {
+        rodar(&x, firmware, NUM_FIRMWARE, NUCLEO_FIRMWARE, PIO, RADIO, r * 2654435761u);
+        esperas += verificar(&x);
+        VERIFICA(x.chegada[RADIO] < x.fim[PIO] && x.fim[PIO] < x.inicio[RADIO]);
+    }
+    printf("tabela do firmware: %u rodadas, %u esperas pelo outro núcleo\n", RODADAS, esperas);
+    VERIFICA(esperas >= RODADAS);
+
+    char trace[FIRMWARE_TRACE_TAM];
+    int len = boot_formatar(&x.boot, trace, sizeof(trace));
+    printf("%s\n", trace);
+    VERIFICA(len == (int)strlen(trace));
+    verificar_trace(&x.boot, trace);
+
+    // Cadeia alternada: cada etapa depende da anterior (no outro núcleo) e de uma de três antes
+    for (uint8_t e = 0; e < NUM_CADEIA; e++) {
+        static char nomes[NUM_CADEIA][8];
+        snprintf(nomes[e], sizeof(nomes[e]), "e%u", e);
+        cadeia[e] = (boot_etapa_t){ .nome = nomes[e] };
+        if (e >= 1) cadeia[e].dependencias |= BOOT_DEP(e - 1);
+        if (e >= 3) cadeia[e].dependencias |= BOOT_DEP(e - 3);
+        nucleo_cadeia[e] = e % 2;
+    }
+    esperas = 0;
+    for (uint32_t r = 0; r < RODADAS; r++) {
+        rodar(&x, cadeia, NUM_CADEIA, nucleo_cadeia, 0xFF, 0, r * 40503u + 1);
+        esperas += verificar(&x);
+        // Sem paralelismo possível: as etapas terminam uma a uma, na ordem da tabela
+        for (uint8_t e = 1; e < NUM_CADEIA; e++) VERIFICA(x.fim[e - 1] < x.inicio[e]);
+    }
+    printf("cadeia alternada: %u rodadas, %u esperas pelo outro núcleo\n", RODADAS, esperas);
+    VERIFICA(esperas > 0);
+
+    // Dependência para frente, da própria etapa ou de uma etapa fora da tabela: recusada, sem
+    // mexer no boot_t
+    boot_etapa_t t[4] = { { .nome = "a" }, { .nome = "b" }, { .nome = "c" }, { .nome = "d" } };
+    boot_t b = { 0 };
+    t[1].dependencias = BOOT_DEP(2);
+    VERIFICA(!boot_init(&b, t, 4));
+    t[1].dependencias = BOOT_DEP(1);
+    VERIFICA(!boot_init(&b, t, 4));
+    t[1].dependencias = BOOT_DEP(0);
+    t[3].dependencias = BOOT_DEP(4); // Não declarada na tabela
+    VERIFICA(!boot_init(&b, t, 4));
+    t[3].dependencias = BOOT_DEP(31);
+    VERIFICA(!boot_init(&b, t, 4));
+    VERIFICA(b.etapas == NULL && b.num == 0);
+    static boot_etapa_t grande[BOOT_ETAPAS_MAX + 1];
+    VERIFICA(!boot_init(&b, grande, BOOT_ETAPAS_MAX + 1));
+    VERIFICA(boot_init(&b, grande, BOOT_ETAPAS_MAX));
+    t[3].dependencias = BOOT_DEP(0) | BOOT_DEP(1) | BOOT_DEP(2);
+    t[2].concluida = t[2].iniciada = true; // De um boot anterior: zerado
+    VERIFICA(boot_init(&b, t, 4) && b.num == 4 && !boot_concluida(&b, 2));
+
+    // Relatório: só as etapas concluídas, na ordem da tabela e não na de conclusão
+    mock_nucleo = 0;
+    mock_agora_us = 5000000;
+    boot_inicio(&b, 2);
+    mock_avancar_us(7000);
+    boot_inicio(&b, 2); // Só o primeiro início conta
+    boot_fim(&b, 2);
+    mock_nucleo = 1;
+    boot_fim(&b, 0); // Fim sem início marcado: começa e termina no mesmo instante
+    boot_inicio(&b, 1);
+    mock_avancar_us(3000);
+    boot_fim(&b, 3); // Sem boot_etapa, o fim não espera as dependências: a 1 não terminou
+    mock_avancar_us(3000);
+    boot_fim(&b, 2); // Repetido: ignorado
+    char completo[128];
+    len = boot_formatar(&b, completo, sizeof(completo));
+    printf("%s\n", completo);
+    VERIFICA(strcmp(completo, "a:1,5007,5007;c:0,5000,5007;d:1,5010,5010;") == 0);
+    VERIFICA(len == (int)strlen(completo));
+    verificar_trace(&b, completo);
+
+    // Buffer curto: o relatório para na última etapa que coube inteira, sempre terminado
+    for (size_t tamanho = 1; tamanho <= strlen(completo) + 1; tamanho++) {
+        char curto[128];
+        memset(curto, '#', sizeof(curto));
+        len = boot_formatar(&b, curto, tamanho);
+        VERIFICA(len >= 0 && (size_t)len < tamanho && len == (int)strlen(curto));
+        VERIFICA(strncmp(curto, completo, len) == 0);
+        VERIFICA(len == 0 || curto[len - 1] == ';');
+        VERIFICA(curto[tamanho] == '#'); // Nada escrito além do buffer
+        // A próxima etapa não caberia
+        const char *seguinte = strchr(&completo[len], ';');
+        if (seguinte) VERIFICA((size_t)(seguinte - completo) + 1 >= tamanho);
+    }
+
+    // A tabela do firmware com tempos de 10 dígitos ainda cabe no buffer de /boot/trace
+    VERIFICA(boot_init(&b, firmware, NUM_FIRMWARE));
+    mock_agora_us = 4000000000000ull;
+    for (uint8_t e = 0; e < NUM_FIRMWARE; e++) boot_fim(&b, e);
+    len = boot_formatar(&b, trace, sizeof(trace));
+    VERIFICA(len < FIRMWARE_TRACE_TAM - 1);
+    verificar_trace(&b, trace);
+
+    return teste_fim();
+}
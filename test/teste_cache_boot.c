@@ -0,0 +1,136 @@
+// Cache do boot rápido (lib/cache_boot.c) na flash simulada, que como a NOR só leva bits de 1
+// para 0: registros acrescentados em sequência, apagamento só com o setor cheio ou com lixo,
+// gravações idênticas puladas, registro corrompido ou de outra rede ignorado e a volta ao
+// início do setor depois de cheio.
+
+#include <string.h>
+#include "teste.h"
+#include "mock.h"
+#include "cache_boot.h"
+
+// Como no firmware: o último setor da flash
+#define OFFSET (MOCK_FLASH_TAM - FLASH_SECTOR_SIZE)
+
+static cache_boot_t *registro(uint i) {
+    return (cache_boot_t *)&mock_flash[OFFSET + i * sizeof(cache_boot_t)];
+}
+
+static cache_boot_t novo(uint32_t chave, uint32_t n) {
+    cache_boot_t c = { .chave = chave, .broker_ip = 0x0A000000 | n, .canal = 1 + n % 11 };
+    for (int i = 0; i < 6; i++) c.bssid[i] = (uint8_t)(n >> i);
+    return c;
+}
+
+static bool igual(const cache_boot_t *a, const cache_boot_t *b) {
+    return a->chave == b->chave && a->broker_ip == b->broker_ip && a->canal == b->canal &&
+           memcmp(a->bssid, b->bssid, sizeof(a->bssid)) == 0;
+}
+
+static void zerar_contadores(void) {
+    mock_flash_programas = 0;
+    mock_flash_apagamentos = 0;
+}
+
+int main(void) {
+    uint32_t chave = cache_boot_chave("SmartGate", "broker.local");
+    uint32_t outra = cache_boot_chave("Vizinho", "broker.local");
+    VERIFICA(chave != outra && chave != cache_boot_chave("SmartGate", "10.0.0.2"));
+    cache_boot_t c, lido;
+
+    // Setor apagado: nada a ler, e a primeira gravação não apaga
+    memset(mock_flash, 0xFF, sizeof(mock_flash));
+    zerar_contadores();
+    VERIFICA(!cache_boot_ler(OFFSET, chave, &lido));
+    c = novo(chave, 0);
+    VERIFICA(cache_boot_gravar(OFFSET, &c));
+    VERIFICA(mock_flash_programas == 1 && mock_flash_apagamentos == 0);
+    VERIFICA(cache_boot_ler(OFFSET, chave, &lido) && igual(&lido, &c));
+
+    // Gravação idêntica não toca a flash
+    for (int i = 0; i < 10; i++) {
+        c = novo(chave, 0);
+        VERIFICA(cache_boot_gravar(OFFSET, &c));
+    }
+    VERIFICA(mock_flash_programas == 1 && mock_flash_apagamentos == 0);
+
+    // 300 gravações diferentes: um programa cada e um apagamento a cada 128 registros
+    memset(mock_flash, 0xFF, sizeof(mock_flash));
+    zerar_contadores();
+    for (uint32_t n = 1; n <= 300; n++) {
+        c = novo(chave, n);
+        VERIFICA(cache_boot_gravar(OFFSET, &c));
+        VERIFICA(cache_boot_ler(OFFSET, chave, &lido) && igual(&lido, &c));
+        c = novo(chave, n); // Repetida logo em seguida: pulada
+        VERIFICA(cache_boot_gravar(OFFSET, &c));
+    }
+    printf("300 gravações: %u programas, %u apagamentos\n", mock_flash_programas, mock_flash_apagamentos);
+    VERIFICA(mock_flash_programas == 300 && mock_flash_apagamentos == 2);
+    // 300 = 2 × 128 + 44: o terceiro ciclo do setor parou na posição 43
+    VERIFICA(registro(43)->marca == CACHE_BOOT_MARCA && registro(44)->marca == 0xFFFFFFFF);
+    // A flash fora do setor não foi tocada
+    uint32_t fora = 0;
+    for (uint32_t i = 0; i < OFFSET; i++) fora += mock_flash[i] != 0xFF;
+    VERIFICA(fora == 0);
+
+    // Volta ao início: com o setor cheio a gravação seguinte apaga e escreve na posição 0
+    memset(mock_flash, 0xFF, sizeof(mock_flash));
+    for (uint32_t n = 0; n < CACHE_BOOT_REGISTROS; n++) {
+        c = novo(chave, 1000 + n);
+        VERIFICA(cache_boot_gravar(OFFSET, &c));
+    }
+    VERIFICA(registro(CACHE_BOOT_REGISTROS - 1)->broker_ip == (0x0A000000 | (1000 + CACHE_BOOT_REGISTROS - 1)));
+    zerar_contadores();
+    c = novo(chave, 5000);
+    VERIFICA(cache_boot_gravar(OFFSET, &c));
+    VERIFICA(mock_flash_apagamentos == 1 && mock_flash_programas == 1);
+    VERIFICA(igual(registro(0), &c) && registro(1)->marca == 0xFFFFFFFF);
+    VERIFICA(registro(CACHE_BOOT_REGISTROS - 1)->marca == 0xFFFFFFFF);
+    VERIFICA(cache_boot_ler(OFFSET, chave, &lido) && igual(&lido, &c));
+    cache_boot_t seguinte = novo(chave, 5001);
+    VERIFICA(cache_boot_gravar(OFFSET, &seguinte));
+    VERIFICA(mock_flash_apagamentos == 1 && igual(registro(1), &seguinte));
+
+    // Registro de outra rede ou broker: válido, mas ignorado; gravar o da rede atual só acrescenta
+    memset(mock_flash, 0xFF, sizeof(mock_flash));
+    c = novo(outra, 7);
+    VERIFICA(cache_boot_gravar(OFFSET, &c));
+    VERIFICA(cache_boot_ler(OFFSET, outra, &lido));
+    VERIFICA(!cache_boot_ler(OFFSET, chave, &lido));
+    zerar_contadores();
+    c = novo(chave, 8);
+    VERIFICA(cache_boot_gravar(OFFSET, &c));
+    VERIFICA(mock_flash_apagamentos == 0 && registro(1)->chave == chave);
+    VERIFICA(cache_boot_ler(OFFSET, chave, &lido) && igual(&lido, &c));
+    VERIFICA(!cache_boot_ler(OFFSET, outra, &lido));
+
+    // Registro corrompido (um bit a menos, como numa gravação interrompida): não é lido nem
+    // aproveitado; a próxima gravação apaga o setor e recomeça do início
+    memset(mock_flash, 0xFF, sizeof(mock_flash));
+    for (uint32_t n = 0; n < 3; n++) {
+        c = novo(chave, 20 + n);
+        VERIFICA(cache_boot_gravar(OFFSET, &c));
+    }
+    registro(2)->broker_ip &= ~0x10u;
+    VERIFICA(!cache_boot_ler(OFFSET, chave, &lido));
+    zerar_contadores();
+    c = novo(chave, 22); // O mesmo conteúdo de antes da corrupção: não pode ser pulado
+    VERIFICA(cache_boot_gravar(OFFSET, &c));
+    VERIFICA(mock_flash_apagamentos == 1 && mock_flash_programas == 1);
+    VERIFICA(igual(registro(0), &c) && registro(1)->marca == 0xFFFFFFFF);
+    VERIFICA(cache_boot_ler(OFFSET, chave, &lido) && igual(&lido, &c));
+
+    // Marca certa com verificação errada também é rejeitada
+    registro(0)->verificacao &= 0xFFFF0000;
+    VERIFICA(!cache_boot_ler(OFFSET, chave, &lido));
+
+    // Setor com lixo de um binário antigo (sem posição livre): apagado e reescrito
+    memset(&mock_flash[OFFSET], 0x5A, FLASH_SECTOR_SIZE);
+    VERIFICA(!cache_boot_ler(OFFSET, chave, &lido));
+    zerar_contadores();
+    c = novo(chave, 30);
+    VERIFICA(cache_boot_gravar(OFFSET, &c));
+    VERIFICA(mock_flash_apagamentos == 1 && mock_flash_programas == 1);
+    VERIFICA(cache_boot_ler(OFFSET, chave, &lido) && igual(&lido, &c));
+
+    return teste_fim();
+}
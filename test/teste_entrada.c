@@ -0,0 +1,84 @@
+// Remontagem das publicações recebidas (lib/entrada.c): entrega sem cópia, fragmentos, limite
+// de tamanho, tópico sem tratador e fragmentos fora de hora
+
+#include <string.h>
+#include "teste.h"
+#include "entrada.h"
+
+#define CAPACIDADE 1024 // MQTT_ENTRADA_MAX
+#define FRAGMENTO 128   // Buffer de recepção do cliente MQTT
+
+static uint8_t buffer[CAPACIDADE];
+
+// Entrega o payload em fragmentos de FRAGMENTO bytes; retorna o que o último devolver
+static const uint8_t *entregar(entrada_t *e, const uint8_t *dados, uint32_t tamanho, uint16_t *total,
+                               int *entregues_antes) {
+    const uint8_t *resultado = NULL;
+    *entregues_antes = 0;
+    uint32_t pos = 0;
+    do {
+        uint16_t n = tamanho - pos > FRAGMENTO ? FRAGMENTO : (uint16_t)(tamanho - pos);
+        bool ultimo = pos + n == tamanho;
+        resultado = entrada_fragmento(e, dados + pos, n, ultimo, total);
+        if (!ultimo && resultado) (*entregues_antes)++;
+        pos += n;
+    } while (pos < tamanho);
+    return resultado;
+}
+
+int main(void) {
+    entrada_t e;
+    entrada_init(&e, buffer, CAPACIDADE);
+    uint16_t total;
+    int antes;
+
+    // Um fragmento: o tratador recebe o próprio buffer do cliente
+    const uint8_t abrir[] = "Open";
+    entrada_comecar(&e, 0, 4);
+    const uint8_t *p = entrada_fragmento(&e, abrir, 4, true, &total);
+    VERIFICA(p == abrir && total == 4 && e.id == 0);
+    VERIFICA(e.recebidas == 1 && e.remontadas == 0);
+
+    // 900 bytes em fragmentos de 128: remontado no buffer, entregue só no último
+    static uint8_t grande[3000];
+    for (size_t i = 0; i < sizeof(grande); i++) grande[i] = (uint8_t)(i * 7);
+    entrada_comecar(&e, 1, 900);
+    p = entregar(&e, grande, 900, &total, &antes);
+    VERIFICA(p == buffer && total == 900 && antes == 0);
+    VERIFICA(memcmp(buffer, grande, 900) == 0);
+    VERIFICA(e.recebidas == 2 && e.remontadas == 1);
+
+    // 3000 bytes: recusado pelo tamanho anunciado, nenhum byte copiado
+    memset(buffer, 0xAA, sizeof(buffer));
+    entrada_comecar(&e, 1, 3000);
+    p = entregar(&e, grande, 3000, &total, &antes);
+    VERIFICA(p == NULL && antes == 0 && e.grandes == 1);
+    VERIFICA(buffer[0] == 0xAA && buffer[CAPACIDADE - 1] == 0xAA);
+    VERIFICA(e.id == ENTRADA_NENHUM);
+
+    // Tópico sem tratador: fragmentos consumidos e ignorados
+    entrada_comecar(&e, ENTRADA_NENHUM, 200);
+    p = entregar(&e, grande, 200, &total, &antes);
+    VERIFICA(p == NULL && e.desconhecidas == 1 && e.recebidas == 2);
+
+    // Payload vazio: o tratador recebe tamanho 0 e um ponteiro válido
+    entrada_comecar(&e, 2, 0);
+    p = entrada_fragmento(&e, NULL, 0, true, &total);
+    VERIFICA(p != NULL && total == 0 && e.recebidas == 3);
+
+    // Fragmento solto depois da publicação completa: ignorado
+    p = entrada_fragmento(&e, abrir, 4, true, &total);
+    VERIFICA(p == NULL && e.recebidas == 3);
+
+    // O cliente entrega mais do que cabe: a publicação é descartada e contada
+    entrada_comecar(&e, 1, 1000);
+    for (int i = 0; i < 8; i++) VERIFICA(entrada_fragmento(&e, grande, FRAGMENTO, false, &total) == NULL);
+    VERIFICA(entrada_fragmento(&e, grande, FRAGMENTO, true, &total) == NULL);
+    VERIFICA(e.truncadas == 1 && e.recebidas == 3 && e.id == ENTRADA_NENHUM);
+
+    // Depois de tudo isso a próxima publicação sai normalmente
+    entrada_comecar(&e, 3, 4);
+    VERIFICA(entrada_fragmento(&e, abrir, 4, true, &total) == abrir && e.id == 3 && e.recebidas == 4);
+
+    return teste_fim();
+}
@@ -0,0 +1,191 @@
+// Fila de telemetria offline (lib/fila.c) sobre a flash simulada: ordem de chegada entre flash
+// e RAM, descarte dos mais antigos com e sem flash, payload limitado, tempo de drenagem e o
+// reenvio com confirmação, com erros e quedas no meio
+
+#include <string.h>
+#include "teste.h"
+#include "mock.h"
+#include "fila.h"
+
+#define SETORES 4
+#define OFFSET (MOCK_FLASH_TAM - SETORES * FLASH_SECTOR_SIZE) // Últimos setores, como no firmware
+
+static void adicionar(fila_t *f, uint32_t i) {
+    char payload[16];
+    int n = snprintf(payload, sizeof(payload), "%u", (unsigned)i);
+    fila_adicionar(f, (uint8_t)(i % 7), i, payload, (uint8_t)n);
+}
+
+// Retira tudo e confere que saem exatamente primeiro..ultimo, na ordem
+static bool drenar(fila_t *f, uint32_t primeiro, uint32_t ultimo) {
+    bool certo = true;
+    for (uint32_t i = primeiro; i <= ultimo; i++) {
+        const fila_registro_t *r = fila_primeiro(f);
+        char esperado[16];
+        int n = snprintf(esperado, sizeof(esperado), "%u", (unsigned)i);
+        if (!r || r->instante_ms != i || r->topico != i % 7 || r->tamanho != n || memcmp(r->payload, esperado, n) != 0) {
+            certo = false;
+            break;
+        }
+        fila_remover(f, i);
+    }
+    return certo && fila_primeiro(f) == NULL && fila_profundidade(f) == 0;
+}
+
+static uint32_t semente = 7;
+
+static uint32_t sorteio(uint32_t max) {
+    semente = semente * 1664525u + 1013904223u;
+    return (semente >> 8) % max;
+}
+
+// Reenvio como no firmware: janela de 2, conclusões na ordem dos envios, erros e quedas.
+// Um registro só pode sair da fila com a confirmação do próprio envio.
+static void simular_reenvio(fila_t *f, uint32_t registros, uint32_t *confirmados, uint32_t *repetidos,
+                            uint32_t *perdidos) {
+    uint32_t voo[2], n_voo = 0; // instante_ms de cada envio em voo, na ordem
+    static bool recebido[8192];
+    memset(recebido, 0, sizeof(recebido));
+    *confirmados = *repetidos = *perdidos = 0;
+    for (int passo = 0; passo < 100000 && fila_profundidade(f); passo++) {
+        const fila_registro_t *r;
+        while (n_voo < 2 && (r = fila_proximo(f))) {
+            voo[n_voo++] = r->instante_ms;
+            fila_enviado(f);
+        }
+        uint32_t sorte = sorteio(100);
+        if (sorte < 2) {
+            // Queda: o cliente descarta as requisições sem concluir nenhuma
+            n_voo = 0;
+            fila_reenviar(f);
+        } else if (n_voo) {
+            bool ok = sorte >= 12; // 10% de erro ou tempo esgotado
+            uint32_t instante = voo[0];
+            voo[0] = voo[1];
+            n_voo--;
+            uint32_t antes = fila_profundidade(f), primeiro = fila_primeiro(f)->instante_ms;
+            fila_confirmado(f, ok, passo);
+            if (fila_profundidade(f) != antes && (!ok || primeiro != instante)) (*perdidos)++;
+            if (ok) {
+                if (recebido[instante]) (*repetidos)++;
+                recebido[instante] = true;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < registros; i++) *confirmados += recebido[i];
+}
+
+int main(void) {
+    fila_t f;
+
+    // Só RAM e dentro da capacidade
+    fila_init(&f, 0, 0);
+    for (uint32_t i = 0; i < 50; i++) adicionar(&f, i);
+    VERIFICA(fila_profundidade(&f) == 50);
+    VERIFICA(drenar(&f, 0, 49));
+
+    // Só RAM, transbordando: ficam os 64 mais novos
+    fila_init(&f, 0, 0);
+    for (uint32_t i = 0; i < 300; i++) adicionar(&f, i);
+    VERIFICA(fila_profundidade(&f) == FILA_RAM_REGISTROS && f.descartados == 300 - FILA_RAM_REGISTROS);
+    VERIFICA(drenar(&f, 300 - FILA_RAM_REGISTROS, 299));
+
+    // Com flash: as páginas mais antigas descem e a ordem se mantém
+    memset(mock_flash, 0, sizeof(mock_flash)); // Conteúdo qualquer: a fila apaga antes de gravar
+    fila_init(&f, OFFSET, SETORES);
+    for (uint32_t i = 0; i < 300; i++) adicionar(&f, i);
+    VERIFICA(fila_profundidade(&f) == 300 && f.descartados == 0);
+    VERIFICA(mock_flash_programas > 0);
+    VERIFICA(drenar(&f, 0, 299));
+
+    // Muito além da capacidade: o setor mais antigo é sacrificado a cada volta do anel.
+    // Gravar por cima de flash não apagada corromperia os payloads conferidos por drenar.
+    memset(mock_flash, 0, sizeof(mock_flash));
+    fila_init(&f, OFFSET, SETORES);
+    uint32_t programas = mock_flash_programas, apagamentos = mock_flash_apagamentos;
+    for (uint32_t i = 0; i < 5000; i++) adicionar(&f, i);
+    uint32_t guardados = fila_profundidade(&f);
+    printf("5000 registros em %d setores: %u guardados, %u descartados, %u páginas gravadas, %u setores apagados\n",
+           SETORES, (unsigned)guardados, (unsigned)f.descartados, (unsigned)(mock_flash_programas - programas),
+           (unsigned)(mock_flash_apagamentos - apagamentos));
+    VERIFICA(guardados + f.descartados == 5000);
+    VERIFICA(guardados > (SETORES - 1) * FILA_REGISTROS_SETOR);
+    // Um apagamento no começo de cada setor, nunca no meio
+    uint32_t paginas_setor = FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE;
+    VERIFICA(mock_flash_apagamentos - apagamentos == (mock_flash_programas - programas + paginas_setor - 1) / paginas_setor);
+    fila_drenagem_comecar(&f, 1000);
+    VERIFICA(drenar(&f, 5000 - guardados, 4999));
+    VERIFICA(!f.drenando);
+
+    // Tempo de drenagem: do começo até o último registro sair
+    fila_init(&f, 0, 0);
+    adicionar(&f, 1);
+    adicionar(&f, 2);
+    fila_drenagem_comecar(&f, 10000);
+    fila_remover(&f, 10100);
+    VERIFICA(f.drenando);
+    fila_remover(&f, 10250);
+    VERIFICA(!f.drenando && f.drenagem_ms == 250);
+
+    // Reenvio: o registro enviado continua na fila até a confirmação
+    fila_init(&f, 0, 0);
+    for (uint32_t i = 0; i < 10; i++) adicionar(&f, i);
+    VERIFICA(fila_proximo(&f)->instante_ms == 0);
+    fila_enviado(&f);
+    VERIFICA(fila_proximo(&f)->instante_ms == 1);
+    fila_enviado(&f);
+    VERIFICA(fila_profundidade(&f) == 10 && fila_primeiro(&f)->instante_ms == 0);
+    fila_confirmado(&f, true, 0);
+    VERIFICA(fila_profundidade(&f) == 9 && fila_primeiro(&f)->instante_ms == 1);
+    VERIFICA(fila_proximo(&f)->instante_ms == 2);
+    // Erro no 1: ele volta a ser o próximo; o 2, enviado depois, é abandonado
+    fila_enviado(&f);
+    fila_confirmado(&f, false, 0);
+    VERIFICA(fila_profundidade(&f) == 9 && fila_proximo(&f)->instante_ms == 1);
+    fila_enviado(&f);
+    VERIFICA(fila_proximo(&f)->instante_ms == 2);
+    fila_confirmado(&f, true, 0); // Do 2 abandonado: ignorada
+    VERIFICA(fila_profundidade(&f) == 9);
+    fila_confirmado(&f, true, 0); // Do 1 reenviado
+    VERIFICA(fila_profundidade(&f) == 8 && fila_primeiro(&f)->instante_ms == 2);
+    // Queda: o que estava em voo volta a ser enviado, e uma conclusão a mais não tira nada
+    fila_enviado(&f);
+    fila_enviado(&f);
+    fila_reenviar(&f);
+    VERIFICA(fila_proximo(&f)->instante_ms == 2);
+    fila_confirmado(&f, true, 0);
+    VERIFICA(fila_profundidade(&f) == 8);
+    // Descarte com envios em voo: eles são abandonados, nada sai sem confirmação
+    for (uint32_t i = 10; i < 10 + FILA_RAM_REGISTROS; i++) {
+        if (i == 12) {
+            fila_enviado(&f);
+            fila_enviado(&f);
+        }
+        adicionar(&f, i);
+    }
+    VERIFICA(fila_profundidade(&f) == FILA_RAM_REGISTROS);
+    uint32_t primeiro = fila_primeiro(&f)->instante_ms;
+    VERIFICA(fila_proximo(&f)->instante_ms == primeiro);
+    fila_confirmado(&f, true, 0);
+    fila_confirmado(&f, true, 0);
+    VERIFICA(fila_profundidade(&f) == FILA_RAM_REGISTROS && fila_primeiro(&f)->instante_ms == primeiro);
+
+    // Reenvio de 500 registros entre flash e RAM com 10% de erros e 2% de quedas
+    memset(mock_flash, 0, sizeof(mock_flash));
+    fila_init(&f, OFFSET, SETORES);
+    for (uint32_t i = 0; i < 500; i++) adicionar(&f, i);
+    uint32_t confirmados, repetidos, perdidos;
+    simular_reenvio(&f, 500, &confirmados, &repetidos, &perdidos);
+    printf("reenvio de 500 registros com erros e quedas: %u confirmados, %u repetidos, %u tirados sem confirmação\n",
+           (unsigned)confirmados, (unsigned)repetidos, (unsigned)perdidos);
+    VERIFICA(fila_profundidade(&f) == 0 && confirmados == 500 && perdidos == 0);
+
+    // Payload maior que o registro é cortado
+    fila_init(&f, 0, 0);
+    char longo[40];
+    memset(longo, 'x', sizeof(longo));
+    fila_adicionar(&f, 1, 0, longo, sizeof(longo));
+    VERIFICA(fila_primeiro(&f)->tamanho == FILA_PAYLOAD_MAX);
+
+    return teste_fim();
+}
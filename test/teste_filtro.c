@@ -0,0 +1,64 @@
+// Filtro incremental (lib/filtro.c): mediana e MAD contra o cálculo direto, Hampel, idade e EMA
+
+#include <string.h>
+#include <math.h>
+#include "teste.h"
+#include "filtro.h"
+
+static int comparar(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static float mediana_direta(float *v, int n) {
+    qsort(v, n, sizeof(float), comparar);
+    return (n & 1) ? v[n / 2] : 0.5f * (v[n / 2 - 1] + v[n / 2]);
+}
+
+int main(void) {
+    // Mediana e MAD a cada inserção, para janelas pares e ímpares, com valores repetidos
+    srand(7);
+    for (int janela = 1; janela <= FILTRO_JANELA_MAX; janela++) {
+        filtro_t f;
+        filtro_init(&f, FILTRO_MEDIANA, janela, 0);
+        float historico[4000];
+        for (int i = 0; i < 400; i++) {
+            historico[i] = (float)(rand() % 50);
+            filtro_inserir(&f, historico[i], i);
+            int n = i + 1 < janela ? i + 1 : janela;
+            float v[FILTRO_JANELA_MAX], d[FILTRO_JANELA_MAX];
+            memcpy(v, &historico[i + 1 - n], n * sizeof(float));
+            float m = mediana_direta(v, n);
+            for (int k = 0; k < n; k++) d[k] = v[k] > m ? v[k] - m : m - v[k];
+            VERIFICA(f.saida == m);
+            VERIFICA(n < 2 || filtro_mad(&f) == mediana_direta(d, n));
+        }
+    }
+
+    // Cena parada em cm inteiros: MAD = 0, e um pico de 20 cm ainda é rejeitado
+    filtro_t h;
+    filtro_init(&h, FILTRO_HAMPEL, 5, 0);
+    for (int i = 0; i < 4; i++) filtro_inserir(&h, 100.0f, i);
+    VERIFICA(filtro_mad(&h) == 0.0f);
+    VERIFICA(filtro_inserir(&h, 120.0f, 4) == 100.0f && h.rejeitadas == 1);
+    VERIFICA(filtro_inserir(&h, 101.0f, 5) == 101.0f); // Ruído de 1 cm passa
+    // Uma mudança real é aceita quando vira maioria na janela
+    float saida = 0.0f;
+    for (int i = 0; i < 5; i++) saida = filtro_inserir(&h, 60.0f, 6 + i);
+    VERIFICA(saida == 60.0f);
+
+    // Amostras mais velhas que a idade máxima saem da janela
+    filtro_t idade;
+    filtro_init(&idade, FILTRO_MEDIANA, 5, 500);
+    filtro_inserir(&idade, 10.0f, 0);
+    filtro_inserir(&idade, 10.0f, 100);
+    VERIFICA(filtro_inserir(&idade, 50.0f, 1000) == 50.0f && idade.n == 1);
+
+    // EMA: começa na primeira amostra e anda ema_alfa do caminho a cada uma
+    filtro_t e;
+    filtro_init(&e, FILTRO_EMA, 5, 0);
+    VERIFICA(filtro_inserir(&e, 100.0f, 0) == 100.0f);
+    VERIFICA(fabsf(filtro_inserir(&e, 200.0f, 1) - 130.0f) < 1e-3f);
+
+    return teste_fim();
+}
@@ -0,0 +1,180 @@
+// Histórico de distância (lib/grafico.c) contra um painel SSD1306 simulado no barramento I2C:
+// o painel interpreta as janelas e os comandos de rolagem e rola a página sozinho, no seu
+// próprio relógio. Com a distância mudando a cada amostra o gráfico tem que andar uma coluna
+// por passo, com o buffer do driver igual ao painel depois de cada envio e as colunas na
+// ordem das amostras, também com o ícone sendo redesenhado no meio.
+
+#include <string.h>
+#include "teste.h"
+#include "mock.h"
+#include "grafico.h"
+
+#define PAGINA 7
+#define ESCALA_CM 200
+#define DURACAO_US 60000000ull
+
+// Painel: GDDRAM, endereçamento vertical dentro da janela e rolagem para a esquerda
+typedef struct {
+    uint8_t ram[8][128];
+    uint8_t x0, x1, p0, p1, x, p;
+    bool rolando;
+    uint8_t rolagem_p0, rolagem_p1;
+    uint64_t inicio_us;
+    uint32_t passo_us;
+    uint32_t passos;
+    uint32_t desconhecidos; // Comandos que o gráfico não deveria mandar
+} painel_t;
+
+static void painel_avancar(painel_t *p) {
+    if (!p->rolando) return;
+    uint32_t n = (mock_agora_us - p->inicio_us) / p->passo_us;
+    p->inicio_us += (uint64_t)n * p->passo_us;
+    p->passos += n;
+    for (uint8_t pg = p->rolagem_p0; pg <= p->rolagem_p1; pg++) {
+        uint8_t linha[128];
+        for (int x = 0; x < 128; x++) linha[x] = p->ram[pg][(x + n) % 128];
+        memcpy(p->ram[pg], linha, sizeof(linha));
+    }
+}
+
+static void painel_receber(void *dados, uint8_t endereco, const uint8_t *b, size_t n) {
+    painel_t *p = (painel_t *)dados;
+    static const uint16_t quadros[8] = { 5, 64, 128, 256, 3, 4, 25, 2 };
+    if (b[0] == 0x40) {
+        for (size_t i = 1; i < n; i++) {
+            p->ram[p->p][p->x] = b[i];
+            if (++p->p > p->p1) {
+                p->p = p->p0;
+                if (++p->x > p->x1) p->x = p->x0;
+            }
+        }
+        return;
+    }
+    for (size_t i = 1; i < n;) {
+        switch (b[i]) {
+            case 0x21: p->x = p->x0 = b[i + 1]; p->x1 = b[i + 2]; i += 3; break;
+            case 0x22: p->p = p->p0 = b[i + 1]; p->p1 = b[i + 2]; i += 3; break;
+            case 0x2E: painel_avancar(p); p->rolando = false; i += 1; break;
+            case 0x27:
+                p->rolagem_p0 = b[i + 2];
+                p->passo_us = quadros[b[i + 3] & 7] * SSD1306_QUADRO_US;
+                p->rolagem_p1 = b[i + 4];
+                i += 7;
+                break;
+            case 0x2F: p->rolando = true; p->inicio_us = mock_agora_us; i += 1; break;
+            default: p->desconhecidos++; return;
+        }
+    }
+}
+
+static uint8_t barra(uint16_t distancia_cm) {
+    uint16_t d = distancia_cm > ESCALA_CM ? ESCALA_CM : distancia_cm;
+    return (uint8_t)(0xFF << (8 - (1 + d * 7 / ESCALA_CM)));
+}
+
+static bool pagina_igual(const painel_t *p, const ssd1306_t *ssd, uint8_t pagina) {
+    for (int x = 0; x < 128; x++) {
+        if (p->ram[pagina][x] != ssd->ram_buffer[(x << 3) + pagina + 1]) return false;
+    }
+    return true;
+}
+
+typedef struct {
+    uint32_t colunas;       // Passos dados pelo painel
+    uint32_t pendentes;     // Passos do fim ainda não escritos (a próxima amostra escreveria)
+    uint32_t envios;        // Amostras que escreveram alguma coisa
+    uint32_t divergencias;  // Envios depois dos quais o painel ficou diferente do buffer
+    uint32_t fora_de_ordem; // Colunas do painel diferentes das amostras que as escreveram
+    uint32_t valores;       // Alturas de barra diferentes nas últimas 128 colunas
+    uint32_t bytes;
+} resultado_t;
+
+// seguir_espera: acorda quando grafico_amostra pede (como o worker); senão a cada periodo_ms.
+// icone_ms: a cada tanto as páginas do ícone mudam e são enviadas, como faz o worker do display.
+static resultado_t simular(bool seguir_espera, uint32_t periodo_ms, uint32_t icone_ms) {
+    static painel_t painel;
+    static ssd1306_t ssd;
+    static grafico_t g;
+    memset(&painel, 0, sizeof(painel));
+    mock_i2c[0] = (i2c_inst_t){ .ouvinte = painel_receber, .dados_ouvinte = &painel };
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c0);
+    ssd1306_fill(&ssd, false);
+    grafico_init(&g, &ssd, PAGINA, ESCALA_CM);
+    ssd1306_send_data(&ssd);
+
+    // Barra escrita por cada amostra que trouxe uma coluna nova, na ordem
+    static uint8_t historico[4096];
+    uint32_t n_historico = 0;
+    resultado_t r = { 0 };
+    uint64_t fim = mock_agora_us + DURACAO_US, proximo_icone = mock_agora_us + icone_ms * 1000ull;
+    uint32_t amostra = 0;
+    while (mock_agora_us < fim) {
+        if (icone_ms && mock_agora_us >= proximo_icone) {
+            proximo_icone += icone_ms * 1000ull;
+            ssd1306_rect(&ssd, 10, 50, 20, 20, amostra & 1, true);
+            ssd1306_send_data(&ssd);
+        }
+
+        uint16_t distancia = 20 + (amostra++ * 37) % 180; // Muda a cada amostra
+        uint32_t escritas = mock_i2c[0].escritas;
+        painel_avancar(&painel);
+        uint32_t novas = painel.passos - n_historico; // Inclui os passos contados no envio do ícone
+        uint32_t espera_ms = grafico_amostra(&g, distancia);
+        if (mock_i2c[0].escritas != escritas) {
+            r.envios++;
+            painel_avancar(&painel);
+            if (!pagina_igual(&painel, &ssd, PAGINA) || !pagina_igual(&painel, &ssd, 1)) r.divergencias++;
+            for (uint32_t k = 0; k < novas && n_historico < sizeof(historico); k++) {
+                historico[n_historico++] = barra(distancia);
+            }
+        }
+        mock_avancar_us((uint64_t)(seguir_espera ? espera_ms : periodo_ms) * 1000);
+    }
+    painel_avancar(&painel);
+
+    // As colunas da direita para a esquerda são as amostras da mais nova para a mais antiga
+    // (as que chegaram depois do último envio ainda não foram escritas)
+    uint32_t pendentes = painel.passos - n_historico;
+    bool visto[256] = { false };
+    for (uint32_t k = 0; k + pendentes < 128 && k < n_historico; k++) {
+        uint8_t coluna = painel.ram[PAGINA][127 - pendentes - k];
+        if (coluna != historico[n_historico - 1 - k]) r.fora_de_ordem++;
+        if (!visto[coluna]) {
+            visto[coluna] = true;
+            r.valores++;
+        }
+    }
+    r.colunas = painel.passos;
+    r.pendentes = pendentes;
+    r.bytes = mock_i2c[0].bytes;
+    VERIFICA(painel.desconhecidos == 0);
+    return r;
+}
+
+int main(void) {
+    // Como o worker do firmware: a próxima amostra logo depois do fim de cada passo
+    resultado_t r = simular(true, 0, 0);
+    printf("seguindo o passo: %u colunas em 60 s, %u envios, %u bytes\n", r.colunas, r.envios, r.bytes);
+    VERIFICA(r.colunas >= 60000000ull / (25 * SSD1306_QUADRO_US + 2000) - 1);
+    VERIFICA(r.envios + r.pendentes == r.colunas && r.pendentes <= 1); // Uma coluna por envio
+    VERIFICA(r.divergencias == 0 && r.fora_de_ordem == 0);
+    VERIFICA(r.valores >= 5);
+
+    // Amostras a cada 150 ms (o período antigo): sem passo concluído nada é enviado, então a
+    // rolagem continua andando; cada coluna perde só o atraso até a amostra seguinte
+    r = simular(false, 150, 0);
+    printf("a cada 150 ms: %u colunas em 60 s, %u envios\n", r.colunas, r.envios);
+    VERIFICA(r.colunas >= 60000000ull / (25 * SSD1306_QUADRO_US + 150000));
+    VERIFICA(r.envios + r.pendentes == r.colunas && r.pendentes <= 1);
+    VERIFICA(r.divergencias == 0 && r.fora_de_ordem == 0);
+    VERIFICA(r.valores >= 5);
+
+    // O ícone redesenhado a cada 700 ms também desliga e religa a rolagem no meio do passo
+    r = simular(true, 0, 700);
+    printf("com o ícone a cada 700 ms: %u colunas em 60 s\n", r.colunas);
+    VERIFICA(r.colunas >= 60000000ull / (25 * SSD1306_QUADRO_US + 2000) * 8 / 10);
+    VERIFICA(r.divergencias == 0 && r.fora_de_ordem == 0);
+    VERIFICA(r.valores >= 5);
+
+    return teste_fim();
+}
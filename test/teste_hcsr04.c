@@ -0,0 +1,82 @@
+// Motor de medição do HC-SR04 (lib/hcSR04.c) sobre o PIO simulado: captura, timeout,
+// buffer circular e reinício da máquina de estados travada
+
+#include "teste.h"
+#include "hcSR04.h"
+
+static int concluidas;
+static void ao_concluir(void *dados) {
+    (*(int *)dados)++;
+}
+
+static uint32_t eco_fixo(void *dados) {
+    return *(uint32_t *)dados;
+}
+
+int main(void) {
+    mock_reiniciar();
+    hcsr04_t a, b;
+    VERIFICA(hcsr04_init(&a, 16, 17));
+    VERIFICA(hcsr04_init(&b, 18, 19));
+    VERIFICA(a.pio == b.pio && a.sm != b.sm);
+    hcsr04_ao_concluir(&a, ao_concluir, &concluidas);
+
+    // Eco de 1160 µs: 20 cm, com o instante do disparo
+    hcsr04_amostra_t s;
+    VERIFICA(!hcsr04_ler(&a, &s));
+    VERIFICA(hcsr04_disparar(&a));
+    uint64_t disparo = a.disparo_us;
+    VERIFICA(!hcsr04_disparar(&a)); // Medição em andamento
+    mock_avancar_us(1600);
+    mock_pio_eco(a.pio, a.sm, 1160);
+    VERIFICA(concluidas == 1);
+    VERIFICA(hcsr04_ler(&a, &s));
+    VERIFICA(s.valida && s.eco_us == 1160 && s.instante_us == disparo);
+    VERIFICA(hcsr04_eco_para_cm(s.eco_us) == 20);
+    VERIFICA(!hcsr04_ler(&a, &s));
+    VERIFICA(!hcsr04_ler(&b, &s)); // A interrupção é compartilhada, o resultado não
+
+    // Sem eco e eco maior que o limite: amostra inválida e timeout contado
+    VERIFICA(hcsr04_disparar(&a));
+    mock_pio_eco(a.pio, a.sm, 0);
+    VERIFICA(hcsr04_disparar(&a));
+    mock_pio_eco(a.pio, a.sm, HCSR04_TIMEOUT_US + 1);
+    VERIFICA(hcsr04_ler(&a, &s) && !s.valida && s.eco_us == 0);
+    VERIFICA(hcsr04_ler(&a, &s) && !s.valida);
+    VERIFICA(a.timeouts == 2);
+
+    // Consumidor atrasado: o buffer guarda HCSR04_BUFFER_TAM - 1 amostras e conta o resto
+    for (uint32_t i = 1; i <= 20; i++) {
+        VERIFICA(hcsr04_disparar(&b));
+        mock_pio_eco(b.pio, b.sm, 100 * i);
+    }
+    VERIFICA(b.descartadas == 20 - (HCSR04_BUFFER_TAM - 1));
+    for (uint32_t i = 1; i < HCSR04_BUFFER_TAM; i++) {
+        VERIFICA(hcsr04_ler(&b, &s) && s.eco_us == 100 * i); // Mais antigas primeiro
+    }
+    VERIFICA(!hcsr04_ler(&b, &s));
+
+    // Máquina de estados sem resultado: só é reiniciada depois do watchdog
+    VERIFICA(hcsr04_disparar(&a));
+    mock_avancar_us(HCSR04_WATCHDOG_US / 2);
+    VERIFICA(!hcsr04_disparar(&a));
+    uint32_t reinicios = a.pio->reinicios[a.sm];
+    mock_avancar_us(HCSR04_WATCHDOG_US);
+    VERIFICA(hcsr04_disparar(&a));
+    VERIFICA(a.pio->reinicios[a.sm] == reinicios + 1 && a.timeouts == 3);
+    mock_pio_eco(a.pio, a.sm, 580);
+    VERIFICA(hcsr04_ler(&a, &s) && s.valida && hcsr04_eco_para_cm(s.eco_us) == 10);
+
+    // API bloqueante antiga, sobre o eco nos pinos GPIO
+    uint32_t eco = 2320;
+    mock_eco(eco_fixo, &eco);
+    uint64_t pulso = getPulse(16, 17);
+    VERIFICA(pulso >= eco && pulso <= eco + 2);
+    VERIFICA(getCm(16, 17) == 40);
+    VERIFICA(getCmFiltered(16, 17, 6) == 40);
+    eco = 0;
+    VERIFICA(getPulse(16, 17) == 0);
+    VERIFICA(getCmFiltered(16, 17, 6) == 400);
+
+    return teste_fim();
+}
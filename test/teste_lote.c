@@ -0,0 +1,111 @@
+// Quadros de /distance/batch (lib/lote.c): um decodificador independente, escrito a partir do
+// formato documentado, tem que devolver exatamente as amostras codificadas.
+
+#include <string.h>
+#include "teste.h"
+#include "tracos.h"
+#include "lote.h"
+
+#define AMOSTRAS 5000
+#define CAPACIDADE 64   // DIST_LOTE_AMOSTRAS
+#define PRAZO_MS 2000   // DIST_LOTE_PRAZO_MS
+
+typedef struct {
+    uint32_t instante_ms;
+    int16_t cm;
+} amostra_t;
+
+static bool ler_varint(const uint8_t *q, uint16_t tamanho, uint16_t *pos, uint32_t *valor) {
+    *valor = 0;
+    for (int deslocamento = 0; deslocamento < 35; deslocamento += 7) {
+        if (*pos >= tamanho) return false;
+        uint8_t b = q[(*pos)++];
+        *valor |= (uint32_t)(b & 0x7F) << deslocamento;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Decodifica um quadro; retorna o número de amostras ou -1 se o quadro for inválido
+static int decodificar(const uint8_t *q, uint16_t tamanho, amostra_t *saida) {
+    if (tamanho < LOTE_CABECALHO || q[0] != LOTE_VERSAO) return -1;
+    int n = q[1];
+    uint32_t t = q[2] | q[3] << 8 | q[4] << 16 | (uint32_t)q[5] << 24;
+    int32_t cm = (int16_t)(q[6] | q[7] << 8);
+    saida[0] = (amostra_t){ t, (int16_t)cm };
+
+    uint16_t pos = LOTE_CABECALHO;
+    for (int i = 1; i < n; i++) {
+        uint32_t intervalo, zigzag;
+        if (!ler_varint(q, tamanho, &pos, &intervalo) || !ler_varint(q, tamanho, &pos, &zigzag)) return -1;
+        t += intervalo;
+        cm += (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+        saida[i] = (amostra_t){ t, (int16_t)cm };
+    }
+    return pos == tamanho ? n : -1;
+}
+
+static amostra_t entrada[AMOSTRAS], decodificadas[AMOSTRAS];
+static int num_decodificadas, quadros;
+static uint32_t bytes;
+
+static void enviar(lote_t *l) {
+    uint16_t tamanho = lote_fechar(l);
+    VERIFICA(tamanho <= LOTE_BYTES_MAX);
+    int n = decodificar(l->quadro, tamanho, &decodificadas[num_decodificadas]);
+    VERIFICA(n == l->n);
+    if (n > 0) num_decodificadas += n;
+    bytes += tamanho;
+    quadros++;
+    lote_limpar(l);
+}
+
+int main(void) {
+    // Fluxo do core1: só distâncias novas, com o instante de cada uma, do traço de aproximação
+    static traco_amostra_t traco[4 * AMOSTRAS];
+    size_t n = traco_gerar(TRACO_APROXIMACAO, traco, 4 * AMOSTRAS);
+    int num = 0;
+    for (size_t i = 0; i < n && num < AMOSTRAS; i++) {
+        if (traco[i].medida_cm == 0) continue;
+        int16_t cm = (int16_t)traco[i].medida_cm;
+        if (num && cm == entrada[num - 1].cm) continue;
+        entrada[num++] = (amostra_t){ traco[i].instante_ms, cm };
+    }
+    VERIFICA(num == AMOSTRAS);
+
+    // Como o firmware: envia ao encher ou quando o prazo da primeira amostra vence
+    lote_t l;
+    lote_init(&l, CAPACIDADE, PRAZO_MS);
+    for (int i = 0; i < num; i++) {
+        if (!lote_vazio(&l) && lote_espera_ms(&l, entrada[i].instante_ms) == 0) enviar(&l);
+        if (lote_adicionar(&l, entrada[i].instante_ms, entrada[i].cm)) enviar(&l);
+    }
+    if (!lote_vazio(&l)) enviar(&l);
+
+    VERIFICA(num_decodificadas == num);
+    VERIFICA(memcmp(entrada, decodificadas, num * sizeof(amostra_t)) == 0);
+    printf("%d amostras em %d quadros: %.2f bytes por amostra\n", num, quadros, (double)bytes / num);
+
+    // Pior caso: intervalos e variações grandes, distância negativa e instante dando a volta
+    static const amostra_t extremos[] = {
+        { 0xFFFFFF00u, 400 }, { 0x00000010u, -32768 }, { 0x7FFFFFFFu, 32767 }, { 0x80000000u, 0 },
+        { 0x80000000u, -1 }, { 0x80000001u, 1 },
+    };
+    num_decodificadas = 0;
+    lote_init(&l, LOTE_AMOSTRAS_MAX, PRAZO_MS);
+    for (size_t i = 0; i < count_of(extremos); i++) VERIFICA(!lote_adicionar(&l, extremos[i].instante_ms, extremos[i].cm));
+    enviar(&l);
+    VERIFICA(num_decodificadas == (int)count_of(extremos));
+    VERIFICA(memcmp(extremos, decodificadas, sizeof(extremos)) == 0);
+
+    // Limites: capacidade, teto de 255 amostras e espaço para mais uma amostra de pior caso
+    lote_init(&l, 3, PRAZO_MS);
+    VERIFICA(!lote_adicionar(&l, 0, 10) && !lote_adicionar(&l, 1, 11) && lote_adicionar(&l, 2, 12));
+    lote_init(&l, 255, PRAZO_MS);
+    int adicionadas = 0;
+    while (!lote_adicionar(&l, (uint32_t)adicionadas * 0x10000000u, adicionadas & 1 ? 32767 : -32768)) adicionadas++;
+    VERIFICA(l.tamanho + LOTE_AMOSTRA_MAX > LOTE_BYTES_MAX && l.tamanho <= LOTE_BYTES_MAX);
+    VERIFICA(lote_espera_ms(&l, l.primeiro_ms + 500) == PRAZO_MS - 500);
+
+    return teste_fim();
+}
@@ -0,0 +1,91 @@
+// Histogramas de fases (lib/metricas.c): baldes, percentis, janela zerada pelo leitor, formato do
+// /metrics e custo de um registro. Compilado também com METRICAS_ATIVAS=0, quando as macros somem.
+
+#include <string.h>
+#include "teste.h"
+#include "mock.h"
+#include "metricas.h"
+
+#if METRICAS_ATIVAS
+
+int main(void) {
+    metrica_t m;
+    metrica_resumo_t r;
+    metrica_init(&m, "fase");
+    VERIFICA(!metrica_resumo(&m, &r)); // Nada registrado
+
+    // Balde i conta [2^(i-1), 2^i): 0 no balde 0, 1 no 1, 2 e 3 no 2, e o excesso no último
+    metrica_registrar(&m, 0);
+    metrica_registrar(&m, 1);
+    metrica_registrar(&m, 2);
+    metrica_registrar(&m, 3);
+    metrica_registrar(&m, 4);
+    metrica_registrar(&m, UINT32_MAX);
+    VERIFICA(m.baldes[0] == 1 && m.baldes[1] == 1 && m.baldes[2] == 2 && m.baldes[3] == 1);
+    VERIFICA(m.baldes[METRICAS_BALDES - 1] == 1);
+    VERIFICA(m.contagem == 6 && m.min_us == 0 && m.max_us == UINT32_MAX);
+
+    // Percentis: limite superior do balde, nunca acima do máximo observado
+    metrica_init(&m, "fase");
+    for (uint32_t i = 1; i <= 1000; i++) metrica_registrar(&m, i);
+    VERIFICA(metrica_resumo(&m, &r));
+    VERIFICA(r.contagem == 1000 && r.min_us == 1 && r.max_us == 1000);
+    VERIFICA(r.p50_us == 511);   // 500º valor no balde [256, 512)
+    VERIFICA(r.p99_us == 1000);  // Balde [512, 1024) limitado ao máximo
+    VERIFICA(r.p50_us >= 500 && r.p50_us < 2 * 500); // Precisão de um fator 2
+
+    // O resumo pede uma janela nova; o dono zera no próximo registro
+    VERIFICA(!metrica_resumo(&m, &r));
+    metrica_registrar(&m, 40);
+    VERIFICA(metrica_resumo(&m, &r) && r.contagem == 1 && r.min_us == 40 && r.p50_us == 40 && r.max_us == 40);
+
+    // Macros: a duração vem do relógio (no mock, cada leitura anda 1 us)
+    METRICA_INICIO(t);
+    mock_avancar_us(250);
+    METRICA_FIM(&m, t);
+    VERIFICA(metrica_resumo(&m, &r) && r.min_us >= 250 && r.max_us <= 252);
+
+    // Formato: só fases com registros; uma fase que não cabe não é cortada ao meio
+    metrica_t fases[3];
+    metrica_init(&fases[0], "a");
+    metrica_init(&fases[1], "b");
+    metrica_init(&fases[2], "c");
+    metrica_registrar(&fases[0], 5);
+    metrica_registrar(&fases[2], 300);
+    metrica_registrar(&fases[2], 700);
+    char buf[64];
+    int n = metricas_formatar(fases, 3, buf, sizeof(buf));
+    VERIFICA(strcmp(buf, "a:1,5,5,5,5;c:2,300,511,700,700;") == 0 && n == (int)strlen(buf));
+    metrica_registrar(&fases[0], 5);
+    metrica_registrar(&fases[2], 300);
+    n = metricas_formatar(fases, 3, buf, 20);
+    VERIFICA(strcmp(buf, "a:1,5,5,5,5;") == 0 && n == 12);
+
+    // Custo de um registro no host
+    enum { REGISTROS = 10000000 };
+    metrica_init(&m, "custo");
+    uint64_t inicio = teste_ns();
+    for (uint32_t i = 0; i < REGISTROS; i++) metrica_registrar(&m, i & 0xFFFF);
+    double ns = (double)(teste_ns() - inicio) / REGISTROS;
+    VERIFICA(m.contagem == REGISTROS);
+    printf("metrica_registrar: %.1f ns\n", ns);
+
+    return teste_fim();
+}
+
+#else
+
+int main(void) {
+    // Sem instrumentação: as macros não leem o relógio nem registram nada
+    metrica_t m = { 0 };
+    uint64_t antes = mock_agora_us;
+    METRICA_INICIO(t);
+    METRICA_REINICIAR(t);
+    METRICA_FIM(&m, t);
+    METRICA_REGISTRAR(&m, 10);
+    VERIFICA(mock_agora_us == antes);
+    VERIFICA(m.contagem == 0);
+    return teste_fim();
+}
+
+#endif
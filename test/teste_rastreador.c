@@ -0,0 +1,71 @@
+// Rastreador alfa-beta (lib/rastreador.c) sobre os traços: a presença é antecipada na aproximação
+// e a previsão não sobrevive à perda dos ecos nem a uma estimativa sem medidas
+
+#include "teste.h"
+#include "tracos.h"
+#include "rastreador.h"
+
+#define LIMIAR_CM 30
+#define HORIZONTE_MS 500
+#define FALHAS_MAX 3 // SENSORES_FALHAS_MAX: só então a leitura inválida chega ao rastreador
+
+#define MAX_AMOSTRAS 2000
+
+static traco_amostra_t traco[MAX_AMOSTRAS];
+
+// Mesmo caminho do core1 para um único sensor: leitura inválida reinicia o rastreador
+static bool passo(rastreador_t *r, const traco_amostra_t *a, int *falhas) {
+    if (a->medida_cm == 0) {
+        if (++*falhas >= FALHAS_MAX) rastreador_reiniciar(r);
+    } else {
+        *falhas = 0;
+        rastreador_atualizar(r, a->medida_cm, a->instante_ms);
+    }
+    return rastreador_vigente(r, a->instante_ms);
+}
+
+int main(void) {
+    rastreador_t r;
+    int falhas;
+
+    // Aproximação: a previsão chega antes do cruzamento real dos 30 cm e nunca mais cedo que o horizonte
+    size_t n = traco_gerar(TRACO_APROXIMACAO, traco, MAX_AMOSTRAS);
+    rastreador_init(&r, LIMIAR_CM, HORIZONTE_MS);
+    falhas = 0;
+    int64_t previsao_ms = -1, cruzamento_ms = -1;
+    for (size_t i = 0; i < n && cruzamento_ms < 0; i++) {
+        bool previsto = passo(&r, &traco[i], &falhas);
+        if (previsto && previsao_ms < 0) previsao_ms = traco[i].instante_ms;
+        if (traco[i].real_cm <= LIMIAR_CM) cruzamento_ms = traco[i].instante_ms;
+    }
+    VERIFICA(previsao_ms >= 0 && cruzamento_ms >= 0);
+    VERIFICA(previsao_ms < cruzamento_ms);
+    VERIFICA(cruzamento_ms - previsao_ms <= HORIZONTE_MS + 3 * TRACO_PERIODO_MS);
+    printf("antecedência: %lld ms\n", (long long)(cruzamento_ms - previsao_ms));
+
+    // Perda: perto demais os ecos somem; a previsão cai em até FALHAS_MAX amostras e não volta sem eco
+    n = traco_gerar(TRACO_PERDA, traco, MAX_AMOSTRAS);
+    rastreador_init(&r, LIMIAR_CM, HORIZONTE_MS);
+    falhas = 0;
+    int sem_eco = 0, presos = 0;
+    bool houve_previsao = false;
+    for (size_t i = 0; i < n; i++) {
+        bool previsto = passo(&r, &traco[i], &falhas);
+        houve_previsao |= previsto;
+        sem_eco = traco[i].real_cm < 15.0f ? sem_eco + 1 : 0;
+        if (sem_eco >= FALHAS_MAX && previsto) presos++;
+    }
+    VERIFICA(houve_previsao);
+    VERIFICA(presos == 0);
+
+    // Sem medidas novas, a previsão expira depois de RASTREADOR_INTERVALO_MAX_MS
+    rastreador_init(&r, LIMIAR_CM, HORIZONTE_MS);
+    uint32_t t = 0;
+    for (float d = 120.0f; d > 40.0f; d -= 6.0f, t += TRACO_PERIODO_MS) rastreador_atualizar(&r, d, t);
+    VERIFICA(r.previsto);
+    VERIFICA(rastreador_vigente(&r, r.ultimo_ms + RASTREADOR_INTERVALO_MAX_MS));
+    VERIFICA(!rastreador_vigente(&r, r.ultimo_ms + RASTREADOR_INTERVALO_MAX_MS + 1));
+    VERIFICA(!r.iniciado);
+
+    return teste_fim();
+}
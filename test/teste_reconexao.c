@@ -0,0 +1,105 @@
+// Recuo exponencial com sorteio (lib/reconexao.c): a espera fica entre metade e o total do teto,
+// o teto dobra até o máximo, o sucesso volta ao mínimo e o tempo da queda à conexão é medido.
+// Depois, a simulação do tempo de recuperação do broker para quedas de várias durações.
+//
+// Uso: teste_reconexao [quedas por duração]   (padrão: 10000)
+
+#include <stdlib.h>
+#include "teste.h"
+#include "reconexao.h"
+
+// Os valores do firmware para o broker (smartgate-mqtt.c)
+#define MIN_MS 500
+#define MAX_MS 15000
+
+// Simulação: uma tentativa recusada custa 5 ms; a que encontra o broker de volta conecta em 30 ms
+#define RECUSA_MS 5
+#define CONEXAO_MS 30
+
+static int comparar(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    int quedas = argc > 1 ? atoi(argv[1]) : 10000;
+    reconexao_t r;
+
+    // Espera dentro de [teto/2, teto]; o teto dobra a cada tentativa até o máximo
+    static const uint32_t TETOS[] = { 500, 1000, 2000, 4000, 8000, 15000, 15000, 15000 };
+    enum { TENTATIVAS = sizeof(TETOS) / sizeof(TETOS[0]) };
+    uint32_t menor[TENTATIVAS], maior[TENTATIVAS];
+    for (int k = 0; k < TENTATIVAS; k++) {
+        menor[k] = UINT32_MAX;
+        maior[k] = 0;
+    }
+    for (int n = 0; n < 2000; n++) {
+        reconexao_init(&r, MIN_MS, MAX_MS);
+        for (int k = 0; k < TENTATIVAS; k++) {
+            VERIFICA(r.teto_ms == TETOS[k]);
+            uint32_t espera = reconexao_espera_ms(&r);
+            VERIFICA(espera >= TETOS[k] / 2 && espera <= TETOS[k]);
+            if (espera < menor[k]) menor[k] = espera;
+            if (espera > maior[k]) maior[k] = espera;
+        }
+        VERIFICA(r.tentativas == TENTATIVAS);
+    }
+    // O sorteio cobre a faixa inteira, não só um ponto dela
+    for (int k = 0; k < TENTATIVAS; k++) {
+        VERIFICA(menor[k] < TETOS[k] / 2 + TETOS[k] / 20);
+        VERIFICA(maior[k] > TETOS[k] - TETOS[k] / 20);
+    }
+
+    // O sucesso volta o teto ao mínimo
+    reconexao_init(&r, MIN_MS, MAX_MS);
+    for (int k = 0; k < 6; k++) reconexao_espera_ms(&r);
+    VERIFICA(r.teto_ms == MAX_MS);
+    reconexao_sucesso(&r, 0);
+    VERIFICA(r.teto_ms == MIN_MS && r.tentativas == 0);
+    uint32_t espera = reconexao_espera_ms(&r);
+    VERIFICA(espera >= MIN_MS / 2 && espera <= MIN_MS);
+
+    // Da queda ao CONNACK: quedas repetidas antes do sucesso contam uma só
+    reconexao_init(&r, MIN_MS, MAX_MS);
+    reconexao_queda(&r, 1000);
+    reconexao_queda(&r, 1500);
+    VERIFICA(r.quedas == 1 && r.caido);
+    reconexao_sucesso(&r, 4200);
+    VERIFICA(!r.caido && r.recuperacao_ms == 3200 && r.recuperacao_max_ms == 3200);
+    reconexao_queda(&r, 10000);
+    reconexao_sucesso(&r, 10300);
+    VERIFICA(r.quedas == 2 && r.recuperacao_ms == 300 && r.recuperacao_max_ms == 3200);
+    reconexao_sucesso(&r, 20000); // Sem queda: nada a medir
+    VERIFICA(r.recuperacao_ms == 300);
+
+    // Tempo de recuperação: o broker some por `duracao` ms a partir da queda em t = 0
+    static const uint32_t DURACOES[] = { 500, 2000, 10000, 60000 };
+    uint32_t *recuperacoes = malloc(quedas * sizeof(uint32_t));
+    printf("queda (s)  média (s)  p95 (s)  máx (s)  tentativas\n");
+    for (size_t d = 0; d < sizeof(DURACOES) / sizeof(DURACOES[0]); d++) {
+        uint64_t soma = 0, tentativas = 0;
+        for (int n = 0; n < quedas; n++) {
+            reconexao_init(&r, MIN_MS, MAX_MS);
+            reconexao_queda(&r, 0);
+            uint32_t t = 0;
+            for (;;) {
+                t += reconexao_espera_ms(&r);
+                if (t >= DURACOES[d]) break;
+                t += RECUSA_MS;
+            }
+            tentativas += r.tentativas;
+            reconexao_sucesso(&r, t + CONEXAO_MS);
+            recuperacoes[n] = r.recuperacao_ms;
+            soma += r.recuperacao_ms;
+            // Nunca mais que um teto máximo depois da volta do broker
+            VERIFICA(r.recuperacao_ms >= DURACOES[d] && r.recuperacao_ms <= DURACOES[d] + MAX_MS + CONEXAO_MS);
+        }
+        qsort(recuperacoes, quedas, sizeof(uint32_t), comparar);
+        printf("%9.1f  %9.2f  %7.2f  %7.2f  %10.1f\n", DURACOES[d] / 1000.0, soma / 1000.0 / quedas,
+               recuperacoes[quedas * 95 / 100] / 1000.0, recuperacoes[quedas - 1] / 1000.0,
+               (double)tentativas / quedas);
+    }
+    free(recuperacoes);
+
+    return teste_fim();
+}
@@ -0,0 +1,187 @@
+// Fila de saída (lib/saida.c) com um cliente MQTT falso de lugares limitados: prioridade,
+// substituição, descarte, payloads depois de remoções, janela do reenvio e uma simulação do
+// reenvio de /backlog disputando o cliente com o tráfego ao vivo
+
+#include <stdlib.h>
+#include <string.h>
+#include "teste.h"
+#include "saida.h"
+
+#define ENVIADAS_MAX 4096
+
+// Cliente falso: MQTT_REQ_MAX_IN_FLIGHT lugares; cada envio ocupa um até ser concluído
+typedef struct {
+    int lugares, ocupados;
+    int num;
+    struct {
+        saida_classe_t classe;
+        const char *topico;
+        char payload[64];
+    } enviadas[ENVIADAS_MAX];
+} cliente_t;
+
+static saida_resultado_t cliente_publicar(void *dados, saida_classe_t classe, const char *topico, const void *payload,
+                                          uint16_t tamanho, uint8_t qos, bool retain) {
+    cliente_t *c = (cliente_t *)dados;
+    if (c->ocupados == c->lugares) return SAIDA_CHEIA;
+    if (tamanho >= sizeof(c->enviadas[0].payload)) return SAIDA_ERRO;
+    c->ocupados++;
+    c->enviadas[c->num].classe = classe;
+    c->enviadas[c->num].topico = topico;
+    memcpy(c->enviadas[c->num].payload, payload, tamanho);
+    c->enviadas[c->num].payload[tamanho] = '\0';
+    c->num++;
+    return SAIDA_ENVIADA;
+}
+
+static const uint8_t QOS[NUM_CLASSES_SAIDA] = { 1, 1, 0, 0, 1 };
+static const uint8_t JANELA[NUM_CLASSES_SAIDA] = { [SAIDA_REENVIO] = 2 };
+
+static const char GATE_STATE[] = "/gate/state", STATUS[] = "/status", DISTANCE[] = "/distance",
+                  CPU[] = "/cpu", BACKLOG[] = "/backlog";
+
+static bool publicar(saida_t *s, saida_classe_t classe, const char *topico, const char *payload) {
+    bool substituivel = classe == SAIDA_TELEMETRIA || classe == SAIDA_DIAGNOSTICO;
+    return saida_publicar(s, classe, topico, payload, strlen(payload), false, substituivel);
+}
+
+static cliente_t cliente;
+
+int main(void) {
+    saida_t s;
+
+    // Com o cliente cheio tudo espera; ao liberar, sai a mais urgente primeiro
+    memset(&cliente, 0, sizeof(cliente));
+    saida_init(&s, QOS, JANELA, cliente_publicar, &cliente);
+    VERIFICA(publicar(&s, SAIDA_DIAGNOSTICO, CPU, "c1"));
+    VERIFICA(publicar(&s, SAIDA_TELEMETRIA, DISTANCE, "40"));
+    VERIFICA(publicar(&s, SAIDA_CONTROLE, GATE_STATE, "Open"));
+    VERIFICA(publicar(&s, SAIDA_ESTADO, STATUS, "1"));
+    VERIFICA(publicar(&s, SAIDA_TELEMETRIA, DISTANCE, "38")); // Substitui o 40 no mesmo lugar
+    VERIFICA(s.num == 4 && s.adiadas == 3 && s.substituidas == 1); // O /status nem tenta: o comando espera
+    cliente.lugares = 5;
+    VERIFICA(!saida_drenar(&s));
+    VERIFICA(cliente.num == 4);
+    VERIFICA(cliente.enviadas[0].topico == GATE_STATE && cliente.enviadas[1].topico == STATUS);
+    VERIFICA(cliente.enviadas[2].topico == DISTANCE && strcmp(cliente.enviadas[2].payload, "38") == 0);
+    VERIFICA(cliente.enviadas[3].topico == CPU && strcmp(cliente.enviadas[3].payload, "c1") == 0);
+
+    // Cheia: sai a mais antiga da classe menos urgente; uma menos urgente que tudo é recusada
+    memset(&cliente, 0, sizeof(cliente));
+    saida_init(&s, QOS, JANELA, cliente_publicar, &cliente);
+    char payload[24];
+    for (int i = 0; i < SAIDA_MAX; i++) {
+        snprintf(payload, sizeof(payload), "e%d", i);
+        VERIFICA(saida_publicar(&s, i < 4 ? SAIDA_DIAGNOSTICO : SAIDA_ESTADO, STATUS, payload, strlen(payload), false, false));
+    }
+    VERIFICA(publicar(&s, SAIDA_CONTROLE, GATE_STATE, "Close"));
+    VERIFICA(s.descartadas[SAIDA_DIAGNOSTICO] == 1 && s.num == SAIDA_MAX);
+    for (int i = 0; i < 3; i++) VERIFICA(publicar(&s, SAIDA_CONTROLE, GATE_STATE, "Close"));
+    VERIFICA(s.descartadas[SAIDA_DIAGNOSTICO] == 4);
+    VERIFICA(!saida_publicar(&s, SAIDA_REENVIO, BACKLOG, "x", 1, false, false));
+    VERIFICA(s.descartadas[SAIDA_REENVIO] == 1);
+    // Os payloads continuam certos depois das remoções no meio
+    cliente.lugares = SAIDA_MAX;
+    saida_drenar(&s);
+    VERIFICA(cliente.num == SAIDA_MAX);
+    for (int i = 0; i < 4; i++) VERIFICA(strcmp(cliente.enviadas[i].payload, "Close") == 0);
+    for (int i = 4; i < SAIDA_MAX; i++) {
+        snprintf(payload, sizeof(payload), "e%d", i);
+        VERIFICA(strcmp(cliente.enviadas[i].payload, payload) == 0);
+    }
+
+    // Janela do reenvio: dois sem confirmação, o terceiro espera mesmo com lugar no cliente
+    memset(&cliente, 0, sizeof(cliente));
+    cliente.lugares = 5;
+    saida_init(&s, QOS, JANELA, cliente_publicar, &cliente);
+    VERIFICA(saida_livre(&s, SAIDA_REENVIO));
+    VERIFICA(saida_publicar(&s, SAIDA_REENVIO, BACKLOG, "r0", 2, false, false));
+    VERIFICA(saida_publicar(&s, SAIDA_REENVIO, BACKLOG, "r1", 2, false, false));
+    VERIFICA(!saida_livre(&s, SAIDA_REENVIO) && s.pendentes[SAIDA_REENVIO] == 2);
+    VERIFICA(saida_publicar(&s, SAIDA_REENVIO, BACKLOG, "r2", 2, false, false));
+    VERIFICA(cliente.num == 2 && s.num == 1);
+    VERIFICA(!saida_drenar(&s) && s.num == 1); // Só a janela segura: não pede nova tentativa
+    // O tráfego ao vivo passa na frente do reenvio que espera
+    VERIFICA(publicar(&s, SAIDA_TELEMETRIA, DISTANCE, "12") && cliente.num == 3);
+    VERIFICA(saida_livre(&s, SAIDA_TELEMETRIA) && !saida_livre(&s, SAIDA_REENVIO));
+    saida_confirmar(&s, SAIDA_REENVIO);
+    VERIFICA(!saida_drenar(&s) && s.num == 0 && strcmp(cliente.enviadas[3].payload, "r2") == 0);
+    // Nova conexão: as confirmações da anterior não virão
+    VERIFICA(s.pendentes[SAIDA_REENVIO] == 2);
+    saida_reabrir(&s);
+    VERIFICA(s.pendentes[SAIDA_REENVIO] == 0 && saida_livre(&s, SAIDA_REENVIO));
+
+    // saida_tentar entrega ou recusa, sem nunca guardar: a janela cheia, algo mais urgente
+    // esperando ou o cliente sem lugar deixam a mensagem com quem a produziu
+    memset(&cliente, 0, sizeof(cliente));
+    cliente.lugares = 1;
+    saida_init(&s, QOS, JANELA, cliente_publicar, &cliente);
+    VERIFICA(saida_tentar(&s, SAIDA_REENVIO, BACKLOG, "t0", 2, false));
+    VERIFICA(!saida_tentar(&s, SAIDA_REENVIO, BACKLOG, "t1", 2, false)); // Cliente cheio
+    VERIFICA(s.num == 0 && s.adiadas == 1 && s.pendentes[SAIDA_REENVIO] == 1);
+    cliente.ocupados = 0;
+    VERIFICA(publicar(&s, SAIDA_DIAGNOSTICO, CPU, "c2") && cliente.num == 2);
+    VERIFICA(publicar(&s, SAIDA_DIAGNOSTICO, CPU, "c3") && s.num == 1); // Espera
+    VERIFICA(!saida_tentar(&s, SAIDA_REENVIO, BACKLOG, "t1", 2, false) && s.num == 1);
+    cliente.lugares = 5;
+    saida_drenar(&s);
+    VERIFICA(saida_tentar(&s, SAIDA_REENVIO, BACKLOG, "t1", 2, false));
+    VERIFICA(!saida_tentar(&s, SAIDA_REENVIO, BACKLOG, "t2", 2, false)); // Janela cheia
+    VERIFICA(s.num == 0 && cliente.num == 4 && strcmp(cliente.enviadas[3].payload, "t1") == 0);
+
+    // Simulação: 500 registros reenviados enquanto a telemetria segue ao vivo e comandos chegam.
+    // QoS 0 libera o lugar no passo seguinte (ACK do TCP), QoS 1 só com o PUBACK, 3 passos depois;
+    // o reenvio roda como no firmware.
+    memset(&cliente, 0, sizeof(cliente));
+    cliente.lugares = 5;
+    saida_init(&s, QOS, JANELA, cliente_publicar, &cliente);
+    enum { REGISTROS = 500, DURACAO = 4, PUBACK = 3 };
+    int proximo_registro = 0, janela_max = 0, controle_adiado = 0;
+    int concluir[DURACAO] = { 0 }, concluir_reenvio[DURACAO] = { 0 }; // Por passo (mod DURACAO)
+    for (int passo = 0; passo < 4000 && (proximo_registro < REGISTROS || s.num); passo++) {
+        // Requisições concluídas neste passo liberam lugares e a janela
+        int k = passo % DURACAO;
+        cliente.ocupados -= concluir[k];
+        for (int i = 0; i < concluir_reenvio[k]; i++) saida_confirmar(&s, SAIDA_REENVIO);
+        concluir[k] = concluir_reenvio[k] = 0;
+        int antes = cliente.num;
+        saida_drenar(&s);
+
+        snprintf(payload, sizeof(payload), "%d", 100 - passo % 50);
+        publicar(&s, SAIDA_TELEMETRIA, DISTANCE, payload);
+        if (passo % 7 == 0) {
+            uint32_t adiadas = s.adiadas;
+            publicar(&s, SAIDA_CONTROLE, GATE_STATE, "Open");
+            controle_adiado += s.adiadas != adiadas;
+        }
+        for (int i = 0; i < 2 && proximo_registro < REGISTROS; i++) {
+            snprintf(payload, sizeof(payload), "/distance,%d,50", proximo_registro);
+            if (!saida_tentar(&s, SAIDA_REENVIO, BACKLOG, payload, strlen(payload), false)) break;
+            proximo_registro++;
+        }
+
+        for (int i = antes; i < cliente.num; i++) {
+            saida_classe_t classe = cliente.enviadas[i].classe;
+            int fim = (passo + (QOS[classe] ? PUBACK : 1)) % DURACAO;
+            concluir[fim]++;
+            if (classe == SAIDA_REENVIO) concluir_reenvio[fim]++;
+        }
+        if (s.pendentes[SAIDA_REENVIO] > janela_max) janela_max = s.pendentes[SAIDA_REENVIO];
+        if (cliente.num > ENVIADAS_MAX - 16) cliente.num = antes = 0; // Só o fim interessa
+    }
+    int reenviados = 0, fora_de_ordem = 0;
+    for (int i = 0; i < cliente.num; i++) {
+        if (cliente.enviadas[i].classe != SAIDA_REENVIO) continue;
+        int n = atoi(cliente.enviadas[i].payload + strlen("/distance,"));
+        fora_de_ordem += n < reenviados;
+        reenviados = n + 1;
+    }
+    printf("reenvio: %d registros, janela máxima %d, comandos adiados %d, descartes %u\n", proximo_registro,
+           janela_max, controle_adiado, (unsigned)s.descartadas[SAIDA_REENVIO]);
+    VERIFICA(proximo_registro == REGISTROS && reenviados == REGISTROS && fora_de_ordem == 0);
+    VERIFICA(janela_max <= JANELA[SAIDA_REENVIO]);
+    VERIFICA(controle_adiado == 0);
+    VERIFICA(s.descartadas[SAIDA_REENVIO] == 0 && s.erros == 0);
+
+    return teste_fim();
+}
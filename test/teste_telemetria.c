@@ -0,0 +1,126 @@
+// Publicação por exceção (lib/telemetria.c): banda morta, intervalo mínimo, heartbeat e
+// transições forçadas; depois uma hora simulada contra a grade fixa antiga (distância a cada
+// 2 s se mudou, status a cada 800 ms).
+
+#include "teste.h"
+#include "telemetria.h"
+
+// Mesmas políticas do firmware
+#define DIST_BANDA_MORTA_CM 2
+#define DIST_INTERVALO_MIN_MS 250
+#define DIST_HEARTBEAT_MS 30000
+#define STATUS_HEARTBEAT_MS 60000
+#define LIMIAR_PRESENCA_CM 30
+
+static const telemetria_politica_t POLITICA_DISTANCIA = {
+    .banda_morta = DIST_BANDA_MORTA_CM,
+    .intervalo_min_ms = DIST_INTERVALO_MIN_MS,
+    .intervalo_max_ms = DIST_HEARTBEAT_MS,
+};
+static const telemetria_politica_t POLITICA_STATUS = {
+    .banda_morta = 0,
+    .intervalo_min_ms = 0,
+    .intervalo_max_ms = STATUS_HEARTBEAT_MS,
+};
+
+#define SIM_DURACAO_MS (3600u * 1000u)
+#define SIM_PERIODO_MS 60
+#define SIM_CICLO_MS (300u * 1000u) // Uma aproximação a cada 5 minutos
+
+static uint32_t semente = 99;
+
+// Cena a 200 cm; a cada ciclo alguém chega a 20 cm a 100 cm/s, fica 5 s e volta. Ruído de ±1 cm.
+static int32_t distancia_simulada(uint32_t t) {
+    float s = (t % SIM_CICLO_MS) / 1000.0f;
+    float real = s < 1.8f ? 200.0f - s * 100.0f : s < 6.8f ? 20.0f : s < 8.6f ? 20.0f + (s - 6.8f) * 100.0f : 200.0f;
+    semente = semente * 1664525u + 1013904223u;
+    return (int32_t)(real + 0.5f) + (int32_t)((semente >> 8) % 3) - 1;
+}
+
+typedef struct {
+    telemetria_t distancia, status;
+    int32_t valor;
+    bool presenca;
+    uint32_t proximo_ms;        // Instante do worker agendado (UINT32_MAX = nenhum)
+    uint32_t mensagens, transicoes, transicoes_atrasadas;
+} simulacao_t;
+
+// Mesmo caminho de publicar_telemetria no firmware
+static void avaliar(simulacao_t *s, uint32_t agora) {
+    if (telemetria_avaliar(&s->status, s->presenca, agora)) s->mensagens++;
+    uint32_t espera = telemetria_espera_ms(&s->status, s->presenca, agora);
+    if (telemetria_avaliar(&s->distancia, s->valor, agora)) s->mensagens++;
+    uint32_t e = telemetria_espera_ms(&s->distancia, s->valor, agora);
+    if (e < espera) espera = e;
+    s->proximo_ms = espera == UINT32_MAX ? UINT32_MAX : agora + espera;
+}
+
+int main(void) {
+    // Banda morta e intervalo mínimo
+    telemetria_t t;
+    telemetria_init(&t, &POLITICA_DISTANCIA);
+    VERIFICA(telemetria_avaliar(&t, 100, 0));           // Primeira publicação
+    VERIFICA(!telemetria_avaliar(&t, 102, 1000));       // Dentro da banda
+    VERIFICA(telemetria_avaliar(&t, 110, 1100));        // Fora da banda, depois do intervalo mínimo
+    VERIFICA(t.publicado == 110 && t.publicado_ms == 1100);
+    VERIFICA(!telemetria_avaliar(&t, 120, 1200));       // Segurado pelo intervalo mínimo
+    VERIFICA(t.suprimidas == 1);
+    VERIFICA(telemetria_espera_ms(&t, 120, 1200) == 150);
+    VERIFICA(telemetria_avaliar(&t, 120, 1350));
+    // Heartbeat sem variação
+    VERIFICA(telemetria_espera_ms(&t, 120, 1350) == DIST_HEARTBEAT_MS);
+    VERIFICA(!telemetria_avaliar(&t, 121, 1350 + DIST_HEARTBEAT_MS - 1));
+    VERIFICA(telemetria_avaliar(&t, 121, 1350 + DIST_HEARTBEAT_MS));
+    // Forçado: publica na próxima avaliação mesmo dentro da banda e do intervalo mínimo
+    telemetria_forcar(&t);
+    VERIFICA(telemetria_espera_ms(&t, 121, 1350 + DIST_HEARTBEAT_MS + 1) == 0);
+    VERIFICA(telemetria_avaliar(&t, 121, 1350 + DIST_HEARTBEAT_MS + 1));
+    VERIFICA(!t.imediato);
+
+    // Uma hora de amostras a cada 60 ms
+    simulacao_t s = { .proximo_ms = UINT32_MAX };
+    telemetria_init(&s.distancia, &POLITICA_DISTANCIA);
+    telemetria_init(&s.status, &POLITICA_STATUS);
+    uint32_t antigas = 0, parado_antes = 0;
+    int32_t antigo_publicado = -1, valor = 0;
+    for (uint32_t agora = 0; agora < SIM_DURACAO_MS; agora++) {
+        bool amostra = agora % SIM_PERIODO_MS == 0;
+        if (amostra) {
+            valor = distancia_simulada(agora);
+            bool presenca = valor <= LIMIAR_PRESENCA_CM;
+            bool mudou = valor != s.valor;
+            if (presenca != s.presenca) {
+                // Transição de estado: força status e distância
+                s.presenca = presenca;
+                s.transicoes++;
+                telemetria_forcar(&s.status);
+                telemetria_forcar(&s.distancia);
+            }
+            s.valor = valor;
+            if (mudou || s.status.imediato) avaliar(&s, agora); // O core1 só envia distâncias novas
+            if (s.status.imediato || s.status.publicado != s.presenca) s.transicoes_atrasadas++;
+        }
+        if (agora == s.proximo_ms) avaliar(&s, agora); // Worker de heartbeat/intervalo mínimo
+
+        // Grade antiga
+        if (agora % 2000 == 0 && valor != antigo_publicado) {
+            antigo_publicado = valor;
+            antigas++;
+        }
+        if (agora % 800 == 0) antigas++;
+
+        // Cena parada: só heartbeats entre 10 s e 290 s de cada ciclo
+        if (agora % SIM_CICLO_MS == 10000) parado_antes = s.mensagens;
+        if (agora % SIM_CICLO_MS == 290000) {
+            uint32_t parado = s.mensagens - parado_antes;
+            VERIFICA(parado <= 280 / 30 + 280 / 60 + 2);
+        }
+    }
+    printf("uma hora: %u mensagens na grade fixa, %u por exceção; %u transições, %u atrasadas\n",
+           (unsigned)antigas, (unsigned)s.mensagens, (unsigned)s.transicoes, (unsigned)s.transicoes_atrasadas);
+    VERIFICA(s.transicoes == 2 * SIM_DURACAO_MS / SIM_CICLO_MS);
+    VERIFICA(s.transicoes_atrasadas == 0);
+    VERIFICA(s.mensagens * 5 < antigas);
+
+    return teste_fim();
+}
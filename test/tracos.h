@@ -0,0 +1,88 @@
+#ifndef TRACOS_H
+#define TRACOS_H
+
+// Traços de distância do sensor: sintéticos e reproduzíveis (semente fixa), no lugar das
+// gravações, ou lidos de um CSV "instante_ms,real_cm,medida_cm" gravado na placa.
+// medida_cm = 0 é uma medição sem eco.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define TRACO_PERIODO_MS 60
+
+typedef struct {
+    uint32_t instante_ms;
+    float real_cm;
+    uint32_t medida_cm;
+} traco_amostra_t;
+
+typedef enum {
+    TRACO_PARADO,       // Cena parada a 100 cm: ruído de 1 cm, picos e ecos perdidos
+    TRACO_APROXIMACAO,  // Pessoa vindo de 300 cm até 20 cm a 100 cm/s, parando e voltando
+    TRACO_PERDA,        // Aproximação até perto demais: os ecos somem antes do limiar
+    NUM_TRACOS
+} traco_tipo_t;
+
+static const char *const NOMES_TRACOS[NUM_TRACOS] = { "parado", "aproximacao", "perda" };
+
+static inline uint32_t traco_sorteio(uint32_t *semente) {
+    *semente = *semente * 1664525u + 1013904223u;
+    return *semente >> 8;
+}
+
+static inline size_t traco_gerar(traco_tipo_t tipo, traco_amostra_t *a, size_t max) {
+    uint32_t semente = 12345 + tipo;
+    size_t n = 0;
+    for (; n < max; n++) {
+        float t = n * TRACO_PERIODO_MS / 1000.0f;
+        float real;
+        switch (tipo) {
+            case TRACO_PARADO:
+            real = 100.0f;
+            break;
+            case TRACO_APROXIMACAO:
+            // 3 s a 300 cm, 2,8 s se aproximando, 2 s parada a 20 cm, volta e repete
+            t = fmodf(t, 12.0f);
+            real = t < 3.0f ? 300.0f : t < 5.8f ? 300.0f - (t - 3.0f) * 100.0f :
+                   t < 7.8f ? 20.0f : t < 10.6f ? 20.0f + (t - 7.8f) * 100.0f : 300.0f;
+            break;
+            default:
+            t = fmodf(t, 10.0f);
+            real = t < 3.0f ? 200.0f : t < 4.9f ? 200.0f - (t - 3.0f) * 100.0f : t < 7.0f ? 10.0f : 200.0f;
+            break;
+        }
+        a[n].instante_ms = n * TRACO_PERIODO_MS;
+        a[n].real_cm = real;
+
+        uint32_t r = traco_sorteio(&semente) % 1000;
+        if ((tipo == TRACO_PERDA && real < 15.0f) || r < 10) {
+            a[n].medida_cm = 0;                          // Sem eco
+        } else if (r < 30) {
+            a[n].medida_cm = (uint32_t)real + 20 + traco_sorteio(&semente) % 130; // Pico (eco de outro objeto)
+        } else {
+            int ruido = (int)(traco_sorteio(&semente) % 3) - 1;
+            a[n].medida_cm = (uint32_t)((int)lroundf(real) + (r < 700 ? 0 : ruido));
+        }
+    }
+    return n;
+}
+
+static inline size_t traco_ler_csv(const char *caminho, traco_amostra_t *a, size_t max) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) return 0;
+    size_t n = 0;
+    unsigned long t, m;
+    float real;
+    while (n < max && fscanf(f, "%lu,%f,%lu", &t, &real, &m) == 3) {
+        a[n].instante_ms = t;
+        a[n].real_cm = real;
+        a[n].medida_cm = m;
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+#endif
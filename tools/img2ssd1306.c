@@ -0,0 +1,234 @@
+// Ferramenta de host: converte imagens PBM (P1 ou P4) em bitmaps no formato do SSD1306.
+//
+// Uso: img2ssd1306 [--rle] saida.h nome=imagem.pbm [nome=imagem.pbm ...]
+//
+// Cada imagem é recortada na menor caixa de páginas inteiras (8 linhas) que contém os pixels
+// acesos e gravada coluna a coluna, com as páginas da coluna em sequência: o mesmo layout do
+// ram_buffer com endereçamento vertical. Com --rle os dados são comprimidos quando isso economiza
+// espaço (ver ssd1306_blit em lib/ssd1306.c).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LARGURA_MAX 128
+#define ALTURA_MAX 64
+#define PAGINAS_MAX (ALTURA_MAX / 8)
+
+typedef struct {
+    int largura, altura;
+    uint8_t pixel[ALTURA_MAX][LARGURA_MAX];
+} imagem_t;
+
+// Pula espaços e comentários do cabeçalho PBM
+static int ler_token(FILE *f) {
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        if (c == '#') {
+            while ((c = fgetc(f)) != EOF && c != '\n') {}
+        } else if (!isspace(c)) {
+            break;
+        }
+    }
+    return c;
+}
+
+static bool ler_inteiro(FILE *f, int *valor) {
+    int c = ler_token(f);
+    if (!isdigit(c)) return false;
+    *valor = 0;
+    while (isdigit(c)) {
+        *valor = *valor * 10 + (c - '0');
+        c = fgetc(f);
+    }
+    return true;
+}
+
+static bool ler_pbm(const char *caminho, imagem_t *img) {
+    FILE *f = fopen(caminho, "rb");
+    if (!f) {
+        fprintf(stderr, "img2ssd1306: não foi possível abrir %s\n", caminho);
+        return false;
+    }
+
+    bool ok = false;
+    int formato = 0;
+    if (ler_token(f) == 'P') formato = fgetc(f);
+    if ((formato != '1' && formato != '4') || !ler_inteiro(f, &img->largura) || !ler_inteiro(f, &img->altura)) {
+        fprintf(stderr, "img2ssd1306: %s não é um PBM válido\n", caminho);
+        goto fim;
+    }
+    if (img->largura <= 0 || img->largura > LARGURA_MAX || img->altura <= 0 || img->altura > ALTURA_MAX) {
+        fprintf(stderr, "img2ssd1306: %s maior que %dx%d\n", caminho, LARGURA_MAX, ALTURA_MAX);
+        goto fim;
+    }
+
+    memset(img->pixel, 0, sizeof(img->pixel));
+    for (int y = 0; y < img->altura; y++) {
+        if (formato == '1') {
+            for (int x = 0; x < img->largura; x++) {
+                int c = ler_token(f);
+                if (c != '0' && c != '1') {
+                    fprintf(stderr, "img2ssd1306: %s termina antes da hora\n", caminho);
+                    goto fim;
+                }
+                img->pixel[y][x] = c == '1';
+            }
+        } else {
+            // P4: linhas empacotadas em bytes, bit mais significativo primeiro
+            uint8_t linha[LARGURA_MAX / 8];
+            size_t bytes = (img->largura + 7) / 8;
+            if (fread(linha, 1, bytes, f) != bytes) {
+                fprintf(stderr, "img2ssd1306: %s termina antes da hora\n", caminho);
+                goto fim;
+            }
+            for (int x = 0; x < img->largura; x++) {
+                img->pixel[y][x] = (linha[x / 8] >> (7 - x % 8)) & 1;
+            }
+        }
+    }
+    ok = true;
+
+fim:
+    fclose(f);
+    return ok;
+}
+
+// Controle < 0x80: (c + 1) bytes literais a seguir. Controle >= 0x80: o próximo byte repetido (c - 0x7E) vezes.
+static size_t comprimir_rle(const uint8_t *dados, size_t n, uint8_t *saida) {
+    size_t i = 0, o = 0;
+    while (i < n) {
+        size_t repeticoes = 1;
+        while (i + repeticoes < n && dados[i + repeticoes] == dados[i] && repeticoes < 129) repeticoes++;
+        if (repeticoes >= 2) {
+            saida[o++] = (uint8_t)(0x7E + repeticoes);
+            saida[o++] = dados[i];
+            i += repeticoes;
+            continue;
+        }
+
+        // Literais até a próxima sequência de pelo menos 3 bytes iguais
+        size_t inicio = i;
+        while (i < n && i - inicio < 128) {
+            if (i + 2 < n && dados[i] == dados[i + 1] && dados[i] == dados[i + 2]) break;
+            i++;
+        }
+        saida[o++] = (uint8_t)(i - inicio - 1);
+        memcpy(&saida[o], &dados[inicio], i - inicio);
+        o += i - inicio;
+    }
+    return o;
+}
+
+static bool converter(FILE *saida, const char *nome, const char *caminho, bool usar_rle) {
+    imagem_t img;
+    if (!ler_pbm(caminho, &img)) return false;
+
+    // Caixa dos pixels acesos, em colunas e páginas inteiras
+    int x0 = LARGURA_MAX, x1 = -1, y0 = ALTURA_MAX, y1 = -1;
+    for (int y = 0; y < img.altura; y++) {
+        for (int x = 0; x < img.largura; x++) {
+            if (!img.pixel[y][x]) continue;
+            if (x < x0) x0 = x;
+            if (x > x1) x1 = x;
+            if (y < y0) y0 = y;
+            if (y > y1) y1 = y;
+        }
+    }
+    if (x1 < 0) x0 = x1 = y0 = y1 = 0; // Imagem vazia: um byte apagado
+
+    int pagina = y0 / 8, paginas = y1 / 8 - pagina + 1, largura = x1 - x0 + 1;
+    size_t n = (size_t)largura * paginas;
+    uint8_t bruto[LARGURA_MAX * PAGINAS_MAX];
+    for (int c = 0; c < largura; c++) {
+        for (int p = 0; p < paginas; p++) {
+            uint8_t byte = 0;
+            for (int b = 0; b < 8; b++) {
+                int y = (pagina + p) * 8 + b;
+                if (y < img.altura && img.pixel[y][x0 + c]) byte |= 1 << b;
+            }
+            bruto[c * paginas + p] = byte;
+        }
+    }
+
+    uint8_t comprimido[LARGURA_MAX * PAGINAS_MAX * 2];
+    size_t n_rle = usar_rle ? comprimir_rle(bruto, n, comprimido) : n;
+    bool rle = usar_rle && n_rle < n;
+    const uint8_t *dados = rle ? comprimido : bruto;
+    size_t tamanho = rle ? n_rle : n;
+
+    fprintf(saida, "// %s: %dx%d a partir de (%d, página %d); %zu bytes%s (ARGB original: %d bytes)\n",
+            caminho, largura, paginas * 8, x0, pagina, tamanho, rle ? " com RLE" : "",
+            img.largura * img.altura * 4);
+    // Nome do vetor de dados em minúsculas (o bitmap costuma ter nome de constante)
+    char nome_dados[64];
+    size_t k = 0;
+    for (; nome[k] && k < sizeof(nome_dados) - 1; k++) nome_dados[k] = (char)tolower((unsigned char)nome[k]);
+    nome_dados[k] = '\0';
+
+    fprintf(saida, "static const uint8_t %s_dados[%zu] = {", nome_dados, tamanho);
+    for (size_t i = 0; i < tamanho; i++) {
+        fprintf(saida, "%s0x%02X,", (i % 16) ? " " : "\n    ", dados[i]);
+    }
+    fprintf(saida, "\n};\n");
+    fprintf(saida, "static const ssd1306_bitmap_t %s = {\n", nome);
+    fprintf(saida, "    .x = %d, .pagina = %d, .largura = %d, .paginas = %d,\n", x0, pagina, largura, paginas);
+    fprintf(saida, "    .rle = %s, .tamanho = %zu, .dados = %s_dados,\n};\n\n", rle ? "true" : "false", tamanho, nome_dados);
+
+    fprintf(stderr, "img2ssd1306: %s -> %s (%zu bytes)\n", caminho, nome, tamanho);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int arg = 1;
+    bool usar_rle = false;
+    if (arg < argc && strcmp(argv[arg], "--rle") == 0) {
+        usar_rle = true;
+        arg++;
+    }
+    if (argc - arg < 2) {
+        fprintf(stderr, "uso: img2ssd1306 [--rle] saida.h nome=imagem.pbm [nome=imagem.pbm ...]\n");
+        return 1;
+    }
+
+    const char *caminho_saida = argv[arg++];
+    FILE *saida = fopen(caminho_saida, "w");
+    if (!saida) {
+        fprintf(stderr, "img2ssd1306: não foi possível criar %s\n", caminho_saida);
+        return 1;
+    }
+
+    // Guarda de inclusão a partir do nome do arquivo (icones.h -> ICONES_H)
+    const char *base = strrchr(caminho_saida, '/');
+    base = base ? base + 1 : caminho_saida;
+    char guarda[64];
+    size_t k = 0;
+    for (; base[k] && k < sizeof(guarda) - 1; k++) {
+        guarda[k] = isalnum((unsigned char)base[k]) ? (char)toupper((unsigned char)base[k]) : '_';
+    }
+    guarda[k] = '\0';
+
+    fprintf(saida, "// Gerado por tools/img2ssd1306.c - não edite\n");
+    fprintf(saida, "#ifndef %s\n#define %s\n\n#include \"lib/ssd1306.h\"\n\n", guarda, guarda);
+    bool ok = true;
+    for (; arg < argc && ok; arg++) {
+        char nome[64];
+        const char *igual = strchr(argv[arg], '=');
+        if (!igual || igual == argv[arg] || (size_t)(igual - argv[arg]) >= sizeof(nome)) {
+            fprintf(stderr, "img2ssd1306: argumento inválido %s\n", argv[arg]);
+            ok = false;
+            break;
+        }
+        memcpy(nome, argv[arg], igual - argv[arg]);
+        nome[igual - argv[arg]] = '\0';
+        ok = converter(saida, nome, igual + 1, usar_rle);
+    }
+    fprintf(saida, "#endif\n");
+    fclose(saida);
+
+    if (!ok) remove(caminho_saida);
+    return ok ? 0 : 1;
+}